@@ -1,8 +1,16 @@
 #pragma once
 #include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
 
 // Forward declare to avoid circular includes
 struct DataPair;
+class PortBase;
+struct ThreadPlacement;
+struct PlacementReport;
+class DeadlineMonitor;
+class LiveStatsPublisher;
 
 // Thin abstract interface for all pipeline blocks.
 class Block {
@@ -18,6 +26,44 @@ public:
     virtual void printStats() const = 0;
     virtual std::string name() const = 0;
 
+    // Graph interface: typed ports Pipeline::connect can wire (default = none)
+    virtual std::vector<PortBase*> inputPorts() { return {}; }
+    virtual std::vector<PortBase*> outputPorts() { return {}; }
+
+    // Worker-thread placement (affinity / RT priority); blocks without a thread ignore it.
+    // setPlacement must be called before start(); the report is valid once the
+    // worker has applied it (returns false until then).
+    virtual void setPlacement(const ThreadPlacement& placement) { (void)placement; }
+    virtual bool placementReport(PlacementReport& out) const { (void)out; return false; }
+
+    // Pooled execution (Pipeline::start with a WorkStealingPool): instead of owning a
+    // thread, a block that supportsStep() is run as a task. startSteps()/stopSteps()
+    // replace start()/stop(); step() processes at most maxItems without blocking and
+    // is never called concurrently for one block, so per-pipeline order is kept.
+    enum class StepResult {
+        Progress, // did some work, run again soon
+        Idle,     // nothing to do right now (input empty, output full, not yet due)
+        Done      // end of stream; step() is not called again
+    };
+    virtual bool supportsStep() const { return false; }
+    virtual void startSteps() {}
+    virtual StepResult step(size_t maxItems) { (void)maxItems; return StepResult::Done; }
+    virtual void requestStop() {}   // ask an endless source to return Done
+    // After an Idle step(): ns until the block has work of its own accord (e.g. a paced source
+    // holding its next pair), or 0 when it waits on a neighbour (input empty, output full).
+    virtual uint64_t idleWaitNs() const { return 0; }
+    virtual void stopSteps() {}     // after the last step()
+
+    // Deadline accounting (DeadlineWatchdog polls these). shedOptionalWork(true) asks the
+    // block to skip work that is not needed for its outputs (e.g. metrics recording)
+    // until called again with false; it may be called from any thread.
+    virtual std::vector<DeadlineMonitor*> deadlineMonitors() { return {}; }
+    virtual bool hasOptionalWork() const { return false; }
+    virtual void shedOptionalWork(bool shed) { (void)shed; }
+
+    // Live statistics (StatsReporter reads consistent snapshots while the block runs)
+    virtual LiveStatsPublisher* liveStats() { return nullptr; }
+
     // Output interface (default = no-op for blocks with no downstream output)
     virtual void emit(const DataPair& pair) {
         // Default: do nothing (inherited by blocks like FilterBlock that don't emit)
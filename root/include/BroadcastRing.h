@@ -0,0 +1,163 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+#include "Util.h"
+
+// Single-writer multi-reader broadcast ring (Disruptor-style).
+// The producer writes each item once; every reader keeps its own cursor and
+// copies the slot out, so N readers cost one write instead of N queue copies.
+// - Critical readers gate the producer: it never overwrites a slot they have not read.
+// - Non-critical readers are detached (and stop receiving) once the producer
+//   would have to overwrite a slot they still need, instead of stalling it.
+// Readers must be added before the producer starts. T should be trivially copyable:
+// non-critical reads validate after the copy, seqlock style, and discard torn slots.
+template <typename T>
+class BroadcastRing {
+public:
+    explicit BroadcastRing(size_t capacity = 16384) {
+        size_t cap = 1;
+        while (cap < capacity) cap <<= 1;
+        if (cap < 2) cap = 2;
+        buf.resize(cap);
+        mask = cap - 1;
+    }
+
+    BroadcastRing(const BroadcastRing&) = delete;
+    BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+    // Returns the reader id used by try_pop / exhausted / lag.
+    size_t addReader(bool critical = true) {
+        cursors.emplace_back(new Cursor());
+        cursors.back()->critical = critical;
+        cursors.back()->next.store(published.load(std::memory_order_acquire), std::memory_order_relaxed);
+        return cursors.size() - 1;
+    }
+
+    // ---------------- producer ----------------
+
+    bool try_push(const T& value) {
+        if (closed.load(std::memory_order_acquire)) return false;
+        uint64_t seq = published.load(std::memory_order_relaxed);
+        if (seq - gate >= buf.size()) {
+            gate = computeGate(seq);
+            if (seq - gate >= buf.size()) return false;
+        }
+        buf[seq & mask] = value;
+        published.store(seq + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Spins until the slowest critical reader frees a slot (or shutdown).
+    void push(const T& value) {
+        while (!try_push(value)) {
+            if (closed.load(std::memory_order_acquire)) return;
+            util::cpu_relax();
+        }
+    }
+
+    void shutdown() {
+        closed.store(true, std::memory_order_release);
+    }
+
+    bool isShutdown() const noexcept {
+        return closed.load(std::memory_order_acquire);
+    }
+
+    // ---------------- readers ----------------
+
+    bool try_pop(size_t reader, T& out) {
+        Cursor& c = *cursors[reader];
+        if (c.detached.load(std::memory_order_acquire)) return false;
+        uint64_t seq = c.next.load(std::memory_order_relaxed);
+        if (seq == published.load(std::memory_order_acquire)) return false;
+        out = buf[seq & mask];
+        if (!c.critical) {
+            // The producer detaches us before it overwrites our slot; if that
+            // happened during the copy, the copy may be torn.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (c.detached.load(std::memory_order_relaxed)) return false;
+        }
+        c.next.store(seq + 1, std::memory_order_release);
+        return true;
+    }
+
+    // True once the reader has been detached, or the ring is shut down and fully read.
+    bool exhausted(size_t reader) const {
+        const Cursor& c = *cursors[reader];
+        if (c.detached.load(std::memory_order_acquire)) return true;
+        return isShutdown() &&
+               c.next.load(std::memory_order_relaxed) == published.load(std::memory_order_acquire);
+    }
+
+    // Reader leaves: it no longer gates the producer.
+    void detach(size_t reader) {
+        cursors[reader]->detached.store(true, std::memory_order_release);
+    }
+
+    bool isDetached(size_t reader) const {
+        return cursors[reader]->detached.load(std::memory_order_acquire);
+    }
+
+    // Items published but not yet read by this reader.
+    size_t lag(size_t reader) const {
+        const Cursor& c = *cursors[reader];
+        if (c.detached.load(std::memory_order_acquire)) return 0;
+        return static_cast<size_t>(published.load(std::memory_order_acquire) -
+                                   c.next.load(std::memory_order_acquire));
+    }
+
+    // Lag of the slowest attached reader.
+    size_t maxLag() const {
+        size_t m = 0;
+        for (size_t i = 0; i < cursors.size(); ++i) m = std::max(m, lag(i));
+        return m;
+    }
+
+    size_t readerCount() const { return cursors.size(); }
+    uint64_t detachedCount() const { return detachCount.load(std::memory_order_relaxed); }
+    size_t capacity() const { return buf.size(); }
+    const T* data() const { return buf.data(); }
+
+private:
+    struct alignas(64) Cursor {
+        std::atomic<uint64_t> next{0};
+        std::atomic<bool> detached{false};
+        bool critical = true;
+    };
+
+    // Slowest attached cursor; detaches non-critical readers a full ring behind.
+    uint64_t computeGate(uint64_t seq) {
+        uint64_t minNext = seq;
+        bool detachedAny = false;
+        for (auto& cp : cursors) {
+            Cursor& c = *cp;
+            if (c.detached.load(std::memory_order_acquire)) continue;
+            uint64_t n = c.next.load(std::memory_order_acquire);
+            if (seq - n >= buf.size() && !c.critical) {
+                c.detached.store(true, std::memory_order_relaxed);
+                detachCount.fetch_add(1, std::memory_order_relaxed);
+                detachedAny = true;
+                continue;
+            }
+            minNext = std::min(minNext, n);
+        }
+        // Pairs with the acquire fence in try_pop: the detach is visible before the overwrite.
+        if (detachedAny) std::atomic_thread_fence(std::memory_order_release);
+        return minNext;
+    }
+
+    std::vector<T> buf;
+    size_t mask;
+
+    alignas(64) std::atomic<uint64_t> published{0};
+    uint64_t gate = 0;                 // producer-local cache of the slowest cursor
+    std::atomic<bool> closed{false};
+    std::atomic<uint64_t> detachCount{0};
+
+    std::vector<std::unique_ptr<Cursor>> cursors;
+};
@@ -1,7 +1,13 @@
 #pragma once
 #include <string>
 #include <cstdint>
+#include <map>
+#include <vector>
 #include "DataGenerator.h" // for InputMode
+#include "ThreadPlacement.h"
+#include "Simulation.h"
+#include "StatsReporter.h"
+#include "metrics/MetricsSampler.h"
 
 // Configuration enums
 enum class FilterType {
@@ -9,12 +15,37 @@ enum class FilterType {
     FILE
 };
 
+// Execution engine: Block graph (queues between blocks) or compile-time StaticPipeline
+enum class Engine {
+    DYNAMIC,
+    STATIC,        // all stages inlined on one thread
+    STATIC_SPLIT   // source | filter+sink, one ThreadBoundary queue
+};
+
+// Dynamic engine threading: one thread per block, or blocks as tasks on a shared pool
+enum class ExecutionMode {
+    THREADS,
+    POOL
+};
+
+// Per-pair metrics file (--stats): CSV rows or fixed-size records in a mapped file
+enum class MetricsFormat {
+    CSV,
+    BINARY   // see metrics/BinaryMetricsLog.h
+};
+
 // Main configuration structure
 struct Config {
     // Data source configuration
     InputMode mode = InputMode::RANDOM;
     std::string csvFile = "test.csv";
+    std::string rawFile = "";   // RAW/PGM capture path
+    std::string replayFile = "";  // REPLAY capture log path
+    ReplayTiming replayTiming = ReplayTiming::ORIGINAL;
+    std::string captureFile = ""; // record the generated stream (empty = off)
+    InputOptions input;           // file byte source (read-ahead depth/backend)
     int columns = 1024;
+    bool columnsSet = false;      // --columns given explicitly
     uint64_t T_ns = 1000;
 
     // Filter configuration
@@ -23,11 +54,77 @@ struct Config {
     std::string filterFile = "";
 
     // Pipeline configuration
+    Engine engine = Engine::DYNAMIC;
     bool enableFilter = true;
+    size_t queueCapacity = 128;   // per-edge queue size (pairs)
+    bool broadcast = false;       // generator fans out through one BroadcastRing
+    OverloadPolicy overload = OverloadPolicy::BLOCK; // generator queue-full behaviour
+    ExecutionMode execution = ExecutionMode::THREADS;
+    unsigned poolThreads = 0;     // POOL workers, 0 = all hardware threads
+    size_t batchPairs = 0;        // POOL items per step, 0 = one line (columns / 2)
+
+    // Extra independent pipelines, one --pipeline="k=v;..." spec each (see MultiPipeline.h)
+    std::vector<std::string> pipelineSpecs;
+
+    // Per-block worker placement, keyed "generator" / "filter" / "pool" (--place)
+    std::map<std::string, ThreadPlacement> placements;
+
+    // Saturation run (--saturate): unpaced (T_ns = 0), headless, stops after
+    // saturatePixels pixels or saturateMs (random input without either: 1000 ms)
+    bool saturate = false;
+    uint64_t saturatePixels = 0;
+    uint64_t saturateMs = 0;
+
+    // Virtual-time simulation of the dynamic pipeline (--simulate), see Simulation.h
+    bool simulate = false;
+    SimulationOptions sim;
 
     // Metrics and profiling
     bool stats = false;
+    // Block profilers: log-linear histogram precision (sub-bucket bits, 5 = ~3%), and
+    // whether to also keep every raw sample for exact percentiles (memory grows with the run)
+    unsigned profilePrecisionBits = 5;
+    bool profileRawSamples = false;
+    // Per-thread hardware counters (cycles, instructions, cache / branch misses) for the
+    // generator and filter workers; threads executor only, see profiler/PerfCounters.h
+    bool perfCounters = false;
+    MetricsFormat metricsFormat = MetricsFormat::CSV;
+    uint64_t metricsRecords = 16 * 1024 * 1024; // BINARY capacity (512 MiB, sparse until written)
+    SamplingPolicy metricsSampling;             // which pairs are recorded (--metrics-sample)
+
+    // Deadline budgets: T_ns per pair (generator, filter) and outputBudget_ns between a
+    // pair's two outputs. The watchdog polls the miss rate every watchdogMs (0 = off) and
+    // alerts while it exceeds deadlineAlertRate; with shedOnAlert (--shed) a block whose own
+    // budgets alert also stops recording metrics until they recover.
+    uint64_t outputBudget_ns = 100;
+    uint64_t watchdogMs = 100;
+    double deadlineAlertRate = 0.01;
+    bool shedOnAlert = false;
+
+    // Live windowed statistics every liveStatsMs while running (0 = off), see StatsReporter.h
+    uint64_t liveStatsMs = 0;
+    ReportFormat liveFormat = ReportFormat::TEXT;
+
+    // Timeline trace (Chrome trace-event JSON) of the run; needs a CYNLR_ENABLE_TRACING build.
+    // traceEvents bounds each thread's buffer (40 bytes per event); later events are dropped.
+    std::string traceFile;
+    uint64_t traceEvents = 1 << 20;
+
+    // Per-function timers and counters (profiler/ModuleProfiler.h) written here at exit
+    std::string moduleProfileFile;
     
+    // Offline conversion (--convert): CSV -> binary PGM, then exit
+    std::string convertInput = "";
+    std::string convertOutput = "";
+    unsigned convertThreads = 0;  // 0 = all hardware threads
+
+    // Binary metrics log tools, then exit: --metrics-convert (to CSV, --out),
+    // --metrics-summary, --metrics-tail (follow a log being written every tailMs)
+    std::string metricsConvert = "";
+    std::string metricsSummary = "";
+    std::string metricsTail = "";
+    uint64_t tailMs = 1000;
+
     // Output control
     bool quiet = false;  // Suppress all non-error output
 };
\ No newline at end of file
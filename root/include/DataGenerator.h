@@ -6,36 +6,82 @@
 #include <string>
 #include <functional>
 #include <cstdint>
+#include <random>
 
 #include "ThreadSafeQueue.h"
 #include "Block.h"
+#include "Port.h"
+#include "ThreadPlacement.h"
 #include "profiler/BlockProfiler.h"
+#include "profiler/LiveStats.h"
+#include "profiler/PerfCounters.h"
+#include "profiler/Utilization.h"
+#include "DeadlineMonitor.h"
+#include "stream/CaptureLog.h"
+#include "stream/CsvStreamer.h"
+#include "stream/InputSource.h"
+#include "stream/RawStreamer.h"
 
 using NowFn   = uint64_t (*)();
 using SleepFn = void (*)(uint64_t);
 
 enum class InputMode {
     RANDOM,
-    CSV
+    CSV,
+    RAW,   // headerless 8-bit binary capture (columns from --columns)
+    PGM,   // binary PGM/PNM capture (columns from header)
+    REPLAY // CaptureLog written by --capture (columns from header)
 };
 
+// REPLAY pacing: reproduce the recorded inter-arrival gaps, or run unpaced.
+enum class ReplayTiming {
+    ORIGINAL,
+    FAST
+};
+
+
+// What the generator does when a consumer's queue is full. A camera cannot be
+// back-pressured, so the drop policies never stall the source.
+enum class OverloadPolicy {
+    BLOCK,        // wait for room (spin, then blocking push)
+    DROP_NEWEST,  // discard the pair that does not fit
+    DROP_OLDEST,  // evict the oldest queued pair to make room
+    DROP_LINE     // discard the rest of the current line; resume at the next line start
+};
 
+// "block" | "drop-newest" | "drop-oldest" | "drop-line"
+bool parseOverloadPolicy(const std::string& name, OverloadPolicy& out);
+const char* overloadPolicyName(OverloadPolicy policy);
+
+// Inclusive seq range of dropped pairs.
+struct DropRange {
+    uint64_t first;
+    uint64_t last;
+};
+
+// The two 32-bit stage stamps (see profiler/StageLatency.h) sit in what was padding,
+// so a pair is still 32 bytes on the queue.
 struct DataPair {
     uint8_t a = 0;
     uint8_t b = 0;
+    uint32_t pace_late_ns = 0;   // scheduled release -> gen_ts_ns (sleep overshoot)
     uint64_t gen_ts_ns = 0;
     bool gen_ts_valid = false;
+    uint32_t enq_delta_ns = 0;   // gen_ts_ns -> the push attempt that enqueued it
     uint64_t seq = 0;
 };
+static_assert(sizeof(DataPair) == 32, "DataPair layout: keep the stage stamps in the padding");
 
 
 class DataGenerator : public Block {
 public:
+    // q (optional) is bound to the output port directly; pipelines leave it null
+    // and wire the port through Pipeline::connect instead.
     DataGenerator(ThreadSafeQueue<DataPair>* q,
         int m,
         uint64_t T_ns,
         InputMode mode,
-        const std::string& csvFile = "",
+        const std::string& inputFile = "",
         NowFn nowFn = nullptr,
         SleepFn sleepFn = nullptr,
         size_t spinLimit = 50000);
@@ -47,32 +93,168 @@ public:
     void printStats() const override;
     std::string name() const override { return "DataGenerator"; }
     
-    // Output interface: emit pairs to queue
+    // Output interface: emit pairs to every queue bound to the output port
     void emit(const DataPair& pair) override;
 
+    std::vector<PortBase*> outputPorts() override { return { &out_ }; }
+    OutputPort<DataPair>& output() { return out_; }
+
     // Existing public API (unchanged)
     bool isRunning() const noexcept { return running.load(std::memory_order_acquire); }
 
+    // Per-pair production timing (count = pairs emitted); read after stop().
+    BlockProfiler::Stats profileStats() const { return profiler_.getStats(); }
+    const BlockProfiler& profiler() const { return profiler_; }
+
+    // Histogram precision / raw-sample mode of the production-time profiler; call before start().
+    void setProfiling(unsigned precisionBits, bool rawSamples) { profiler_.configure(precisionBits, rawSamples); }
+
+    // Hardware counters for the producer thread (threads executor only), in printStats per pixel
+    void setPerfCounters(bool on) { perf_.enable(on); }
+
+    // Busy (producing a pair) vs idle (pacing, replay waits, queue-full stalls) time of the worker
+    const UtilizationMeter& utilization() const { return util_; }
+
+    // Record every produced pair (pixels + gen_ts_ns deltas) to a CaptureLog.
+    // Must be called before start(); the file is opened when the worker starts.
+    void setCaptureFile(const std::string& path) { captureFile = path; }
+
+    // Pacing used in REPLAY mode (T_ns is ignored there).
+    void setReplayTiming(ReplayTiming timing) { replayTiming = timing; }
+
+    // Queue-full behaviour (default BLOCK), before start(). Broadcast rings treat every drop
+    // policy as DROP_NEWEST; their own lag policy detaches slow readers.
+    void setOverloadPolicy(OverloadPolicy policy) {
+        overload = policy;
+        if (policy == OverloadPolicy::DROP_OLDEST) out_.enableEviction();
+    }
+
+    // Drop accounting; read after stop(). Ranges are merged when contiguous.
+    uint64_t droppedPairs() const { return droppedCount; }
+    const std::vector<DropRange>& dropRanges() const { return dropRangeLog; }
+
+    // End the stream as at EOF (output shut down, also for RANDOM input) once this many
+    // pairs were produced or this long after start; 0 = no limit. Call before start().
+    void setStopAfter(uint64_t pairs, uint64_t duration_ns) {
+        pairLimit = pairs;
+        durationLimit_ns = duration_ns;
+    }
+
+    // Time spent waiting for space in a full output (BLOCK policy); read after stop().
+    uint64_t queueFullStallNs() const { return queueFullNs; }
+
+    // Per-pair produce + push time is checked against budget_ns (default T_ns; 0 = off).
+    void setDeadlineBudget(uint64_t budget_ns) { pairDeadline.setBudget(budget_ns); }
+    std::vector<DeadlineMonitor*> deadlineMonitors() override { return { &pairDeadline }; }
+    LiveStatsPublisher* liveStats() override { return &live_; }
+    const DeadlineMonitor& deadline() const { return pairDeadline; }
+
+    // Byte source for CSV/RAW/PGM input (e.g. asynchronous read-ahead).
+    void setInputOptions(const InputOptions& opts) { inputOptions = opts; }
+
+    // Pooled execution: one pair per item, paced by T_ns (or the replay schedule)
+    // without sleeping; a full output holds the pair back until the next step.
+    bool supportsStep() const override { return true; }
+    void startSteps() override;
+    StepResult step(size_t maxItems) override;
+    void requestStop() override;
+    void stopSteps() override;
+
+    // Due time of the pair step() is holding back for pacing (0 = none, or it is only
+    // waiting for queue space).
+    uint64_t pendingDueNs() const { return hasPending && !pendingStamped ? pendingDue : 0; }
+    uint64_t idleWaitNs() const override;
+
+    void setPlacement(const ThreadPlacement& p) override { placement_ = p; }
+    bool placementReport(PlacementReport& out) const override {
+        if (!placed_.load(std::memory_order_acquire)) return false;
+        out = placementReport_;
+        return true;
+    }
+
 private:
     NowFn   nowFn;
     SleepFn sleepFn;
     void run();
     bool pushWithBackpressure(const DataPair& pair, size_t& blocked_push_count);
 
-    ThreadSafeQueue<DataPair>* queue;
+    // Shared by run() and step()
+    bool openInput();
+    bool readPixels(DataPair& pair);          // RANDOM/CSV/RAW/PGM; false at end of input
+    uint64_t replayTarget(uint32_t delta_ns); // absolute due time of a replayed pair, 0 = now
+    void stampPair(DataPair& pair);           // timestamp, seq, capture, occupancy sample
+    void finishInput();                       // close capture, signal EOF downstream
+    bool tryEmitPending();
+    bool offer(ThreadSafeQueue<DataPair>* queue, const DataPair& pair);
+    bool offer(BroadcastRing<DataPair>* ring, const DataPair& pair);
+    void recordDrop(uint64_t seq);
+    bool inDroppedLine(uint64_t seq);
+    bool limitReached();
+    StepResult finishSteps();
+    void recordLive(uint64_t pair_time, uint64_t now);
+    void publishLive(uint64_t now);
+
+    OutputPort<DataPair> out_{"out"};
     std::thread worker;
     std::atomic<bool> running;
 
     int columns;
     uint64_t T_ns;
     InputMode mode;
-    std::string csvFile;
+    std::string inputFile; // CSV or raw capture path (file modes)
     uint64_t seqCounter;
 
     size_t backpressureSpinLimit;
 
+    // Capture / replay
+    std::string captureFile;
+    CaptureWriter capture;
+    ReplayTiming replayTiming = ReplayTiming::ORIGINAL;
+    InputOptions inputOptions;
+
+    // Overload handling
+    OverloadPolicy overload = OverloadPolicy::BLOCK;
+    uint64_t pairLimit = 0;        // setStopAfter
+    uint64_t durationLimit_ns = 0;
+    uint64_t stopAt = 0;           // absolute, set when the input opens
+    bool limitHit = false;
+    uint64_t queueFullNs = 0;
+    uint64_t stallSince = 0;       // pooled: first failed offer of the pending pair
+    uint64_t lineDropEnd = 0;  // DROP_LINE: pairs with seq below this are discarded
+    uint64_t droppedCount = 0;
+    uint64_t dropRangesLost = 0; // ranges not logged once the log is full
+    std::vector<DropRange> dropRangeLog;
+
+    // Input state (opened by openInput())
+    CsvStreamer csvStreamer;
+    RawStreamer rawStreamer;
+    CaptureReader replayReader;
+    std::mt19937 rng;
+    std::uniform_int_distribution<int> dist{0, 255};
+    uint64_t replayBase = 0;   // REPLAY schedule: first pair time + sum of recorded gaps
+    uint64_t replayOffset = 0;
+
+    // Pooled execution: the pair waiting to be due / to fit downstream
+    bool inputOpen = false;
+    bool hasPending = false;
+    bool pendingStamped = false;
+    DataPair pending;
+    size_t pendingSink = 0;    // next queue/ring to receive it (fan-out)
+    uint64_t pendingDue = 0;
+    uint64_t pendingStart = 0;
+    uint64_t nextDue = 0;
+
+    // Worker placement (applied at the top of run())
+    ThreadPlacement placement_;
+    PlacementReport placementReport_;
+    std::atomic<bool> placed_{false};
+
     // Profiling
     BlockProfiler profiler_;
+    DeadlineMonitor pairDeadline{"generator-pair", 0};
+    LiveStatsPublisher live_;
+    BlockPerf perf_;
+    UtilizationMeter util_;
     
     // Memory profiling (queue occupancy from producer side)
     uint64_t totalQueueSizeSamples;
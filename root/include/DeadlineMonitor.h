@@ -0,0 +1,119 @@
+// DeadlineMonitor: on-the-fly budget accounting for one real-time deadline
+// (e.g. "filter one pair within T_ns", "second output within 100 ns of the first").
+// - record() is called by the owning block's thread: two relaxed counters plus, only on
+//   a miss worse than the current K-th worst, a small heap update.
+// - checked()/missed() may be read from any thread (the watchdog polls them).
+// - The worst-K log is written by the owner only; read it after the block has stopped.
+//
+// DeadlineWatchdog polls groups of monitors (one group per block) on its own thread. When a
+// monitor's miss rate over the last interval crosses the alert threshold it logs an alert;
+// if its group has a shed hook (--shed) that block alone sheds optional work
+// (Block::shedOptionalWork(true)). Once the group's monitors are all back below half the
+// threshold for a few intervals, the work is restored.
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct DeadlineMiss {
+    uint64_t seq;
+    uint64_t actual_ns;
+};
+
+class DeadlineMonitor {
+public:
+    // budget_ns = 0 disables the monitor (record() returns immediately).
+    DeadlineMonitor(const std::string& name, uint64_t budget_ns, size_t worstK = 16);
+
+    void setBudget(uint64_t budget_ns) { budget_ = budget_ns; }
+    uint64_t budget() const { return budget_; }
+    const std::string& name() const { return name_; }
+
+    void record(uint64_t seq, uint64_t actual_ns) {
+        if (budget_ == 0) return;
+        // Single writer: load + store avoids a locked read-modify-write.
+        checked_.store(checked_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (actual_ns <= budget_) return;
+        missed_.store(missed_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (worst_.size() < worstK_ || actual_ns > worst_.front().actual_ns)
+            logWorst(seq, actual_ns);
+    }
+
+    uint64_t checked() const { return checked_.load(std::memory_order_relaxed); }
+    uint64_t missed() const { return missed_.load(std::memory_order_relaxed); }
+
+    // Worst misses, largest first (owner thread / after stop).
+    std::vector<DeadlineMiss> worst() const;
+
+    // "Deadline <name> (budget N ns): M / C missed (x%), worst: seq 12 = 4500 ns, ..."
+    void printStats() const;
+
+private:
+    void logWorst(uint64_t seq, uint64_t actual_ns);
+
+    std::string name_;
+    uint64_t budget_;
+    size_t worstK_;
+    std::atomic<uint64_t> checked_{0};
+    std::atomic<uint64_t> missed_{0};
+    std::vector<DeadlineMiss> worst_; // min-heap on actual_ns
+};
+
+class DeadlineWatchdog {
+public:
+    // alertRate: fraction of checked items over budget (per interval) that raises an alert.
+    DeadlineWatchdog(uint64_t interval_ms, double alertRate);
+    ~DeadlineWatchdog();
+
+    DeadlineWatchdog(const DeadlineWatchdog&) = delete;
+    DeadlineWatchdog& operator=(const DeadlineWatchdog&) = delete;
+
+    // Register before start(). owner names the group in messages; shed(true) drops the
+    // owner's optional work while one of its monitors alerts, shed(false) restores it.
+    void watch(const std::string& owner, const std::vector<DeadlineMonitor*>& monitors,
+               std::function<void(bool)> shed = nullptr);
+    void watch(DeadlineMonitor* monitor) { if (monitor) watch(monitor->name(), { monitor }); }
+
+    void start();
+    void stop();
+
+    // Alerts raised (a group entering the alert state), and whether any group is alerting now
+    uint64_t alerts() const { return alerts_.load(std::memory_order_relaxed); }
+    bool shedding() const { return alerting_.load(std::memory_order_relaxed) > 0; }
+
+    // One evaluation over the counts since the previous call (run() calls it each interval).
+    // Returns true while any group is in the alert state.
+    bool poll();
+
+private:
+    struct Watched {
+        DeadlineMonitor* monitor;
+        uint64_t lastChecked;
+        uint64_t lastMissed;
+    };
+    struct Group {
+        std::string owner;
+        std::vector<Watched> monitors;
+        std::function<void(bool)> shed;
+        bool alerting = false;
+        unsigned calmIntervals = 0;
+    };
+
+    void run();
+
+    uint64_t interval_ms_;
+    double alertRate_;
+    std::vector<Group> groups_;
+
+    std::thread worker_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::atomic<uint64_t> alerts_{0};
+    std::atomic<unsigned> alerting_{0};
+};
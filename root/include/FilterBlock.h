@@ -9,8 +9,17 @@
 #include "ThreadSafeQueue.h"
 #include "DataGenerator.h"
 #include "metrics/MetricsCollector.h"
+#include "metrics/MetricsSampler.h"
 #include "Block.h"
+#include "Port.h"
+#include "ThreadPlacement.h"
 #include "profiler/BlockProfiler.h"
+#include "DeadlineMonitor.h"
+#include "profiler/LiveStats.h"
+#include "profiler/PerfCounters.h"
+#include "profiler/StageLatency.h"
+#include "profiler/Trace.h"
+#include "profiler/Utilization.h"
 
 class FilterBlock : public Block {
 public:
@@ -29,8 +38,49 @@ public:
     }
 
     std::string name() const override { return "FilterBlock"; }
+    std::vector<PortBase*> inputPorts() override { return { &in_ }; }
+    InputPort<DataPair>& input() { return in_; }
+
+    // Pooled execution: each step pops and filters up to maxItems pairs.
+    bool supportsStep() const override { return true; }
+    void startSteps() override;
+    StepResult step(size_t maxItems) override;
+    void stopSteps() override;
+
+    void setPlacement(const ThreadPlacement& p) override { placement_ = p; }
+    bool placementReport(PlacementReport& out) const override {
+        if (!placed_.load(std::memory_order_acquire)) return false;
+        out = placementReport_;
+        return true;
+    }
     void printStats() const override;
 
+    // Clock for all timestamps (default steady_clock); the simulator injects virtual time.
+    void setClock(NowFn now) { nowFn = now; }
+
+    // Budgets: one pair (both outputs) within pair_ns, second output within gap_ns of the first (0 = off)
+    void setDeadlineBudgets(uint64_t pair_ns, uint64_t gap_ns) {
+        pairDeadline.setBudget(pair_ns);
+        gapDeadline.setBudget(gap_ns);
+    }
+    std::vector<DeadlineMonitor*> deadlineMonitors() override { return { &pairDeadline, &gapDeadline }; }
+    bool hasOptionalWork() const override { return metrics != nullptr; }
+    void shedOptionalWork(bool shed) override { metricsShed.store(shed, std::memory_order_relaxed); }
+    LiveStatsPublisher* liveStats() override { return &live_; }
+
+    // Which pairs reach metrics->recordPair (default all), see metrics/MetricsSampler.h
+    void setMetricsSampling(const SamplingPolicy& policy) { sampler_.configure(policy); }
+    const MetricsSampler& metricsSampler() const { return sampler_; }
+
+    // Hardware counters for the worker thread (threads executor only), in printStats per pixel
+    void setPerfCounters(bool on) { perf_.enable(on); }
+
+    // Busy (filtering) vs idle (input empty) time of the worker, from its first pair
+    const UtilizationMeter& utilization() const { return util_; }
+
+    // Per-stage latency of every stamped pair, recorded once its outputs are emitted
+    const StageLatency& stageLatency() const { return stages_; }
+
     bool loadKernelFromFile(const std::string& path);
     
     double testApplyFIR(const std::vector<double>& samples) {
@@ -59,12 +109,35 @@ public:
     void pushSample(double sample);
     bool processSample(double sample, uint64_t proc_start, uint64_t& out_ts);
     void flushWithZeros();
+    void processPair(const DataPair& pair);
+    void publishLive(uint64_t now);
+    void emitStages(uint64_t pairIndex, uint64_t emitted_ns);
+    void endShedRun();
+
+    // Consumer idle accounting: time waiting on an empty input, from the first pair on
+    // (queueSizeSampleCount counts processed pairs), so start-up waits are not included.
+    void markIdle() {
+        if (idleSince == 0 && queueSizeSampleCount > 0) {
+            idleSince = nowFn();
+            util_.idle(idleSince);
+            if (live_.enabled() && live_.due(idleSince)) publishLive(idleSince);
+        }
+    }
+    void markBusy() {
+        if (idleSince == 0) return;
+        uint64_t now = nowFn();
+        idleNs += now - idleSince;
+        util_.busy(now);
+        CYNLR_TRACE_SPAN("input empty", idleSince, now);
+        idleSince = 0;
+    }
 
     std::thread worker;
     std::atomic<bool> running;
     std::atomic<bool> ready;
 
-    ThreadSafeQueue<DataPair>* queue;
+    NowFn nowFn;
+    InputPort<DataPair> in_{"in"}; // fan-in: all bound sources are polled round-robin
     MetricsCollector* metrics;
 
     // FIR state
@@ -85,6 +158,43 @@ public:
 
     BlockProfiler profiler_;
 
+    // Sequence gaps (pairs dropped upstream by an overload policy); single-source inputs only
+    uint64_t expectedSeq = 0;
+    uint64_t seqGaps = 0;
+    uint64_t missingPairs = 0;
+
+    // Deadline accounting; while metricsShed is set processPair skips metrics->recordPair
+    // and reports each skipped run to metrics->recordShed
+    DeadlineMonitor pairDeadline{"filter-pair", 0};
+    DeadlineMonitor gapDeadline{"output-gap", 0};
+    std::atomic<bool> metricsShed{false};
+    uint64_t shedPairs = 0;
+    uint64_t shedRunPairs = 0;
+    uint64_t shedRunFirst = 0;
+    uint64_t shedRunLast = 0;
+    MetricsSampler sampler_;
+
+    // Live statistics (off unless a StatsReporter watches this block)
+    LiveStatsPublisher live_;
+
+    // Worker-thread perf counters (opened / closed inside run())
+    BlockPerf perf_;
+
+    // Stage latency: stamps of the last few pairs, held until the FIR emits their outputs
+    StageLatency stages_;
+    PairStages inFlight_[4];
+    uint64_t stagePairs_ = 0;
+
+    // Idle accounting (markIdle / markBusy)
+    uint64_t idleNs = 0;
+    uint64_t idleSince = 0;
+    UtilizationMeter util_;
+
+    // Worker placement (applied at the top of run())
+    ThreadPlacement placement_;
+    PlacementReport placementReport_;
+    std::atomic<bool> placed_{false};
+
     // Memory profiling (queue occupancy)
     uint64_t totalQueueSizeSamples;
     uint64_t minQueueSize;
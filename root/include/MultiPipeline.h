@@ -0,0 +1,55 @@
+// MultiPipeline: several independent generator -> filter pipelines in one process
+// (one per camera). Each --pipeline="<key>=<value>;..." spec overrides the base Config
+// for its own pipeline; pipelines share no queues, blocks or metrics files.
+//
+// Spec keys: name, mode, csv, raw, replay, columns, T_ns, threshold, filterfile,
+//            queue-capacity, overload, executor (threads|pool), cpu (both blocks),
+//            generator-cpu, filter-cpu (CPU lists as in --place, e.g. 2,4-5)
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Config.h"
+#include "Pipeline.h"
+#include "profiler/LatencyHistogram.h"
+
+// Applies one spec on top of config; name defaults to the caller's value. False (with a message) on bad input.
+bool applyPipelineSpec(const std::string& spec, Config& config, std::string& name);
+
+// Throughput / latency of one finished pipeline.
+struct PipelineSummary {
+    std::string name;
+    uint64_t pairs = 0;             // pairs through the filter (or produced, without a filter)
+    double elapsed_ms = 0.0;        // filter (or generator) active time
+    double throughput = 0.0;        // pairs / sec over elapsed_ms
+    double target = 0.0;            // 1e9 / T_ns pairs / sec (0 = unpaced)
+    double latency_avg_ns = 0.0;    // generator -> filter pop
+    uint64_t latency_max_ns = 0;
+    uint64_t proc_p50_ns = 0;       // per-output processing time
+    uint64_t proc_p99_ns = 0;
+    LatencyHistogram proc;          // filter profiler histogram, merged into the aggregate
+};
+
+struct AggregateSummary {
+    size_t pipelines = 0;
+    uint64_t pairs = 0;
+    double wall_ms = 0.0;
+    double throughput = 0.0;        // all pairs / wall time
+    double latency_avg_ns = 0.0;    // pair-weighted over pipelines
+    uint64_t latency_max_ns = 0;
+    std::string worstLatency;       // pipeline holding latency_max_ns
+    double min_throughput = 0.0;
+    std::string slowest;            // lowest per-pipeline throughput
+    uint64_t proc_p50_ns = 0;       // over every pipeline's outputs (merged histograms)
+    uint64_t proc_p99_ns = 0;
+    uint64_t proc_max_ns = 0;
+};
+
+// Call after ctx.pipeline.stop().
+PipelineSummary summarizePipeline(const std::string& name, const PipelineContext& ctx, const Config& config);
+
+AggregateSummary aggregateSummaries(const std::vector<PipelineSummary>& summaries, double wall_ms);
+
+// Per-pipeline table followed by the aggregate.
+void printPipelineSummaries(const std::vector<PipelineSummary>& summaries, double wall_ms);
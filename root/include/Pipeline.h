@@ -1,58 +1,140 @@
 #pragma once
 #include "Block.h"
+#include "Port.h"
 #include "Config.h"
 #include "ThreadSafeQueue.h"
 #include "DataGenerator.h"
+#include "ThreadPlacement.h"
+#include "WorkStealingPool.h"
 #include "metrics/MetricsCollector.h"
 #include <vector>
 #include <memory>
+#include <string>
 #include <iostream>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
-// Pipeline manager: owns and orchestrates blocks
+class FilterBlock;
+class DeadlineWatchdog;
+class StatsReporter;
+
+// Pipeline manager: owns blocks and the typed edges (queues) between their ports.
+// Blocks are started consumers-first (reverse topological order) and stopped
+// producers-first; after a block stops, its outgoing edges are shut down so the
+// next stage drains what is left and exits.
 class Pipeline {
 public:
-    // Add a block (transfers ownership)
-    void addBlock(std::unique_ptr<Block> block) {
+    // Add a block (transfers ownership); returns the block for connect()
+    Block* addBlock(std::unique_ptr<Block> block) {
         blocks_.push_back(std::move(block));
+        return blocks_.back().get();
     }
 
-    // Start all blocks in order
-    void start() {
-        for (auto& b : blocks_) {
-            std::cout << "[Pipeline] Starting " << b->name() << "\n";
-            b->start();
-        }
-    }
+    // Connect from.outPort -> to.inPort with a new SPSC edge of the given capacity.
+    // Fails (with a message) on unknown ports or mismatched element types.
+    bool connect(Block* from, const std::string& outPort,
+                 Block* to, const std::string& inPort,
+                 size_t capacity);
 
-    // Stop all blocks in reverse order
-    void stop() {
-        for (auto it = blocks_.rbegin(); it != blocks_.rend(); ++it) {
-            std::cout << "[Pipeline] Stopping " << (*it)->name() << "\n";
-            (*it)->stop();
-        }
+    // Typed overload: element types are checked at compile time.
+    template <typename T>
+    bool connect(Block* from, OutputPort<T>& out, Block* to, InputPort<T>& in, size_t capacity) {
+        return connectPorts(from, out, to, in, capacity, false, true);
     }
 
+    // Add `to` as a reader of the broadcast ring behind from.outPort (created by the
+    // first call; later calls reuse it and ignore capacity). Critical readers gate
+    // the producer; non-critical ones are detached if they fall a full ring behind.
+    bool connectBroadcast(Block* from, const std::string& outPort,
+                          Block* to, const std::string& inPort,
+                          size_t capacity, bool critical = true);
+
+    // Blocks in topological order (sources first); false if the graph has a cycle.
+    bool topologicalOrder(std::vector<Block*>& order) const;
+
+    // Start all blocks, consumers first; false (nothing started) if the graph has a cycle.
+    // With a pool, blocks that supportsStep() run as tasks on it, batch items per step,
+    // instead of on their own thread (others still get a thread). The pool must outlive stop().
+    bool start(WorkStealingPool* pool = nullptr, size_t batch = 64);
+
+    // Stop all blocks, producers first, shutting down each block's output edges
+    void stop();
+
     // Print statistics for all blocks
-    void printStats() const {
-        std::cout << "\n=== Pipeline Statistics ===\n";
-        for (const auto& b : blocks_) {
-            std::cout << "\n[" << b->name() << "]\n";
-            b->printStats();
-        }
-        std::cout << "===========================\n";
-    }
+    void printStats() const;
+
+    // Print where each block's worker landed (CPU, node, policy) and which
+    // NUMA node holds each edge's buffer. Call after start().
+    void printPlacement() const;
+
+    // Register each block's deadline monitors with the watchdog (before it starts); with shed,
+    // a block drops its optional work while its own monitors alert.
+    void watchDeadlines(DeadlineWatchdog& watchdog, bool shed);
+
+    // Registers every block with live statistics, named "<prefix><block name>"; before start().
+    void reportLiveStats(StatsReporter& reporter, const std::string& prefix = "");
+
+    size_t edgeCount() const { return edges_.size(); }
+    size_t linkCount() const { return links_.size(); }
 
 private:
+    // One producer -> consumer connection; several links share an edge when it broadcasts.
+    struct Link {
+        Block* from;
+        Block* to;
+        EdgeBase* edge;
+        std::string label; // "Producer.out -> Consumer.in"
+        bool critical;
+    };
+
+    bool resolvePorts(Block* from, const std::string& outPort, Block* to, const std::string& inPort,
+                      PortBase*& out, PortBase*& in) const;
+    bool connectPorts(Block* from, PortBase& out, Block* to, PortBase& in, size_t capacity,
+                      bool broadcast, bool critical);
+
+    // A block running on the pool: one task in flight at a time, resubmitted after each step
+    // that made progress. After an Idle step the task parks (no task queued) until a pooled
+    // neighbour makes progress or finishes, or until a pool timer fires: the block's own due
+    // time, else a backstop. Blocks with a threaded neighbour cannot be woken by it and poll.
+    enum StepState { STEP_RUNNING, STEP_NOTIFIED, STEP_PARKED, STEP_DONE };
+    struct StepTask : std::enable_shared_from_this<StepTask> {
+        Block* block = nullptr;
+        WorkStealingPool* pool = nullptr;
+        size_t batch = 0;
+        std::vector<EdgeBase*> outputs;    // shut down once the block is done
+        std::vector<StepTask*> neighbours; // pooled blocks sharing an edge, woken on progress
+        bool wakeable = true;
+        unsigned idleStreak = 0;
+        std::atomic<int> state{STEP_RUNNING};
+
+        std::mutex mutex;
+        std::condition_variable doneCv;
+        bool done = false;
+    };
+    static void runStep(StepTask* task);
+    static void wakeStep(StepTask* task);
+
     std::vector<std::unique_ptr<Block>> blocks_; // owns blocks
+    std::vector<std::unique_ptr<EdgeBase>> edges_; // owns queues/rings between ports
+    std::vector<Link> links_;
+    std::vector<Block*> started_; // start order, for stop()
+    std::vector<std::shared_ptr<StepTask>> tasks_; // pooled blocks (pending pool timers share them)
+    WorkStealingPool* pool_ = nullptr;
+    size_t batch_ = 0;
 };
 
 // Context: pipeline + references to specific blocks for control flow
 struct PipelineContext {
     Pipeline pipeline;
     DataGenerator* generator = nullptr; // <- add = nullptr
+    FilterBlock* filter = nullptr;      // null when the filter is disabled
+
+    // How this pipeline's blocks run: own threads, or tasks on a shared pool
+    ExecutionMode execution = ExecutionMode::THREADS;
+    size_t batch = 64;                  // items per task step (POOL)
 };
 
-// Factory function: build pipeline from config
+// Factory function: build pipeline from config (creates one queue per edge)
 PipelineContext buildPipeline(const Config& config,
-                              ThreadSafeQueue<DataPair>* queue,
-                              MetricsCollector* metrics);
\ No newline at end of file
+                              MetricsCollector* metrics);
@@ -0,0 +1,248 @@
+// Port: typed block endpoints and the queue edges that join them.
+// - A Block exposes named OutputPort<T> / InputPort<T> members through outputPorts()/inputPorts().
+// - Pipeline::connect() creates one SPSC Edge<T> per connection and binds it to both ports.
+// - An output bound to several edges fans out (every consumer sees every item); an input
+//   bound to several edges fans in (sources are polled round-robin).
+// - Pipeline::connectBroadcast() instead shares one BroadcastRing<T> between all readers
+//   of an output, so fan-out writes each item once rather than once per consumer.
+// - Ports hold non-owning queue/ring pointers; the Pipeline owns the edges.
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <typeindex>
+#include <typeinfo>
+#include <cstddef>
+#include <algorithm>
+
+#include "ThreadSafeQueue.h"
+#include "BroadcastRing.h"
+
+class Block;
+class PortBase;
+
+// Type-erased edge so Pipeline can own queues of any element type.
+class EdgeBase {
+public:
+    virtual ~EdgeBase() = default;
+    virtual void shutdown() = 0;
+    virtual size_t size() const = 0;
+    virtual size_t capacity() const = 0;
+    virtual const void* storage() const = 0;
+
+    // Broadcast edges: one ring, many readers (queue edges return false / 0).
+    virtual bool isBroadcast() const { return false; }
+    virtual size_t addReader(bool critical) { (void)critical; return 0; }
+
+    Block* from = nullptr;      // producer; its stop() closes the edge
+    PortBase* fromPort = nullptr;
+};
+
+template <typename T>
+class Edge : public EdgeBase {
+public:
+    explicit Edge(size_t capacity) : queue(capacity) {}
+
+    void shutdown() override { queue.shutdown(); }
+    size_t size() const override { return queue.size(); }
+    size_t capacity() const override { return queue.capacity(); }
+    const void* storage() const override { return queue.data(); }
+
+    ThreadSafeQueue<T> queue;
+};
+
+template <typename T>
+class BroadcastEdge : public EdgeBase {
+public:
+    explicit BroadcastEdge(size_t capacity) : ring(capacity) {}
+
+    void shutdown() override { ring.shutdown(); }
+    size_t size() const override { return ring.maxLag(); }
+    size_t capacity() const override { return ring.capacity(); }
+    const void* storage() const override { return ring.data(); }
+    bool isBroadcast() const override { return true; }
+    size_t addReader(bool critical) override { return ring.addReader(critical); }
+
+    BroadcastRing<T> ring;
+};
+
+class PortBase {
+public:
+    PortBase(const std::string& name, std::type_index type) : name_(name), type_(type) {}
+    virtual ~PortBase() = default;
+
+    const std::string& name() const { return name_; }
+    std::type_index type() const { return type_; }
+
+    // Creates an edge carrying this port's element type.
+    virtual std::unique_ptr<EdgeBase> makeEdge(size_t capacity) const = 0;
+    virtual std::unique_ptr<EdgeBase> makeBroadcastEdge(size_t capacity) const = 0;
+
+    // Binds the edge to this port; false if the edge carries another type.
+    // For broadcast edges, inputs take the reader id returned by EdgeBase::addReader.
+    virtual bool attach(EdgeBase& edge, size_t reader = 0) = 0;
+
+private:
+    std::string name_;
+    std::type_index type_;
+};
+
+template <typename T>
+class OutputPort : public PortBase {
+public:
+    explicit OutputPort(const std::string& name = "out") : PortBase(name, typeid(T)) {}
+
+    std::unique_ptr<EdgeBase> makeEdge(size_t capacity) const override {
+        return std::unique_ptr<EdgeBase>(new Edge<T>(capacity));
+    }
+
+    std::unique_ptr<EdgeBase> makeBroadcastEdge(size_t capacity) const override {
+        return std::unique_ptr<EdgeBase>(new BroadcastEdge<T>(capacity));
+    }
+
+    bool attach(EdgeBase& edge, size_t) override {
+        if (Edge<T>* e = dynamic_cast<Edge<T>*>(&edge)) {
+            bind(&e->queue);
+            return true;
+        }
+        if (BroadcastEdge<T>* b = dynamic_cast<BroadcastEdge<T>*>(&edge)) {
+            rings_.push_back(&b->ring);
+            return true;
+        }
+        return false;
+    }
+
+    // Direct binding for blocks wired by hand (tests, legacy constructors).
+    void bind(ThreadSafeQueue<T>* q) {
+        if (!q) return;
+        if (evicting_) q->enableEviction();
+        queues_.push_back(q);
+    }
+
+    // The owner drops the oldest queued items when full (push_evict): applies to the queues
+    // bound so far and to later ones. Before the pipeline starts.
+    void enableEviction() {
+        evicting_ = true;
+        for (auto* q : queues_) q->enableEviction();
+    }
+
+    const std::vector<ThreadSafeQueue<T>*>& queues() const { return queues_; }
+    const std::vector<BroadcastRing<T>*>& rings() const { return rings_; }
+    bool connected() const { return !queues_.empty() || !rings_.empty(); }
+
+    void shutdown() {
+        for (auto* q : queues_) q->shutdown();
+        for (auto* r : rings_) r->shutdown();
+    }
+
+    // Backlog of the slowest consumer.
+    size_t size() const {
+        size_t s = 0;
+        for (auto* q : queues_) s = std::max(s, q->size());
+        for (auto* r : rings_) s = std::max(s, r->maxLag());
+        return s;
+    }
+
+    // Smallest downstream buffer (the first to exert backpressure).
+    size_t capacity() const {
+        size_t c = 0;
+        for (auto* q : queues_) c = (c == 0) ? q->capacity() : std::min(c, q->capacity());
+        for (auto* r : rings_) c = (c == 0) ? r->capacity() : std::min(c, r->capacity());
+        return c;
+    }
+
+private:
+    std::vector<ThreadSafeQueue<T>*> queues_;
+    std::vector<BroadcastRing<T>*> rings_;
+    bool evicting_ = false;
+};
+
+template <typename T>
+class InputPort : public PortBase {
+public:
+    explicit InputPort(const std::string& name = "in") : PortBase(name, typeid(T)) {}
+
+    std::unique_ptr<EdgeBase> makeEdge(size_t capacity) const override {
+        return std::unique_ptr<EdgeBase>(new Edge<T>(capacity));
+    }
+
+    std::unique_ptr<EdgeBase> makeBroadcastEdge(size_t capacity) const override {
+        return std::unique_ptr<EdgeBase>(new BroadcastEdge<T>(capacity));
+    }
+
+    bool attach(EdgeBase& edge, size_t reader) override {
+        if (Edge<T>* e = dynamic_cast<Edge<T>*>(&edge)) {
+            bind(&e->queue);
+            return true;
+        }
+        if (BroadcastEdge<T>* b = dynamic_cast<BroadcastEdge<T>*>(&edge)) {
+            sources_.push_back(Source{ nullptr, &b->ring, reader });
+            return true;
+        }
+        return false;
+    }
+
+    void bind(ThreadSafeQueue<T>* q) {
+        if (q) sources_.push_back(Source{ q, nullptr, 0 });
+    }
+
+    bool connected() const { return !sources_.empty(); }
+    size_t sourceCount() const { return sources_.size(); }
+
+    // Polls the sources round-robin, starting after the one served last.
+    bool try_pop(T& out) {
+        size_t n = sources_.size();
+        for (size_t i = 0; i < n; ++i) {
+            Source& src = sources_[next_];
+            if (++next_ == n) next_ = 0;
+            if (src.queue ? src.queue->try_pop(out) : src.ring->try_pop(src.reader, out)) return true;
+        }
+        return false;
+    }
+
+    // True once every source has shut down and been drained (or detached us).
+    bool exhausted() const {
+        for (const Source& src : sources_) {
+            if (src.queue) {
+                if (!src.queue->isShutdown() || src.queue->size() != 0) return false;
+            } else if (!src.ring->exhausted(src.reader)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Closes queue sources. On a live broadcast ring this reader detaches instead
+    // (other readers keep going); on a finished ring it stays to drain what is left.
+    void shutdown() {
+        for (const Source& src : sources_) {
+            if (src.queue) src.queue->shutdown();
+            else if (!src.ring->isShutdown()) src.ring->detach(src.reader);
+        }
+    }
+
+    size_t size() const {
+        size_t s = 0;
+        for (const Source& src : sources_)
+            s += src.queue ? src.queue->size() : src.ring->lag(src.reader);
+        return s;
+    }
+
+    size_t capacity() const {
+        size_t c = 0;
+        for (const Source& src : sources_)
+            c += src.queue ? src.queue->capacity() : src.ring->capacity();
+        return c;
+    }
+
+private:
+    // Either a queue edge or one reader cursor on a broadcast ring.
+    struct Source {
+        ThreadSafeQueue<T>* queue;
+        BroadcastRing<T>* ring;
+        size_t reader;
+    };
+
+    std::vector<Source> sources_;
+    size_t next_ = 0;
+};
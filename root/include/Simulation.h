@@ -0,0 +1,73 @@
+// Simulation: deterministic virtual-time run of the generator -> filter pipeline.
+// - Both blocks run through their pooled step() interface on one thread, driven by a
+//   discrete-event loop. The generator and the filter read VirtualClock instead of
+//   steady_clock, so pacing waits cost nothing and an hour of line data runs at CPU speed.
+// - Each operation is charged a modeled cost (SimulationOptions) instead of its real
+//   duration, plus optional seeded random stalls (preemption) on the filter.
+// - The report shows what the real pipeline would have seen: queue occupancy over time,
+//   generator -> output latency, blocked time / drops and filter utilisation.
+//
+// --simulate[="gen=50;push=20;filter=100;metrics=0;stall=20000;stall-rate=0.001;pairs=1000000;ms=0;seed=1"]
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+struct Config;
+
+struct SimulationOptions {
+    uint64_t gen_ns = 50;        // read + stamp one pair
+    uint64_t push_ns = 20;       // queue push (pair visible to the filter after this)
+    uint64_t filter_ns = 100;    // pop + FIR for one pair (both outputs)
+    uint64_t metrics_ns = 0;     // extra per pair when --stats records metrics
+    uint64_t stall_ns = 0;       // length of one filter stall
+    double stall_rate = 0.0;     // probability of a stall per filter pair
+    uint64_t pairs = 0;          // stop after this many pairs (0 = input EOF; random input: 1,000,000)
+    uint64_t duration_ms = 0;    // stop after this much virtual time (0 = off)
+    uint64_t seed = 1;           // stall sequence
+};
+
+// Applies "key=value;..." on top of opts; false (with a message) on bad input.
+bool parseSimulationSpec(const std::string& spec, SimulationOptions& opts);
+
+// Shared virtual time for NowFn/SleepFn. Those are plain function pointers, so there is
+// one clock per process and one simulation at a time.
+class VirtualClock {
+public:
+    static uint64_t now() { return now_; }
+    static void sleep(uint64_t ns) { now_ += ns; }
+    static void set(uint64_t t) { now_ = t; }
+
+private:
+    static uint64_t now_;
+};
+
+struct SimulationResult {
+    uint64_t generated = 0;       // pairs produced by the generator (including dropped ones)
+    uint64_t processed = 0;       // pairs through the filter
+    uint64_t dropped = 0;         // overload policy drops
+    uint64_t stalls = 0;
+
+    uint64_t virtual_ns = 0;      // simulated time span
+    double wall_ms = 0.0;         // real time the simulation took
+    double target_rate = 0.0;     // 1e9 / T_ns pairs/sec (0 = unpaced)
+    double achieved_rate = 0.0;   // processed / virtual time
+
+    size_t capacity = 0;          // usable queue slots
+    double occupancy_avg = 0.0;   // time-weighted
+    size_t occupancy_p99 = 0;     // 99% of the time the queue held at most this many pairs
+    size_t occupancy_max = 0;
+    uint64_t blocked_ns = 0;      // generator waiting for queue space
+    double filter_utilization = 0.0;
+
+    uint64_t latency_avg_ns = 0;  // generator stamp -> filter outputs done
+    uint64_t latency_p50_ns = 0;
+    uint64_t latency_p99_ns = 0;
+    uint64_t latency_max_ns = 0;
+};
+
+// Runs config (input, columns, T_ns, queue capacity, overload policy, filter) under
+// config.sim. False (with a message) if the input cannot be opened.
+bool runSimulation(const Config& config, SimulationResult& out);
+
+void printSimulation(const SimulationResult& result);
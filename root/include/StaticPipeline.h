@@ -0,0 +1,185 @@
+// StaticPipeline: a pipeline whose stages are fixed at compile time.
+// StaticPipeline<Source, S1, S2, ..., Sink> pulls items from Source::next(item) and pushes
+// each one through the stages as direct calls the compiler can inline: no virtual
+// dispatch and no queue between stages. A ThreadBoundary<T> in the stage list is the only
+// place a queue appears; the stages after it run on their own thread.
+//
+// Stage contract (derive from StaticStage to get the pass-through finish):
+//   template <typename Next> void process(const In& in, Next& next); // next.push(out) 0..n times
+//   template <typename Next> void finish(Next& next);                 // end of stream: flush, then next.finish()
+// Source contract:
+//   using value_type = ...;  bool next(value_type& out);              // false at end of stream
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+
+#include "ThreadSafeQueue.h"
+#include "ThreadPlacement.h"
+#include "Util.h"
+
+struct StaticStage {
+    template <typename Next>
+    void finish(Next& next) { next.finish(); }
+};
+
+// Marker: hand items of type T to a new thread through a ThreadSafeQueue.
+template <typename T>
+struct ThreadBoundary {
+    explicit ThreadBoundary(size_t capacity = 1024, const ThreadPlacement& placement = ThreadPlacement())
+        : capacity(capacity), placement(placement) {}
+
+    size_t capacity;
+    ThreadPlacement placement; // for the downstream thread
+};
+
+namespace detail {
+
+template <typename... Stages>
+class Chain;
+
+// End of the chain: swallows items.
+template <>
+class Chain<> {
+public:
+    template <typename T>
+    void push(const T&) {}
+    void finish() {}
+    void start() {}
+    void join() {}
+};
+
+template <typename S, typename... Rest>
+class Chain<S, Rest...> {
+public:
+    explicit Chain(S s, Rest... rest) : head_(std::move(s)), tail_(std::move(rest)...) {}
+
+    template <typename T>
+    void push(const T& item) { head_.process(item, tail_); }
+    void finish() { head_.finish(tail_); }
+    void start() { tail_.start(); }
+    void join() { tail_.join(); }
+
+    S& head() { return head_; }
+    Chain<Rest...>& tail() { return tail_; }
+
+private:
+    S head_;
+    Chain<Rest...> tail_;
+};
+
+// Thread boundary: the upstream thread pushes into the queue; a worker thread
+// pops and drives the rest of the chain.
+template <typename T, typename... Rest>
+class Chain<ThreadBoundary<T>, Rest...> {
+public:
+    explicit Chain(ThreadBoundary<T> boundary, Rest... rest)
+        : boundary_(boundary), queue_(boundary.capacity), tail_(std::move(rest)...) {}
+
+    Chain(const Chain&) = delete;
+    Chain& operator=(const Chain&) = delete;
+
+    void push(const T& item) {
+        // Short spin, then yield so a consumer sharing this core can drain the queue.
+        for (int spins = 0; !queue_.try_push(item); ++spins) {
+            if (queue_.isShutdown()) return;
+            if (spins < 1024) util::cpu_relax();
+            else std::this_thread::yield();
+        }
+    }
+
+    void finish() { queue_.shutdown(); } // worker drains, then finishes the tail
+
+    void start() {
+        tail_.start();
+        worker_ = std::thread([this] {
+            applyThreadPlacement(boundary_.placement);
+            T item;
+            int spins = 0;
+            for (;;) {
+                if (queue_.try_pop(item)) {
+                    tail_.push(item);
+                    spins = 0;
+                } else if (queue_.isShutdown()) {
+                    // shutdown() is published after the last push: one more pass drains it
+                    while (queue_.try_pop(item)) tail_.push(item);
+                    break;
+                } else if (++spins < 1024) {
+                    util::cpu_relax();
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            tail_.finish();
+        });
+    }
+
+    void join() {
+        if (worker_.joinable()) worker_.join();
+        tail_.join();
+    }
+
+    ThreadBoundary<T>& head() { return boundary_; }
+    Chain<Rest...>& tail() { return tail_; }
+    const ThreadSafeQueue<T>& queue() const { return queue_; }
+
+private:
+    ThreadBoundary<T> boundary_;
+    ThreadSafeQueue<T> queue_;
+    Chain<Rest...> tail_;
+    std::thread worker_;
+};
+
+template <size_t I, typename C>
+struct ChainAt;
+
+template <typename S, typename... Rest>
+struct ChainAt<0, Chain<S, Rest...>> {
+    static S& get(Chain<S, Rest...>& c) { return c.head(); }
+};
+
+template <size_t I, typename S, typename... Rest>
+struct ChainAt<I, Chain<S, Rest...>> {
+    static auto& get(Chain<S, Rest...>& c) { return ChainAt<I - 1, Chain<Rest...>>::get(c.tail()); }
+};
+
+} // namespace detail
+
+template <typename Source, typename... Stages>
+class StaticPipeline {
+public:
+    explicit StaticPipeline(Source source, Stages... stages)
+        : source_(std::move(source)), chain_(std::move(stages)...) {}
+
+    StaticPipeline(const StaticPipeline&) = delete;
+    StaticPipeline& operator=(const StaticPipeline&) = delete;
+
+    // Drives the source on the calling thread until end of stream or requestStop(),
+    // then flushes every stage and joins the boundary threads. Returns items pulled.
+    uint64_t run() {
+        chain_.start();
+        typename Source::value_type item{};
+        uint64_t count = 0;
+        while (!stop_.load(std::memory_order_relaxed) && source_.next(item)) {
+            chain_.push(item);
+            ++count;
+        }
+        chain_.finish();
+        chain_.join();
+        return count;
+    }
+
+    void requestStop() { stop_.store(true, std::memory_order_relaxed); }
+
+    Source& source() { return source_; }
+
+    // I-th entry of the stage list (ThreadBoundary markers count).
+    template <size_t I>
+    auto& stage() { return detail::ChainAt<I, detail::Chain<Stages...>>::get(chain_); }
+
+private:
+    Source source_;
+    detail::Chain<Stages...> chain_;
+    std::atomic<bool> stop_{false};
+};
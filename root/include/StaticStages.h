@@ -0,0 +1,142 @@
+// Concrete stages for StaticPipeline (--engine=static / static-split):
+//   PairSource -> [ThreadBoundary<DataPair>] -> FirThresholdStage -> OutputStats
+// They do the same work as DataGenerator / FilterBlock, with no Block dispatch
+// and no queue unless a ThreadBoundary is declared between them.
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "Config.h"
+#include "DataGenerator.h"
+#include "StaticPipeline.h"
+#include "profiler/BlockProfiler.h"
+#include "stream/CsvStreamer.h"
+#include "stream/RawStreamer.h"
+
+// One thresholded FIR output.
+struct FilterOutput {
+    uint64_t seq = 0;
+    uint64_t gen_ts_ns = 0;
+    double filtered = 0.0;
+    uint8_t value = 0;      // filtered >= threshold
+};
+
+// Source: CSV / RAW / PGM file or uniform random pixels, paced at T_ns per pair (0 = unpaced).
+class PairSource {
+public:
+    using value_type = DataPair;
+
+    PairSource(InputMode mode, const std::string& inputFile, uint64_t T_ns,
+               const InputOptions& opts = InputOptions());
+
+    bool ok() const { return ok_; }
+
+    bool next(DataPair& pair) {
+        if (!first_) util::hybrid_sleep_ns(T_ns_);
+        first_ = false;
+
+        bool have;
+        if (csv_) have = csv_->nextPair(pair.a, pair.b);
+        else if (raw_) have = raw_->nextPair(pair.a, pair.b);
+        else {
+            pair.a = static_cast<uint8_t>(dist_(rng_));
+            pair.b = static_cast<uint8_t>(dist_(rng_));
+            have = true;
+        }
+        if (!have) return false;
+        pair.gen_ts_ns = util::now_ns();
+        pair.gen_ts_valid = true;
+        pair.seq = seq_++;
+        return true;
+    }
+
+private:
+    std::unique_ptr<CsvStreamer> csv_;
+    std::unique_ptr<RawStreamer> raw_;
+    std::mt19937 rng_;
+    std::uniform_int_distribution<int> dist_{0, 255};
+    uint64_t T_ns_;
+    uint64_t seq_ = 0;
+    bool first_ = true;
+    bool ok_ = true;
+};
+
+// 9-tap FIR + threshold, same arithmetic and zero-flush as FilterBlock.
+class FirThresholdStage : public StaticStage {
+public:
+    FirThresholdStage(const double (&kernel)[9], double threshold);
+
+    template <typename Next>
+    void process(const DataPair& pair, Next& next) {
+        sample(static_cast<double>(pair.a), pair, next);
+        sample(static_cast<double>(pair.b), pair, next);
+        last_ = pair;
+    }
+
+    // Post-pad with CENTER zeros so the last real samples reach the window centre.
+    template <typename Next>
+    void finish(Next& next) {
+        for (int i = 0; i < TAPS / 2; ++i) sample(0.0, last_, next);
+        next.finish();
+    }
+
+private:
+    static constexpr int TAPS = 9;
+
+    template <typename Next>
+    void sample(double s, const DataPair& pair, Next& next) {
+        buf_[idx_] = s;
+        if (++idx_ == TAPS) idx_ = 0;
+        if (count_ < TAPS) {
+            if (++count_ < TAPS) return;
+        }
+        double sum = 0.0;
+        int j = idx_;
+        for (int i = 0; i < TAPS; ++i) {
+            sum += buf_[j] * kernel_[i];
+            if (++j == TAPS) j = 0;
+        }
+        FilterOutput out;
+        out.seq = pair.seq;
+        out.gen_ts_ns = pair.gen_ts_ns;
+        out.filtered = sum;
+        out.value = (sum >= threshold_) ? 1 : 0;
+        next.push(out);
+    }
+
+    double kernel_[TAPS];
+    double buf_[TAPS] = {};
+    int idx_ = 0;
+    int count_ = 0;
+    double threshold_;
+    DataPair last_;
+};
+
+// Sink: counts outputs and profiles source-to-output latency.
+class OutputStats : public StaticStage {
+public:
+    OutputStats() : profiler_("StaticPipeline") {}
+
+    template <typename Next>
+    void process(const FilterOutput& out, Next& next) {
+        (void)next;
+        ++outputs_;
+        ones_ += out.value;
+        uint64_t now = util::now_ns();
+        profiler_.recordSample(now > out.gen_ts_ns ? now - out.gen_ts_ns : 0);
+    }
+
+    uint64_t outputs() const { return outputs_; }
+    uint64_t ones() const { return ones_; }
+    BlockProfiler& profiler() { return profiler_; }
+
+private:
+    uint64_t outputs_ = 0;
+    uint64_t ones_ = 0;
+    BlockProfiler profiler_;
+};
+
+// Runs the fixed generator -> filter chain for config.engine; returns the process exit code.
+int runStaticEngine(const Config& config);
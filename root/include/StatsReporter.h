@@ -0,0 +1,68 @@
+// StatsReporter: live windowed statistics while the pipeline runs.
+// Every interval it takes a consistent snapshot of each watched block's LiveStatsPublisher
+// (profiler/LiveStats.h), differences it against the previous one and prints one report:
+// per-interval throughput, latency / service-time percentiles, queue occupancy, drops,
+// deadline misses, stall time, busy share (profiler/Utilization.h), and per-pixel hardware
+// counters when the blocks collect them (--perf-counters).
+// - TEXT: one line per block, prefixed with the elapsed time.
+// - JSON: one object per interval on a single line (newline-delimited JSON).
+// Blocks publish at most once per interval while they have work or go idle, and once more
+// when they finish, so a block that published nothing during an interval is reported as idle.
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class LiveStatsPublisher;
+struct LiveBlockStats;
+
+enum class ReportFormat {
+    TEXT,
+    JSON
+};
+
+class StatsReporter {
+public:
+    StatsReporter(uint64_t interval_ms, ReportFormat format, std::ostream& out);
+    ~StatsReporter();
+
+    StatsReporter(const StatsReporter&) = delete;
+    StatsReporter& operator=(const StatsReporter&) = delete;
+
+    // Register before start(); enables publishing on the block side.
+    void watch(const std::string& name, LiveStatsPublisher* live);
+
+    void start();
+    void stop();   // joins the thread, then reports the last partial interval
+
+    // One report over the snapshots since the previous call (run() calls it each interval).
+    void poll();
+    uint64_t reports() const { return reports_; }
+
+private:
+    struct Watched {
+        std::string name;
+        LiveStatsPublisher* live;
+        std::unique_ptr<LiveBlockStats> last;
+    };
+
+    void run();
+
+    uint64_t interval_ms_;
+    ReportFormat format_;
+    std::ostream& out_;
+    std::vector<Watched> watched_;
+    std::unique_ptr<LiveBlockStats> current_;
+    uint64_t start_ns_ = 0;
+    uint64_t reports_ = 0;
+
+    std::thread worker_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+};
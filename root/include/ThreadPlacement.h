@@ -0,0 +1,56 @@
+// ThreadPlacement: where a block's worker thread runs.
+// - CPU affinity (pthread_setaffinity_np / SetThreadAffinityMask).
+// - Optional real-time policy: SCHED_FIFO / SCHED_RR with a priority on Linux,
+//   TIME_CRITICAL / HIGHEST thread priority on Windows.
+// - numaLocal: the block's input queue is allocated from a thread pinned to the block's
+//   CPUs, so first-touch places its pages on the consumer's NUMA node.
+// Placement is best effort: the PlacementReport records what the OS actually granted
+// (e.g. SCHED_FIFO without CAP_SYS_NICE falls back to the default policy).
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+
+enum class SchedPolicy {
+    DEFAULT,
+    FIFO,
+    RR
+};
+
+struct ThreadPlacement {
+    std::vector<int> cpus;                 // empty = let the scheduler choose
+    SchedPolicy policy = SchedPolicy::DEFAULT;
+    int priority = 0;                      // 1..99 for FIFO/RR
+    bool numaLocal = false;
+
+    bool isDefault() const {
+        return cpus.empty() && policy == SchedPolicy::DEFAULT && !numaLocal;
+    }
+};
+
+struct PlacementReport {
+    bool affinityOk = true;
+    bool schedOk = true;
+    std::vector<int> cpus;        // affinity mask actually in effect
+    std::vector<int> isolatedCpus;// subset of cpus listed as isolated by the kernel
+    int runningCpu = -1;
+    int numaNode = -1;
+    std::string policy = "default";
+    int priority = 0;
+    std::string notes;            // why a request was not honoured
+};
+
+// Parses "<block>:cpu=2,4-5:fifo=80:numa" (also rr=<prio>). Returns false with a message on bad input.
+bool parsePlacementSpec(const std::string& spec, std::string& block, ThreadPlacement& out);
+
+// Applies the placement to the calling thread and reports the result.
+PlacementReport applyThreadPlacement(const ThreadPlacement& placement);
+
+// Runs fn on a temporary thread pinned to cpus (used for NUMA first-touch allocation).
+void runPinned(const std::vector<int>& cpus, const std::function<void()>& fn);
+
+// NUMA node holding the page at p, or -1 if unknown.
+int memoryNumaNode(const void* p);
+
+// "cpus=0-3 (isolated: 2) now on cpu 1, node 0, SCHED_FIFO/80"
+std::string describePlacement(const PlacementReport& report);
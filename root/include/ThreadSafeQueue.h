@@ -1,13 +1,21 @@
 #pragma once
 #include <vector>
 #include <atomic>
+#include <cstdint>
 #include <thread>
 #include <cstddef>
 
 #include "Util.h"
+#include "profiler/ModuleProfiler.h"
 
 // Bounded single-producer single-consumer lock-free circular queue.
 // Pure spin-based with cpu_relax for efficiency.
+// head / tail are unmasked 64-bit counters (they never wrap in practice); one slot stays
+// free, so capacity() is the slot count - 1.
+// By default the consumer owns head and a pop is a copy and a store. enableEviction() lets the
+// producer drop the oldest element (push_evict); both sides then claim an element with a CAS
+// on head before copying it, and the consumer announces the element it is copying so the
+// producer does not refill that slot until the copy is done.
 template <typename T>
 class ThreadSafeQueue {
 public:
@@ -27,56 +35,71 @@ public:
     ThreadSafeQueue(const ThreadSafeQueue&) = delete;
     ThreadSafeQueue& operator=(const ThreadSafeQueue&) = delete;
 
+    // Allows push_evict. Call while wiring, before either side touches the queue.
+    void enableEviction() {
+        evicting = true;
+    }
+
     virtual void push(const T& value) {
         if (closed.load(std::memory_order_acquire)) return;
 
-        size_t curTail = tail.load(std::memory_order_relaxed);
-        size_t nextTail = (curTail + 1) & mask;
-
         // Spin until space available
-        while (nextTail == head.load(std::memory_order_acquire)) {
-            if (closed.load(std::memory_order_acquire)) return;
-            util::cpu_relax();
+        if (!pushSlot(value)) {
+            CYNLR_PROFILE_SCOPE("ThreadSafeQueue.push_wait");
+            while (!pushSlot(value)) {
+                if (closed.load(std::memory_order_acquire)) return;
+                util::cpu_relax();
+            }
         }
-
-        buf[curTail] = value;
-        tail.store(nextTail, std::memory_order_release);
     }
 
     virtual bool pop(T& out) {
-        size_t curHead = head.load(std::memory_order_relaxed);
+        if (popSlot(out)) return true;
 
         // Spin until data available
-        while (curHead == tail.load(std::memory_order_acquire)) {
+        CYNLR_PROFILE_SCOPE("ThreadSafeQueue.pop_wait");
+        for (;;) {
             if (closed.load(std::memory_order_acquire)) {
-                return false;
+                // Re-check: the producer may have pushed between our last look and shutdown()
+                return popSlot(out);
             }
             util::cpu_relax();
+            if (popSlot(out)) return true;
         }
-
-        out = buf[curHead];
-        size_t nextHead = (curHead + 1) & mask;
-        head.store(nextHead, std::memory_order_release);
-
-        return true;
     }
 
     virtual bool try_push(const T& value) {
         if (closed.load(std::memory_order_acquire)) return false;
-        size_t curTail = tail.load(std::memory_order_relaxed);
-        size_t nextTail = (curTail + 1) & mask;
-        if (nextTail == head.load(std::memory_order_acquire)) return false;
-        buf[curTail] = value;
-        tail.store(nextTail, std::memory_order_release);
+        if (!pushSlot(value)) {
+            CYNLR_PROFILE_COUNT("ThreadSafeQueue.try_push_full", 1);
+            return false;
+        }
         return true;
     }
 
     virtual bool try_pop(T& out) {
-        size_t curHead = head.load(std::memory_order_relaxed);
-        if (curHead == tail.load(std::memory_order_acquire)) return false;
-        out = buf[curHead];
-        head.store((curHead + 1) & mask, std::memory_order_release);
-        return true;
+        return popSlot(out);
+    }
+
+    // Producer side, for drop-oldest overload handling (needs enableEviction()): when full,
+    // discard the oldest element (returned in evicted) to make room. Returns true if
+    // something was evicted. Producer and consumer claim elements through the same CAS on
+    // head, so every element is either popped or evicted exactly once.
+    bool push_evict(const T& value, T& evicted) {
+        bool didEvict = false;
+        while (!try_push(value)) {
+            if (closed.load(std::memory_order_acquire)) return didEvict;
+            uint64_t pos = head.load(std::memory_order_acquire);
+            if (tail.load(std::memory_order_relaxed) - pos < mask) {
+                util::cpu_relax(); // room, but the consumer is still copying out of that slot
+                continue;
+            }
+            if (head.compare_exchange_strong(pos, pos + 1, std::memory_order_seq_cst)) {
+                evicted = buf[pos & mask]; // only this thread writes slots
+                didEvict = true;
+            }
+        }
+        return didEvict;
     }
 
     virtual void shutdown() {
@@ -88,19 +111,64 @@ public:
     }
 
     size_t size() const {
-        size_t h = head.load(std::memory_order_acquire);
-        size_t t = tail.load(std::memory_order_acquire);
-        return (t - h) & mask;
+        uint64_t h = head.load(std::memory_order_acquire);
+        uint64_t t = tail.load(std::memory_order_acquire);
+        return static_cast<size_t>(t - h);
     }
 
     size_t capacity() const {
-        return buf.size() - 1;
+        return mask;
+    }
+
+    // Slot storage (for placement diagnostics)
+    const T* data() const {
+        return buf.data();
     }
 
 private:
+    static const uint64_t kNotCopying = ~0ULL;
+
+    // Producer only
+    bool pushSlot(const T& value) {
+        uint64_t pos = tail.load(std::memory_order_relaxed);
+        if (pos - head.load(std::memory_order_seq_cst) >= mask) return false;
+        // The slot's previous element (pos - slots, if any) is claimed; with eviction the
+        // consumer may still be copying it
+        if (evicting && pos > mask && copying.load(std::memory_order_seq_cst) == pos - mask - 1) return false;
+        buf[pos & mask] = value;
+        tail.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only
+    bool popSlot(T& out) {
+        uint64_t pos = head.load(std::memory_order_relaxed);
+        if (!evicting) {
+            if (pos == tail.load(std::memory_order_acquire)) return false;
+            out = buf[pos & mask];
+            head.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+        for (;;) {
+            if (pos == tail.load(std::memory_order_acquire)) {
+                copying.store(kNotCopying, std::memory_order_release);
+                return false;
+            }
+            copying.store(pos, std::memory_order_seq_cst);
+            if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                out = buf[pos & mask];
+                copying.store(kNotCopying, std::memory_order_release);
+                return true;
+            }
+            // Evicted by the producer: pos now holds the new head
+        }
+    }
+
     std::vector<T> buf;
     size_t mask;
-    std::atomic<size_t> head;
-    std::atomic<size_t> tail;
+    bool evicting = false;
+    std::atomic<uint64_t> head;
+    std::atomic<uint64_t> tail;
+    std::atomic<uint64_t> copying{kNotCopying}; // element the consumer is copying (eviction only)
     std::atomic<bool> closed;
-};
\ No newline at end of file
+};
@@ -28,4 +28,19 @@ inline uint64_t now_ns() {
         duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
 }
 
+// Sleep for ns: coarse sleep_for leaving ~2 us of headroom, then spin to the target.
+inline void hybrid_sleep_ns(uint64_t ns) {
+    using namespace std::chrono;
+    if (ns == 0) return;
+
+    auto target = steady_clock::now() + nanoseconds(ns);
+
+    constexpr uint64_t headroom_ns = 2000;
+    if (ns > headroom_ns)
+        std::this_thread::sleep_for(nanoseconds(ns - headroom_ns));
+
+    while (steady_clock::now() < target)
+        cpu_relax();
+}
+
 } // namespace util
\ No newline at end of file
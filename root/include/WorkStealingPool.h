@@ -0,0 +1,81 @@
+// WorkStealingPool: a fixed set of worker threads shared by many pipelines.
+// - Each worker owns a deque of tasks. A task submitted from a worker goes to that
+//   worker's deque; a task submitted from outside is spread round-robin.
+// - A worker runs its own tasks oldest-first (so tasks that resubmit themselves take
+//   turns rather than starving their neighbours) and, when its deque is empty, steals
+//   the newest task from another worker.
+// - Idle workers sleep on a condition variable instead of spinning. submit() only takes the
+//   sleep mutex to notify when a worker is actually asleep.
+// - submitAfter() queues a task on a timer; due timers are moved to the deques between tasks
+//   and by a worker that would otherwise sleep (which sleeps only until the earliest timer).
+// Pipeline::start(pool, ...) schedules each block as a self-resubmitting task that
+// processes one batch per run (see Block::step).
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ThreadPlacement.h"
+
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    // threads = 0 uses one worker per hardware thread. Every worker applies placement.
+    explicit WorkStealingPool(size_t threads = 0, const ThreadPlacement& placement = ThreadPlacement());
+
+    // Stops the workers; tasks still queued are dropped (stop the pipelines first).
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(Task task);
+
+    // Submits task once delay_ns has passed (later if every worker is busy with a long task).
+    void submitAfter(uint64_t delay_ns, Task task);
+
+    size_t size() const { return workers_.size(); }
+    uint64_t executed() const { return executed_.load(std::memory_order_relaxed); }
+    uint64_t steals() const { return steals_.load(std::memory_order_relaxed); }
+
+    // Index of the calling worker in this pool, or -1 from any other thread.
+    int currentWorker() const;
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void run(size_t index);
+    bool popLocal(size_t index, Task& out);
+    bool steal(size_t thief, Task& out);
+    void releaseDueTimers(uint64_t now);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+    ThreadPlacement placement_;
+
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    std::atomic<size_t> pending_{0};
+    std::atomic<size_t> sleepers_{0};   // workers inside wake_.wait
+    std::atomic<bool> stopping_{false};
+    std::atomic<size_t> nextWorker_{0};
+
+    std::mutex timerMutex_;
+    std::multimap<uint64_t, Task> timers_;              // due (util::now_ns) -> task
+    std::atomic<uint64_t> nextTimerNs_{UINT64_MAX};     // earliest due, UINT64_MAX = none
+
+    std::atomic<uint64_t> executed_{0};
+    std::atomic<uint64_t> steals_{0};
+};
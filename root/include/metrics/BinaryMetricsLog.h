@@ -0,0 +1,135 @@
+// BinaryMetricsLog: per-pair metrics as fixed-size records in a pre-sized, memory-mapped file.
+// - File = 64-byte header + capacity x 32-byte records (little-endian hosts: x86-64 / ARM64).
+// - recordPair() is one 32-byte store into the mapping plus a release store of the header
+//   count: no formatting, no syscalls. A full file counts drops instead of growing.
+// - Another process can tail the file while it is written: it maps the file, polls
+//   header.count (acquire) and reads records below it; header.state turns CLOSED at the end.
+// - On close the file is truncated to the records actually written (where the OS allows it).
+// - --metrics-convert / --metrics-summary / --metrics-tail read it back (see main.cpp).
+//
+// Timestamps are stored relative to pop_ts_ns in 32/16-bit fields that saturate
+// (generator age > 4.29 s, pop -> proc_start > 65 us, processing > 4.29 s).
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+#include "metrics/MetricsCollector.h"
+#include "metrics/MetricsCsv.h"
+#include "stream/MappedFile.h"
+
+struct BinaryMetricsHeader {
+    char magic[8];          // "CYNLRMET"
+    uint32_t version;       // 1
+    uint32_t recordSize;    // sizeof(BinaryPairRecord)
+    uint64_t capacity;      // record slots in the file
+    uint64_t count;         // records committed; written with release order
+    uint64_t dropped;       // records not logged because the file was full
+    uint32_t state;         // BinaryMetricsLog::WRITING / CLOSED
+    uint32_t reserved0;
+    uint64_t startNs;       // steady-clock time the log was opened
+    uint64_t shed;          // pairs deliberately not logged (deadline watchdog, --shed)
+};
+
+struct BinaryPairRecord {
+    uint64_t seq;
+    uint64_t pop_ts_ns;
+    uint32_t gen_age_ns;      // pop_ts - gen_ts
+    uint16_t start_delta_ns;  // proc_start - pop_ts
+    uint16_t flags;           // kGenValid | kOut0 | kOut1
+    uint32_t proc0_ns;
+    uint32_t proc1_ns;
+};
+
+static_assert(sizeof(BinaryMetricsHeader) == 64, "header layout");
+static_assert(sizeof(BinaryPairRecord) == 32, "record layout");
+
+class BinaryMetricsLog : public MetricsCollector {
+public:
+    enum : uint32_t { WRITING = 1, CLOSED = 2 };
+    enum : uint16_t { kGenValid = 1, kOut0 = 2, kOut1 = 4 };
+
+    // Creates (truncates) path sized for capacityRecords records. Check isOpen().
+    BinaryMetricsLog(const std::string& path, uint64_t capacityRecords);
+    ~BinaryMetricsLog() override;
+
+    BinaryMetricsLog(const BinaryMetricsLog&) = delete;
+    BinaryMetricsLog& operator=(const BinaryMetricsLog&) = delete;
+
+    bool isOpen() const { return header_ != nullptr; }
+
+    void recordPair(uint64_t seq,
+                    uint64_t gen_ts_ns,
+                    bool gen_ts_valid,
+                    uint64_t pop_ts_ns,
+                    uint64_t proc_start_ns,
+                    uint64_t out0_ts_ns,
+                    uint64_t out1_ts_ns,
+                    uint64_t queue_latency_ns,
+                    uint64_t proc0_ns,
+                    uint64_t proc1_ns,
+                    uint64_t inter_output_delta_ns) override;
+
+    void recordShed(uint64_t firstSeq, uint64_t lastSeq, uint64_t pairs) override;
+    void flush() override;
+    uint64_t droppedRecords() const override;
+    const char* dropReason() const override { return "log file full"; }
+
+    // Marks the log CLOSED, unmaps and trims the file (also done by the destructor).
+    void close();
+
+    static void decode(const BinaryPairRecord& r, MetricsRow& out);
+
+private:
+    std::string path_;
+    BinaryMetricsHeader* header_ = nullptr;
+    BinaryPairRecord* records_ = nullptr;
+    uint64_t capacity_ = 0;
+    uint64_t count_ = 0;     // owner copy of header_->count
+    size_t mappedBytes_ = 0;
+
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+// Read side: whole-file mapping; count()/closed() follow a live writer.
+class BinaryMetricsReader {
+public:
+    bool open(const std::string& path); // false (with a message) on a missing / foreign file
+
+    uint64_t count() const;             // committed records (acquire)
+    uint64_t dropped() const;
+    uint64_t shed() const;
+    bool closed() const;
+    uint64_t capacity() const { return header_ ? header_->capacity : 0; }
+
+    // Record i < count()
+    void row(uint64_t i, MetricsRow& out) const;
+
+private:
+    MappedFile file_;
+    const BinaryMetricsHeader* header_ = nullptr;
+    const BinaryPairRecord* records_ = nullptr;
+};
+
+struct MetricsSummary {
+    uint64_t records = 0;
+    uint64_t firstSeq = 0;
+    uint64_t lastSeq = 0;
+    uint64_t seqGaps = 0;           // jumps in seq (pairs dropped upstream)
+    uint64_t span_ns = 0;           // first -> last pop_ts
+    uint64_t queue_avg_ns = 0, queue_p50_ns = 0, queue_p99_ns = 0, queue_max_ns = 0;
+    uint64_t proc1_avg_ns = 0, proc1_p99_ns = 0, proc1_max_ns = 0;
+    uint64_t inter_max_ns = 0;
+};
+
+// Summary of records [from, to).
+MetricsSummary summarizeMetrics(const BinaryMetricsReader& reader, uint64_t from, uint64_t to);
+void printMetricsSummary(const MetricsSummary& s, uint64_t dropped, uint64_t shed = 0);
+
+// Writes pair_metrics.csv-format rows for every committed record (plus a "# shed" note).
+bool convertMetricsToCsv(const std::string& binPath, const std::string& csvPath, uint64_t& rows);
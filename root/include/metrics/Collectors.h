@@ -1,11 +1,19 @@
 
 #pragma once
 #include <string>
+#include <cstddef>
+#include <cstdint>
 #include "metrics/MetricsCollector.h"
 
 // Factory helpers implemented in src/metrics/*.cpp
 // CreateFileMetricsCollector returns a heap-allocated MetricsCollector* (caller owns and must delete).
-MetricsCollector * CreateFileMetricsCollector(const std::string & path);
+// recordPair copies a fixed-size record into a ring of ringRecords slots; a background thread
+// formats and writes the CSV. Records are dropped (and counted) if that writer falls behind.
+MetricsCollector * CreateFileMetricsCollector(const std::string & path, size_t ringRecords = 65536);
+
+// CreateBinaryMetricsLog returns a heap-allocated BinaryMetricsLog (see metrics/BinaryMetricsLog.h)
+// sized for capacityRecords 32-byte records, or nullptr if the file cannot be created and mapped.
+MetricsCollector* CreateBinaryMetricsLog(const std::string& path, uint64_t capacityRecords);
 
 // CreateNoopMetricsCollector returns a heap-allocated no-op MetricsCollector* (caller owns and must delete).
 MetricsCollector* CreateNoopMetricsCollector();
\ No newline at end of file
@@ -21,5 +21,16 @@ public:
                             uint64_t proc1_ns,
                             uint64_t inter_output_delta_ns) = 0;
 
+    // Pairs deliberately not recorded (deadline watchdog shedding), as one seq range per run,
+    // so the output shows the gap. Called before the next recorded pair or the final flush.
+    virtual void recordShed(uint64_t firstSeq, uint64_t lastSeq, uint64_t pairs) {
+        (void)firstSeq; (void)lastSeq; (void)pairs;
+    }
+
     virtual void flush() = 0;
+
+    // Records lost because the collector could not keep up (0 for collectors that never drop),
+    // and why, for the stats line ("writer fell behind", "log file full").
+    virtual uint64_t droppedRecords() const { return 0; }
+    virtual const char* dropReason() const { return "collector could not keep up"; }
 };
\ No newline at end of file
@@ -0,0 +1,29 @@
+// pair_metrics.csv row format, shared by FileMetricsCollector (--stats) and the binary log
+// converter (--metrics-convert) so both write byte-identical rows.
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// One pair's row, in column order.
+struct MetricsRow {
+    uint64_t seq = 0;
+    uint64_t gen_ts_ns = 0;
+    bool gen_ts_valid = false;
+    uint64_t pop_ts_ns = 0;
+    uint64_t proc_start_ns = 0;
+    uint64_t out0_ts_ns = 0;
+    uint64_t out1_ts_ns = 0;
+    uint64_t queue_latency_ns = 0;
+    uint64_t proc0_ns = 0;
+    uint64_t proc1_ns = 0;
+    uint64_t inter_output_delta_ns = 0;
+};
+
+// Header line, newline included
+extern const char kMetricsCsvHeader[];
+
+// Upper bound of one formatted row: 10 numbers + flag, separators, newline
+static constexpr size_t kMetricsCsvMaxRow = 11 * 21 + 1;
+
+// Formats r at p (room for kMetricsCsvMaxRow bytes); returns the end of the row.
+char* formatMetricsCsvRow(char* p, const MetricsRow& r);
@@ -0,0 +1,110 @@
+// MetricsSampler: which pairs FilterBlock hands to MetricsCollector::recordPair (--metrics-sample).
+//   all            every pair (default)
+//   every:<N>      one pair in N
+//   burst:<ms>[:<pairs>]
+//                  a burst of consecutive pairs (default 1000) every <ms> milliseconds
+//   tail:<ns>[:<pairs>]
+//                  only around slow pairs: when a pair's latency (generated -> second output)
+//                  exceeds <ns>, the <pairs> before it (default 64), the pair itself and the
+//                  <pairs> after it are recorded
+// The decision is made before any metrics work. every / burst cost a counter or a clock
+// compare per skipped pair; tail keeps the recent pairs in a preallocated ring (one record
+// copy per pair) and calls the collector only when a pair crosses the threshold.
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "metrics/MetricsCollector.h"
+
+enum class SamplingMode {
+    ALL,
+    EVERY_N,
+    BURST,
+    TAIL
+};
+
+struct SamplingPolicy {
+    SamplingMode mode = SamplingMode::ALL;
+    uint64_t everyN = 1;
+    uint64_t burstPeriod_ns = 0;
+    uint64_t burstPairs = 1000;
+    uint64_t tailThreshold_ns = 0;
+    uint64_t tailWindow = 64;
+};
+
+// "all", "every:<N>", "burst:<ms>[:<pairs>]" or "tail:<ns>[:<pairs>]"; false (with a message) otherwise
+bool parseSamplingSpec(const std::string& spec, SamplingPolicy& out);
+std::string samplingPolicyName(const SamplingPolicy& policy);
+
+// One pair's recordPair arguments
+struct PairMetrics {
+    uint64_t seq;
+    uint64_t gen_ts_ns;
+    bool gen_ts_valid;
+    uint64_t pop_ts_ns;
+    uint64_t proc_start_ns;
+    uint64_t out0_ts_ns;
+    uint64_t out1_ts_ns;
+    uint64_t queue_latency_ns;
+    uint64_t proc0_ns;
+    uint64_t proc1_ns;
+    uint64_t inter_output_delta_ns;
+
+    void recordTo(MetricsCollector& m) const {
+        m.recordPair(seq, gen_ts_ns, gen_ts_valid, pop_ts_ns, proc_start_ns, out0_ts_ns, out1_ts_ns,
+                     queue_latency_ns, proc0_ns, proc1_ns, inter_output_delta_ns);
+    }
+};
+
+class MetricsSampler {
+public:
+    void configure(const SamplingPolicy& policy);
+    const SamplingPolicy& policy() const { return policy_; }
+
+    // Whether the pair at now_ns needs a PairMetrics at all (false: skip it, nothing else to do)
+    bool wants(uint64_t now_ns) {
+        ++seen_;
+        switch (policy_.mode) {
+        case SamplingMode::ALL:
+        case SamplingMode::TAIL:
+            return true;
+        case SamplingMode::EVERY_N:
+            if (--countdown_ > 0) return false;
+            countdown_ = policy_.everyN;
+            return true;
+        case SamplingMode::BURST:
+            if (burstLeft_ > 0) { --burstLeft_; return true; }
+            if (now_ns < nextBurst_ns_) return false;
+            nextBurst_ns_ = now_ns + policy_.burstPeriod_ns;
+            burstLeft_ = policy_.burstPairs - 1;
+            return true;
+        }
+        return true;
+    }
+
+    // Hands a wanted pair to out (TAIL: buffers it, or records the window around a slow pair)
+    void submit(const PairMetrics& p, MetricsCollector& out);
+
+    uint64_t seen() const { return seen_; }
+    uint64_t recorded() const { return recorded_; }
+    uint64_t triggers() const { return triggers_; }
+
+    void printStats() const;
+
+private:
+    SamplingPolicy policy_;
+    uint64_t countdown_ = 1;
+    uint64_t nextBurst_ns_ = 0;
+    uint64_t burstLeft_ = 0;
+
+    // TAIL: the last tailWindow pairs not yet recorded, oldest at ringHead_ - ringSize_
+    std::vector<PairMetrics> ring_;
+    size_t ringHead_ = 0;
+    size_t ringSize_ = 0;
+    uint64_t postLeft_ = 0;   // pairs still to record after the last trigger
+
+    uint64_t seen_ = 0;
+    uint64_t recorded_ = 0;
+    uint64_t triggers_ = 0;
+};
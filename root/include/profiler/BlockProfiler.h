@@ -3,24 +3,39 @@
 #include <vector>
 #include <cstdint>
 #include <string>
-#include <limits>
 #include <algorithm>
 #include <iostream>
 
+#include "profiler/LatencyHistogram.h"
+
 // Lightweight per-block profiler (no mutexes, per-instance)
+// Samples go into a fixed-size LatencyHistogram: O(1), no allocation, bounded memory,
+// percentiles without sorting. Keeping every raw sample (exact percentiles, getSamples())
+// is opt-in via setRawSamples(true); that vector grows with the run.
 class BlockProfiler {
 public:
-    explicit BlockProfiler(const std::string& blockName, size_t reserveSize = 100000)
+    explicit BlockProfiler(const std::string& blockName,
+                           unsigned precisionBits = LatencyHistogram::kDefaultSubBucketBits)
         : name_(blockName),
           blockStartTimeNs_(0),
           totalExecutionTimeNs_(0),
-          totalSamples_(0),
-          sumNs_(0),
-          minNs_(std::numeric_limits<uint64_t>::max()),
-          maxNs_(0)
-    {
-        samples_.reserve(reserveSize);
+          histogram_(precisionBits)
+    {}
+
+    // Histogram precision (sub-bucket bits, see LatencyHistogram) and raw-sample mode.
+    // Clears all recorded data; call before the block starts.
+    void configure(unsigned precisionBits, bool rawSamples, size_t reserveSize = 100000) {
+        histogram_ = LatencyHistogram(precisionBits);
+        setRawSamples(rawSamples, reserveSize);
+        reset();
+    }
+
+    void setRawSamples(bool on, size_t reserveSize = 100000) {
+        raw_ = on;
+        if (on) samples_.reserve(reserveSize);
+        else std::vector<uint64_t>().swap(samples_);
     }
+    bool rawSamples() const { return raw_; }
 
     // Start block timer (call at block start)
     void startBlock(uint64_t timestamp) {
@@ -36,11 +51,17 @@ public:
 
     // Record a single sample (per-pair, per-operation, etc.)
     void recordSample(uint64_t ns) {
-        totalSamples_++;
-        sumNs_ += ns;
-        if (ns < minNs_) minNs_ = ns;
-        if (ns > maxNs_) maxNs_ = ns;
-        samples_.push_back(ns);
+        histogram_.record(ns);
+        if (raw_) samples_.push_back(ns);
+    }
+
+    // Adds another profiler's samples and execution time (another block, or an earlier run).
+    // False if the histogram precisions differ.
+    bool merge(const BlockProfiler& other) {
+        if (!histogram_.merge(other.histogram_)) return false;
+        totalExecutionTimeNs_ += other.totalExecutionTimeNs_;
+        if (raw_) samples_.insert(samples_.end(), other.samples_.begin(), other.samples_.end());
+        return true;
     }
 
     // Get statistics
@@ -58,66 +79,76 @@ public:
 
     Stats getStats() const {
         Stats stats = {};
-        stats.count = totalSamples_;
-        stats.avg_ns = totalSamples_ ? (sumNs_ / totalSamples_) : 0;
-        stats.min_ns = (minNs_ == std::numeric_limits<uint64_t>::max()) ? 0 : minNs_;
-        stats.max_ns = maxNs_;
+        stats.count = histogram_.count();
+        stats.avg_ns = histogram_.avg();
+        stats.min_ns = histogram_.min();
+        stats.max_ns = histogram_.max();
         stats.execution_time_ms = totalExecutionTimeNs_ / 1e6;
-        stats.throughput_per_sec = totalExecutionTimeNs_ > 0 
-            ? (totalSamples_ * 1e9) / totalExecutionTimeNs_ 
+        stats.throughput_per_sec = totalExecutionTimeNs_ > 0
+            ? (stats.count * 1e9) / totalExecutionTimeNs_
             : 0;
 
-        if (!samples_.empty()) {
+        if (raw_ && !samples_.empty()) {
+            // Exact percentiles from the raw samples (copy + sort)
             std::vector<uint64_t> sorted = samples_;
             std::sort(sorted.begin(), sorted.end());
             size_t n = sorted.size();
-            
+
             stats.median_ns = sorted[n / 2];
             stats.p95_ns = sorted[n * 95 / 100];
             stats.p99_ns = sorted[n * 99 / 100];
         } else {
-            stats.median_ns = stats.p95_ns = stats.p99_ns = 0;
+            stats.median_ns = histogram_.percentile(0.50);
+            stats.p95_ns = histogram_.percentile(0.95);
+            stats.p99_ns = histogram_.percentile(0.99);
         }
 
         return stats;
     }
 
+    // Any quantile q in [0, 1] from the histogram (within its precision)
+    uint64_t percentile(double q) const {
+        return histogram_.percentile(q);
+    }
+
     // Print statistics to console
     void printStats() const {
         auto stats = getStats();
-        
+
         std::cout << "---- " << name_ << " Statistics ----\n";
         std::cout << "Samples: " << stats.count << "\n";
-        
+
         if (stats.execution_time_ms > 0) {
             std::cout << "Total execution time: " << stats.execution_time_ms << " ms\n";
             std::cout << "Throughput: " << stats.throughput_per_sec << " samples/sec\n";
         }
-        
+
         if (stats.count > 0) {
             std::cout << "Timing (ns): avg=" << stats.avg_ns
                       << " min=" << stats.min_ns
                       << " max=" << stats.max_ns
                       << " p50=" << stats.median_ns
                       << " p95=" << stats.p95_ns
-                      << " p99=" << stats.p99_ns << "\n";
+                      << " p99=" << stats.p99_ns
+                      << " p99.9=" << percentile(0.999) << "\n";
         }
-        
+
         std::cout << "--------------------------------\n";
     }
 
     // Clear all data (for multi-run scenarios)
     void reset() {
+        histogram_.reset();
         samples_.clear();
-        totalSamples_ = 0;
-        sumNs_ = 0;
-        minNs_ = std::numeric_limits<uint64_t>::max();
-        maxNs_ = 0;
         blockStartTimeNs_ = 0;
         totalExecutionTimeNs_ = 0;
     }
 
-    // Get raw samples (for custom analysis)
+    const LatencyHistogram& histogram() const {
+        return histogram_;
+    }
+
+    // Get raw samples (for custom analysis); empty unless setRawSamples(true)
     const std::vector<uint64_t>& getSamples() const {
         return samples_;
     }
@@ -126,9 +157,7 @@ private:
     std::string name_;
     uint64_t blockStartTimeNs_;
     uint64_t totalExecutionTimeNs_;
-    uint64_t totalSamples_;
-    uint64_t sumNs_;
-    uint64_t minNs_;
-    uint64_t maxNs_;
+    LatencyHistogram histogram_;
+    bool raw_ = false;
     std::vector<uint64_t> samples_;
-};
\ No newline at end of file
+};
@@ -0,0 +1,128 @@
+// LatencyHistogram: fixed-size log-linear (HDR-style) histogram for nanosecond values.
+// - 2^subBucketBits linear sub-buckets per power of two: relative error <= 2^-subBucketBits
+//   (5 bits ~3%, 7 bits ~0.8%, 10 bits ~0.1%). Values below 2^subBucketBits are exact.
+// - Memory is fixed at construction ((65 - bits) << bits counters, 15 KiB at 5 bits), so
+//   arbitrarily long runs need no per-sample storage; record() is O(1) and never allocates.
+// - count/sum/min/max are exact; percentile() walks the buckets, no sort.
+// - Histograms of the same precision merge() (blocks, pipelines, repeated runs).
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <algorithm>
+
+#ifdef _MSC_VER
+# include <intrin.h>
+#endif
+
+class LatencyHistogram {
+public:
+    static constexpr unsigned kDefaultSubBucketBits = 5;
+    static constexpr unsigned kMinSubBucketBits = 1;
+    static constexpr unsigned kMaxSubBucketBits = 12;
+
+    explicit LatencyHistogram(unsigned subBucketBits = kDefaultSubBucketBits)
+        : subBits_(std::min(std::max(subBucketBits, kMinSubBucketBits), kMaxSubBucketBits)),
+          buckets_(bucketCount(subBits_), 0)
+    {}
+
+    void record(uint64_t v) {
+        ++buckets_[index(v)];
+        ++count_;
+        sum_ += v;
+        if (v < min_) min_ = v;
+        if (v > max_) max_ = v;
+    }
+
+    // Adds other's samples. False (nothing merged) if the precisions differ.
+    bool merge(const LatencyHistogram& other) {
+        if (other.subBits_ != subBits_) return false;
+        for (size_t i = 0; i < buckets_.size(); ++i) buckets_[i] += other.buckets_[i];
+        count_ += other.count_;
+        sum_ += other.sum_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+        return true;
+    }
+
+    void reset() {
+        std::fill(buckets_.begin(), buckets_.end(), 0);
+        count_ = 0;
+        sum_ = 0;
+        min_ = std::numeric_limits<uint64_t>::max();
+        max_ = 0;
+    }
+
+    unsigned subBucketBits() const { return subBits_; }
+    size_t memoryBytes() const { return buckets_.size() * sizeof(uint64_t); }
+
+    uint64_t count() const { return count_; }
+    uint64_t sum() const { return sum_; }
+    uint64_t avg() const { return count_ ? sum_ / count_ : 0; }
+    uint64_t min() const { return count_ ? min_ : 0; }
+    uint64_t max() const { return max_; }
+
+    // Upper edge of the bucket holding the q-quantile, capped at the exact max.
+    uint64_t percentile(double q) const {
+        return percentileOf(buckets_.data(), subBits_, count_, min(), max_, q);
+    }
+
+    // Bucket math, shared with fixed-size histograms (see profiler/LiveStats.h)
+    static constexpr size_t bucketCount(unsigned subBucketBits) {
+        return static_cast<size_t>(65 - subBucketBits) << subBucketBits;
+    }
+
+    static size_t bucketIndex(uint64_t v, unsigned subBucketBits) {
+        const uint64_t sub = uint64_t(1) << subBucketBits;
+        if (v < sub) return static_cast<size_t>(v);
+        unsigned shift = msb(v) - subBucketBits;
+        return static_cast<size_t>((shift + 1) * sub + ((v >> shift) & (sub - 1)));
+    }
+
+    static uint64_t bucketUpper(size_t i, unsigned subBucketBits) {
+        const uint64_t sub = uint64_t(1) << subBucketBits;
+        if (i < sub) return i;
+        unsigned shift = static_cast<unsigned>(i / sub) - 1;
+        uint64_t base = (sub + (i % sub)) << shift;
+        return base + ((uint64_t(1) << shift) - 1);
+    }
+
+    // q-quantile of bucketCount(subBucketBits) counters holding count values in [min, max]
+    static uint64_t percentileOf(const uint64_t* buckets, unsigned subBucketBits,
+                                 uint64_t count, uint64_t min, uint64_t max, double q) {
+        if (count == 0) return 0;
+        if (q <= 0.0) return min;
+        if (q > 1.0) q = 1.0;
+        uint64_t rank = static_cast<uint64_t>(q * (count - 1)) + 1;
+        uint64_t seen = 0;
+        const size_t n = bucketCount(subBucketBits);
+        for (size_t i = 0; i < n; ++i) {
+            seen += buckets[i];
+            if (seen >= rank) return std::max(std::min(bucketUpper(i, subBucketBits), max), min);
+        }
+        return max;
+    }
+
+private:
+    static unsigned msb(uint64_t v) {
+#ifdef _MSC_VER
+        unsigned long i;
+        _BitScanReverse64(&i, v);
+        return static_cast<unsigned>(i);
+#else
+        return 63u - static_cast<unsigned>(__builtin_clzll(v));
+#endif
+    }
+
+    size_t index(uint64_t v) const {
+        return bucketIndex(v, subBits_);
+    }
+
+    unsigned subBits_;
+    std::vector<uint64_t> buckets_;
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t min_ = std::numeric_limits<uint64_t>::max();
+    uint64_t max_ = 0;
+};
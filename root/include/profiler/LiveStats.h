@@ -0,0 +1,136 @@
+// LiveStats: per-block counters and histograms that a reporter thread can read while the
+// block runs (see StatsReporter.h).
+// - The owning worker updates a private LiveBlockStats (histogram record() per item) and
+//   publishes a copy into a SeqLock at most every publish interval (default 1 ms), so the
+//   hot path pays one bucket increment and one time comparison per item.
+// - Readers copy the published value and retry if the writer was mid-publish, so every
+//   snapshot is internally consistent (no torn counters, no locks on either side).
+// - All counters are cumulative; the reporter differences two snapshots for an interval.
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "profiler/LatencyHistogram.h"
+#include "profiler/PerfCounters.h"
+
+// Single-writer sequence lock over a trivially copyable T.
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock copies T bytewise");
+public:
+    SeqLock() { std::memset(&data_, 0, sizeof(T)); }
+
+    // Writer only. seq_ is odd while the copy is in progress.
+    void store(const T& value) {
+        uint64_t s = seq_.load(std::memory_order_relaxed);
+        seq_.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&data_, &value, sizeof(T));
+        seq_.store(s + 2, std::memory_order_release);
+    }
+
+    // Any thread. Spins only while a store overlaps the copy.
+    void load(T& out) const {
+        while (true) {
+            uint64_t before = seq_.load(std::memory_order_acquire);
+            if (before & 1) continue;
+            std::memcpy(&out, &data_, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == before) return;
+        }
+    }
+
+    uint64_t version() const { return seq_.load(std::memory_order_acquire) / 2; }
+
+private:
+    std::atomic<uint64_t> seq_{0};
+    T data_;
+};
+
+// Fixed-size (POD) log-linear histogram: 4 sub-bucket bits (~6%), 7.6 KiB.
+struct LiveHistogram {
+    static constexpr unsigned kBits = 4;
+    static constexpr size_t kBuckets = LatencyHistogram::bucketCount(kBits);
+
+    uint64_t buckets[kBuckets];
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+
+    void record(uint64_t v) {
+        ++buckets[LatencyHistogram::bucketIndex(v, kBits)];
+        ++count;
+        sum += v;
+        if (v > max) max = v;
+    }
+
+    // Values recorded since `earlier` (a previous snapshot of the same histogram).
+    // The interval max is the top of its highest bucket, capped at the running max.
+    void since(const LiveHistogram& earlier, LiveHistogram& out) const {
+        out.count = count - earlier.count;
+        out.sum = sum - earlier.sum;
+        out.max = 0;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            out.buckets[i] = buckets[i] - earlier.buckets[i];
+            if (out.buckets[i]) out.max = LatencyHistogram::bucketUpper(i, kBits);
+        }
+        if (out.max > max) out.max = max;
+    }
+
+    uint64_t avg() const { return count ? sum / count : 0; }
+    uint64_t percentile(double q) const {
+        return LatencyHistogram::percentileOf(buckets, kBits, count, 0, max, q);
+    }
+};
+
+// One block's cumulative live counters. Fields a block does not track stay 0.
+struct LiveBlockStats {
+    uint64_t published_ns;    // block clock at publish time
+    uint64_t items;           // pairs produced (generator) / processed (filter)
+    uint64_t outputs;         // filter outputs
+    uint64_t dropped;         // generator: overload drops; filter: pairs missing upstream
+    uint64_t deadlineMisses;  // over all of the block's DeadlineMonitors
+    uint64_t stall_ns;        // generator: queue full; filter: input empty
+    uint64_t busy_ns;         // worker busy / idle time (profiler/Utilization.h)
+    uint64_t idle_ns;
+    uint64_t queueDepthSum;   // occupancy samples (one per item) and their count
+    uint64_t queueSamples;
+    uint64_t queueDepth;      // last sample
+    uint64_t queueCapacity;
+    LiveHistogram latency;    // filter: generator stamp -> processing start
+    LiveHistogram service;    // per-item time: generator produce + push, filter per output
+    PerfSample perf;          // worker-thread counters since it started (--perf-counters)
+};
+
+class LiveStatsPublisher {
+public:
+    LiveStatsPublisher() { std::memset(&work_, 0, sizeof(work_)); }
+
+    LiveStatsPublisher(const LiveStatsPublisher&) = delete;
+    LiveStatsPublisher& operator=(const LiveStatsPublisher&) = delete;
+
+    // Off by default; enable before the block starts (interval_ns = 0 disables).
+    void enable(uint64_t interval_ns) { interval_ = interval_ns; }
+    bool enabled() const { return interval_ != 0; }
+
+    // Owner thread: per-item updates go here, then maybe publish.
+    LiveBlockStats& working() { return work_; }
+    bool due(uint64_t now) const { return now - last_ >= interval_; }
+    void publish(uint64_t now) {
+        work_.published_ns = now;
+        slot_.store(work_);
+        last_ = now;
+    }
+
+    // Any thread
+    void read(LiveBlockStats& out) const { slot_.load(out); }
+    uint64_t publishes() const { return slot_.version(); }
+
+private:
+    uint64_t interval_ = 0;
+    uint64_t last_ = 0;
+    LiveBlockStats work_;
+    SeqLock<LiveBlockStats> slot_;
+};
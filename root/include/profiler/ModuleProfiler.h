@@ -0,0 +1,101 @@
+// ModuleProfiler: named timers and counters for a per-function cost breakdown, written as
+// module_profile.csv (module,metric,count,avg_ns,min_ns,max_ns,median_ns,p90_ns,p99_ns,p999_ns).
+// - Each instrumented site registers its name once (a function-local static behind the
+//   CYNLR_PROFILE_* macros) and gets a small index; sites with the same name share an entry.
+// - Every thread records into its own slots (a LatencyHistogram per timer, a plain counter
+//   per counter): no atomics or locks per sample. The registry keeps the slots after their
+//   thread exits and merges them when the report is written.
+// - Off until enable(true) (--module-profile): a disabled site costs one relaxed load.
+// enable(), reset() and the report run while no instrumented worker thread is running.
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Util.h"
+#include "profiler/LatencyHistogram.h"
+
+class ModuleProfiler {
+public:
+    enum class Kind { TIMING, COUNTER };
+
+    struct Entry {
+        std::string name;
+        Kind kind;
+        LatencyHistogram timing;   // TIMING: merged over threads
+        uint64_t count;            // COUNTER: summed over threads
+    };
+
+    static void enable(bool on) { enabled_.store(on, std::memory_order_release); }
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // Index of the named site (the same name always maps to the same index).
+    static uint32_t registerSite(const char* name, Kind kind);
+
+    static void record(uint32_t site, uint64_t ns);
+    static void add(uint32_t site, uint64_t n);
+
+    // Drops every thread's samples (registered names stay).
+    static void reset();
+
+    // Merged view: timers first, then counters, each sorted by name; sites never hit are left out.
+    static std::vector<Entry> snapshot();
+    static bool writeCsv(const std::string& path);
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+class ModuleTimer {
+public:
+    explicit ModuleTimer(const char* name)
+        : site_(ModuleProfiler::registerSite(name, ModuleProfiler::Kind::TIMING)) {}
+    void record(uint64_t ns) const {
+        if (ModuleProfiler::enabled()) ModuleProfiler::record(site_, ns);
+    }
+
+private:
+    uint32_t site_;
+};
+
+class ModuleCounter {
+public:
+    explicit ModuleCounter(const char* name)
+        : site_(ModuleProfiler::registerSite(name, ModuleProfiler::Kind::COUNTER)) {}
+    void add(uint64_t n) const {
+        if (ModuleProfiler::enabled()) ModuleProfiler::add(site_, n);
+    }
+
+private:
+    uint32_t site_;
+};
+
+// Times the enclosing scope into a ModuleTimer
+class ModuleScope {
+public:
+    explicit ModuleScope(const ModuleTimer& timer)
+        : timer_(timer), start_(ModuleProfiler::enabled() ? util::now_ns() : 0) {}
+    ~ModuleScope() {
+        if (start_) timer_.record(util::now_ns() - start_);
+    }
+
+    ModuleScope(const ModuleScope&) = delete;
+    ModuleScope& operator=(const ModuleScope&) = delete;
+
+private:
+    const ModuleTimer& timer_;
+    uint64_t start_;
+};
+
+#define CYNLR_PROFILE_CONCAT_(a, b) a##b
+#define CYNLR_PROFILE_CONCAT(a, b) CYNLR_PROFILE_CONCAT_(a, b)
+// Time from here to the end of the enclosing scope under "Module.function"
+#define CYNLR_PROFILE_SCOPE(name) \
+    static const ModuleTimer CYNLR_PROFILE_CONCAT(moduleTimer_, __LINE__)(name); \
+    ModuleScope CYNLR_PROFILE_CONCAT(moduleScope_, __LINE__)(CYNLR_PROFILE_CONCAT(moduleTimer_, __LINE__))
+// Record a duration the caller already measured
+#define CYNLR_PROFILE_RECORD(name, ns) \
+    do { static const ModuleTimer moduleTimer_(name); moduleTimer_.record(ns); } while (0)
+#define CYNLR_PROFILE_COUNT(name, n) \
+    do { static const ModuleCounter moduleCounter_(name); moduleCounter_.add(n); } while (0)
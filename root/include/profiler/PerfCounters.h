@@ -0,0 +1,93 @@
+// PerfCounters: per-thread hardware counters (Linux perf_event_open) for one block's worker.
+// - One counter group (cycles leader + instructions, L1D read misses, LLC misses, branch
+//   misses), user-space only so perf_event_paranoid <= 2 suffices; read together so ratios
+//   such as IPC are consistent. Multiplexed groups are scaled by enabled / running time.
+// - Context switches come from getrusage(RUSAGE_THREAD) and need no permission.
+// - Events the CPU / VM / kernel do not offer are left out; if no hardware counter opens
+//   (no PMU, paranoid > 2, other platforms) the set degrades to context switches only and
+//   status() says why. Nothing here ever fails a run.
+// open() and read() must run on the measured thread.
+#pragma once
+#include <cstdint>
+#include <string>
+
+enum PerfEvent {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_CONTEXT_SWITCHES,
+    kPerfEventCount
+};
+
+struct PerfSample {
+    uint64_t value[kPerfEventCount];
+    uint64_t running_ns;   // time the hardware group was counting (on-CPU time)
+    uint32_t mask;         // bit e set = value[e] valid
+
+    bool has(int e) const { return (mask >> e) & 1u; }
+};
+
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // Opens the counters for the calling thread. On Linux this always returns true: context
+    // switches (getrusage) need no perf_event_open, so a set with no hardware counter still
+    // counts; mask() / status() tell what opened. Returns false on other platforms.
+    bool open();
+    void close();
+
+    bool isOpen() const { return mask_ != 0; }
+    uint32_t mask() const { return mask_; }
+    const std::string& status() const { return status_; }
+
+    bool read(PerfSample& out) const;
+
+    static const char* eventName(int e);
+
+private:
+    int fds_[kPerfEventCount];
+    uint64_t ids_[kPerfEventCount];
+    int leader_ = -1;
+    uint32_t mask_ = 0;
+    std::string status_;
+};
+
+// end - start (events valid in both)
+PerfSample perfDelta(const PerfSample& end, const PerfSample& start);
+
+// "Perf counters per pixel: cycles=.. instr=.. (IPC ..) L1D-miss=.. ..." for a block's run
+void printPerfPerPixel(const PerfSample& delta, uint64_t pixels);
+
+// A block worker's counters: begin() at the top of its thread, end() before it returns.
+class BlockPerf {
+public:
+    void enable(bool on) { enabled_ = on; }
+    bool enabled() const { return enabled_; }
+
+    // Pooled blocks run on shared workers, so per-thread counters do not apply.
+    void markPooled() { pooled_ = true; }
+
+    void begin();
+    void end();
+
+    // Cumulative values: live on the worker thread, the final ones after end().
+    bool sample(PerfSample& out) const;
+
+    // Per-pixel figures for printStats (or why there are none)
+    void print(uint64_t pixels) const;
+
+private:
+    bool enabled_ = false;
+    bool pooled_ = false;
+    bool ended_ = false;
+    PerfCounters counters_;
+    PerfSample start_{};
+    PerfSample end_{};
+};
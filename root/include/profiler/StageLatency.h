@@ -0,0 +1,73 @@
+// StageLatency: where a pair's end-to-end latency went, stage by stage.
+// A pair carries two 32-bit stamps from the producer (DataPair::pace_late_ns,
+// enq_delta_ns); the consumer adds dequeue, filtered and emitted times and records
+//   pace    - scheduled release -> generated (sleep overshoot / replay lateness)
+//   push    - generated -> enqueued (backpressure: waiting on a full queue)
+//   queue   - enqueued -> dequeued
+//   compute - dequeued -> both of the pair's samples pushed through the filter
+//   output  - filtered -> the pair's own outputs emitted (FIR lookahead: later pairs needed)
+// The stages add up to the end-to-end time. Besides a histogram per stage, the mean of
+// every stage is kept per end-to-end bucket, so the tail (e.g. >= p99) can be broken down
+// into the stages that caused it.
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "profiler/LatencyHistogram.h"
+
+enum LatencyStage {
+    STAGE_PACE,
+    STAGE_PUSH,
+    STAGE_QUEUE,
+    STAGE_COMPUTE,
+    STAGE_OUTPUT,
+    kStageCount
+};
+
+// Saturating 32-bit stamp of t relative to base (~4.3 s range; earlier times clamp to 0)
+inline uint32_t stageDelta(uint64_t base, uint64_t t)
+{
+    if (t <= base) return 0;
+    uint64_t d = t - base;
+    return d > 0xFFFFFFFFull ? 0xFFFFFFFFu : static_cast<uint32_t>(d);
+}
+
+// One pair's stamps while the consumer waits for its outputs; deltas from gen_ns
+struct PairStages {
+    uint64_t gen_ns = 0;
+    uint32_t pace = 0;       // before gen_ns
+    uint32_t enq = 0;
+    uint32_t deq = 0;
+    uint32_t filtered = 0;
+    bool valid = false;
+};
+
+class StageLatency {
+public:
+    explicit StageLatency(unsigned precisionBits = LatencyHistogram::kDefaultSubBucketBits);
+
+    void record(const PairStages& p, uint64_t emitted_ns);
+
+    const LatencyHistogram& stage(int s) const { return stages_[s]; }
+    const LatencyHistogram& endToEnd() const { return endToEnd_; }
+    uint64_t count() const { return endToEnd_.count(); }
+
+    bool merge(const StageLatency& other);
+    void reset();
+
+    // Mean ns per stage over the pairs whose end-to-end time is at or above the
+    // q-quantile (bucket resolution); returns how many pairs that covers.
+    uint64_t tailBreakdown(double q, double (&mean_ns)[kStageCount], uint64_t& threshold_ns) const;
+
+    void printStats() const;
+
+    static const char* stageName(int s);
+
+private:
+    static constexpr unsigned kTailBits = 4;   // end-to-end buckets of the tail table (~6%)
+
+    LatencyHistogram stages_[kStageCount];
+    LatencyHistogram endToEnd_;
+    std::vector<uint64_t> tailCount_;   // [e2e bucket]
+    std::vector<uint64_t> tailSum_;     // [e2e bucket * kStageCount + stage]
+};
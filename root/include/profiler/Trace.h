@@ -0,0 +1,124 @@
+// Trace: a timeline of what every pipeline thread was doing, written as Chrome trace-event
+// JSON (open in chrome://tracing or ui.perfetto.dev).
+// - The CYNLR_TRACE_* macros below record only in builds with CYNLR_ENABLE_TRACING; without
+//   it they expand to nothing and their arguments are not evaluated.
+// - When compiled in, recording is still off until Tracer::start() (--trace=<file>); the
+//   per-event check is one relaxed load.
+// - Each thread appends fixed-size records to its own buffer: single writer, no locks and
+//   no allocation after the thread's first event. A full buffer counts drops instead of
+//   growing. Buffers outlive their threads, so writeChromeJson() runs after the pipeline
+//   has stopped. start() discards earlier buffers: call it while no traced thread runs.
+// Event names must be string literals (only the pointer is stored).
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "Util.h"
+
+struct TraceEvent {
+    const char* name;
+    uint64_t ts_ns;      // start (steady clock, util::now_ns)
+    uint64_t dur_ns;     // complete events
+    int64_t value;       // counter events
+    char phase;          // 'X' complete, 'C' counter, 'i' instant
+};
+
+class TraceBuffer {
+public:
+    TraceBuffer(size_t capacity, uint32_t tid);
+
+    // Owning thread only
+    void push(const TraceEvent& e) {
+        size_t n = count_.load(std::memory_order_relaxed);
+        if (n == capacity_) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        events_[n] = e;
+        count_.store(n + 1, std::memory_order_release);
+    }
+
+    size_t size() const { return count_.load(std::memory_order_acquire); }
+    const TraceEvent& operator[](size_t i) const { return events_[i]; }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    uint32_t tid() const { return tid_; }
+
+    std::string threadName;
+
+private:
+    std::unique_ptr<TraceEvent[]> events_;   // left uninitialised: pages are touched as used
+    size_t capacity_;
+    uint32_t tid_;
+    std::atomic<size_t> count_{0};
+    std::atomic<uint64_t> dropped_{0};
+};
+
+class Tracer {
+public:
+    // True in builds with CYNLR_ENABLE_TRACING (the macros record nothing otherwise).
+    static bool compiledIn();
+
+    // Discards earlier events and starts recording; eventsPerThread bounds each buffer.
+    static void start(size_t eventsPerThread = kDefaultEventsPerThread);
+    static void stop();
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    static void complete(const char* name, uint64_t start_ns, uint64_t end_ns);
+    static void counter(const char* name, int64_t value);
+    static void instant(const char* name);
+    static void setThreadName(const char* name);
+
+    static uint64_t eventCount();
+    static uint64_t droppedCount();
+
+    // Chrome trace-event JSON ({"traceEvents":[...]}); false if the file cannot be written.
+    static bool writeChromeJson(const std::string& path);
+
+    static constexpr size_t kDefaultEventsPerThread = 1 << 20;   // 40 MiB of address space
+
+private:
+    static TraceBuffer* threadBuffer();
+
+    static std::atomic<bool> enabled_;
+};
+
+// Complete event over the enclosing scope
+class TraceScope {
+public:
+    explicit TraceScope(const char* name)
+        : name_(name), start_(Tracer::enabled() ? util::now_ns() : 0) {}
+    ~TraceScope() {
+        if (start_) Tracer::complete(name_, start_, util::now_ns());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;
+    uint64_t start_;
+};
+
+#ifdef CYNLR_ENABLE_TRACING
+# define CYNLR_TRACE_CONCAT_(a, b) a##b
+# define CYNLR_TRACE_CONCAT(a, b) CYNLR_TRACE_CONCAT_(a, b)
+// Complete event from here to the end of the enclosing scope
+# define CYNLR_TRACE_SCOPE(name) TraceScope CYNLR_TRACE_CONCAT(traceScope_, __LINE__)(name)
+// Complete event from timestamps the caller already has (util::now_ns clock)
+# define CYNLR_TRACE_SPAN(name, start_ns, end_ns) \
+    do { if (Tracer::enabled()) Tracer::complete(name, start_ns, end_ns); } while (0)
+# define CYNLR_TRACE_COUNTER(name, value) \
+    do { if (Tracer::enabled()) Tracer::counter(name, static_cast<int64_t>(value)); } while (0)
+# define CYNLR_TRACE_INSTANT(name) \
+    do { if (Tracer::enabled()) Tracer::instant(name); } while (0)
+# define CYNLR_TRACE_THREAD_NAME(name) \
+    do { if (Tracer::enabled()) Tracer::setThreadName(name); } while (0)
+#else
+# define CYNLR_TRACE_SCOPE(name) ((void)0)
+# define CYNLR_TRACE_SPAN(name, start_ns, end_ns) ((void)0)
+# define CYNLR_TRACE_COUNTER(name, value) ((void)0)
+# define CYNLR_TRACE_INSTANT(name) ((void)0)
+# define CYNLR_TRACE_THREAD_NAME(name) ((void)0)
+#endif
@@ -0,0 +1,84 @@
+// UtilizationMeter: how much of a worker's time went to useful work.
+// The workers never block in the OS while they wait (try_pop / try_push + cpu_relax, hybrid
+// sleeps), so OS CPU usage reads 100% whatever the load. The meter instead splits the block's
+// wall time into busy (producing / filtering a pair) and idle (pacing sleep, waiting on a full
+// output or an empty input) from a timestamp at each state change:
+//   utilization = busy / (busy + idle)
+// which is the share of a core the block really needs (1 / utilization such blocks fit on one).
+// - Transitions reuse timestamps the block already takes; marking the state it is already
+//   in is one compare. Intervals that would run backwards (clock mix-ups) count as 0.
+// - The meter starts at the first busy() and stops at stop(); time before the first pair
+//   (start-up, waiting for input) is not counted.
+// Single-threaded: the owning worker updates it, others read the published copy (LiveStats.h).
+#pragma once
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+
+class UtilizationMeter {
+public:
+    void busy(uint64_t now) {
+        if (state_ == BUSY) return;
+        if (state_ == IDLE) idle_ += span(now);
+        since_ = now;
+        state_ = BUSY;
+    }
+
+    void idle(uint64_t now) {
+        if (state_ != BUSY) return;
+        busy_ += span(now);
+        since_ = now;
+        state_ = IDLE;
+    }
+
+    // A wait the caller measured inside the current busy interval (e.g. a push stall): idle.
+    void waited(uint64_t ns) {
+        waited_ += ns;
+    }
+
+    void stop(uint64_t now) {
+        idle(now);
+        if (state_ == IDLE) idle_ += span(now);
+        state_ = STOPPED;
+    }
+
+    bool started() const { return state_ != NOT_STARTED; }
+
+    // Totals including the open interval up to now
+    uint64_t busyNs(uint64_t now) const {
+        uint64_t b = busy_ + (state_ == BUSY ? span(now) : 0);
+        return b > waited_ ? b - waited_ : 0;
+    }
+    uint64_t idleNs(uint64_t now) const {
+        uint64_t b = busy_ + (state_ == BUSY ? span(now) : 0);
+        return idle_ + (state_ == IDLE ? span(now) : 0) + (waited_ < b ? waited_ : b);
+    }
+
+    static double utilization(uint64_t busy, uint64_t idle) {
+        return busy + idle > 0 ? static_cast<double>(busy) / (busy + idle) : 0.0;
+    }
+
+    // "Utilization: 23.1% (busy 11.5 ms, idle 38.3 ms; ~4.3 per core)" once stopped
+    void print() const {
+        uint64_t b = busyNs(since_), i = idleNs(since_);
+        if (b + i == 0) return;
+        double u = utilization(b, i);
+        std::cout << std::fixed << std::setprecision(1)
+                  << "Utilization: " << 100.0 * u << "% (busy " << b / 1e6 << " ms, idle " << i / 1e6 << " ms";
+        if (u > 0.0) std::cout << "; ~" << 1.0 / u << " per core";
+        std::cout << ")\n";
+        std::cout.unsetf(std::ios::fixed);
+        std::cout << std::setprecision(6);
+    }
+
+private:
+    enum State { NOT_STARTED, BUSY, IDLE, STOPPED };
+
+    uint64_t span(uint64_t now) const { return now > since_ ? now - since_ : 0; }
+
+    State state_ = NOT_STARTED;
+    uint64_t since_ = 0;
+    uint64_t busy_ = 0;
+    uint64_t idle_ = 0;
+    uint64_t waited_ = 0;
+};
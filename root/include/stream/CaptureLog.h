@@ -0,0 +1,88 @@
+// CaptureLog: compact binary log of a pixel stream with its original timing.
+// Layout (little-endian):
+//   header  : "CYNCAP01" (8 bytes), uint32 columns, uint32 reserved (0)
+//   records : uint32 delta_ns (gen_ts_ns minus the previous record's; 0 for the first),
+//             uint8 a, uint8 b                                        -> 6 bytes per pair
+// Inter-arrival gaps longer than UINT32_MAX ns (~4.3 s) are saturated.
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+
+#include "stream/MappedFile.h"
+
+namespace capture {
+constexpr char     MAGIC[8] = { 'C', 'Y', 'N', 'C', 'A', 'P', '0', '1' };
+constexpr size_t   HEADER_SIZE = 16;
+constexpr size_t   RECORD_SIZE = 6;
+}
+
+// Buffered writer used by DataGenerator as a capture sink (single thread).
+class CaptureWriter {
+public:
+    CaptureWriter() = default;
+    ~CaptureWriter();
+
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    bool open(const std::string& path, int columns);
+    void record(uint8_t a, uint8_t b, uint64_t gen_ts_ns) {
+        uint64_t delta = hasPrev_ ? gen_ts_ns - prevTs_ : 0;
+        if (delta > UINT32_MAX) delta = UINT32_MAX;
+        prevTs_ = gen_ts_ns;
+        hasPrev_ = true;
+
+        uint32_t d = static_cast<uint32_t>(delta);
+        uint8_t rec[capture::RECORD_SIZE] = {
+            static_cast<uint8_t>(d), static_cast<uint8_t>(d >> 8),
+            static_cast<uint8_t>(d >> 16), static_cast<uint8_t>(d >> 24),
+            a, b
+        };
+        buffer_.insert(buffer_.end(), rec, rec + capture::RECORD_SIZE);
+        ++records_;
+        if (buffer_.size() >= BUFFER_SIZE) flushBuffer();
+    }
+    void close();
+
+    bool isOpen() const noexcept { return file_ != nullptr; }
+    uint64_t records() const noexcept { return records_; }
+
+private:
+    void flushBuffer();
+
+    static constexpr size_t BUFFER_SIZE = 1 << 16;
+    std::FILE* file_ = nullptr;
+    std::vector<uint8_t> buffer_;
+    uint64_t prevTs_ = 0;
+    bool hasPrev_ = false;
+    uint64_t records_ = 0;
+};
+
+// Memory-mapped reader used by DataGenerator in REPLAY mode.
+class CaptureReader {
+public:
+    bool open(const std::string& path);
+    bool next(uint8_t& a, uint8_t& b, uint32_t& delta_ns) {
+        if (pos_ + capture::RECORD_SIZE > end_) return false;
+        delta_ns = static_cast<uint32_t>(pos_[0]) | (static_cast<uint32_t>(pos_[1]) << 8) |
+                   (static_cast<uint32_t>(pos_[2]) << 16) | (static_cast<uint32_t>(pos_[3]) << 24);
+        a = pos_[4];
+        b = pos_[5];
+        pos_ += capture::RECORD_SIZE;
+        return true;
+    }
+    void close();
+
+    int columns() const noexcept { return columns_; }
+
+    // Probe capture: returns the column count from the header, or 0 on error.
+    static int probeColumns(const std::string& path);
+
+private:
+    MappedFile file_;
+    const uint8_t* pos_ = nullptr;
+    const uint8_t* end_ = nullptr;
+    int columns_ = 0;
+};
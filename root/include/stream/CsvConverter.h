@@ -0,0 +1,25 @@
+// CsvConverter: offline CSV -> binary PGM converter for large captures.
+// - The CSV is memory-mapped and split into one chunk per thread at ',' boundaries;
+//   chunks are parsed in parallel and written in order behind a "P5 <cols> <rows> 255" header.
+// - Token rules match CsvStreamer exactly (trim, empty -> 0, clamp to [0,255], a malformed
+//   token ends the stream, a final odd token is dropped), so replaying the PGM with
+//   --mode=pgm yields the same pairs as --mode=csv. The last row may be short.
+// - Compressed CSVs cannot be mapped and are converted single-threaded through CsvStreamer.
+#pragma once
+#include <string>
+#include <cstdint>
+
+struct ConvertResult {
+    uint64_t pixels = 0;
+    int columns = 0;
+    unsigned threads = 0;
+    double elapsed_ms = 0.0;
+    bool truncated = false;   // stopped early at a malformed token
+};
+
+class CsvConverter {
+public:
+    // columns <= 0 probes the CSV; threads == 0 uses all hardware threads.
+    static bool convertToPgm(const std::string& csvPath, const std::string& outPath,
+                             int columns, unsigned threads, ConvertResult& result);
+};
@@ -2,16 +2,21 @@
 // - Returns pairs of uint8_t values (two tokens = one pair).
 // - Trims whitespace, treats empty token as 0, clamps numeric values to [0,255].
 // - nextPair(a,b) returns true when a pair was produced; false on EOF or error.
+// - The byte source is chosen by InputOptions (plain file or asynchronous read-ahead);
+//   gzip/zstd-compressed files are decompressed transparently.
 #pragma once
 #include <string>
-#include <fstream>
+#include <istream>
+#include <memory>
+
+#include "stream/InputSource.h"
 
 class CsvStreamer {
 public:
     CsvStreamer() = default;
     ~CsvStreamer();
 
-    bool open(const std::string& path);
+    bool open(const std::string& path, const InputOptions& opts = InputOptions());
     bool nextPair(uint8_t& a, uint8_t& b);
     void close();
 
@@ -19,7 +24,8 @@ public:
     static int probeColumns(const std::string& path);
 
 private:
-    std::ifstream in_;
+    std::unique_ptr<std::streambuf> source_;
+    std::istream in_{nullptr};
     std::string token_;
     bool opened_ = false;
 
@@ -0,0 +1,71 @@
+// DecompressStreambuf: read-only std::streambuf over a compressed byte source.
+// - A helper thread pulls compressed bytes from the inner streambuf (plain file or
+//   read-ahead), decompresses them and hands fixed-size chunks to the parser through a
+//   bounded ring, so decompression overlaps parsing on a spare core.
+// - gzip (including concatenated members) needs CYNLR_WITH_ZLIB (link zlib);
+//   zstd needs CYNLR_WITH_ZSTD (link libzstd). Without them open() reports the codec as unsupported.
+#pragma once
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+
+enum class Compression {
+    NONE,
+    GZIP,
+    ZSTD
+};
+
+class DecompressStreambuf : public std::streambuf {
+public:
+    DecompressStreambuf() = default;
+    ~DecompressStreambuf() override;
+
+    DecompressStreambuf(const DecompressStreambuf&) = delete;
+    DecompressStreambuf& operator=(const DecompressStreambuf&) = delete;
+
+    bool open(std::unique_ptr<std::streambuf> compressed, Compression codec,
+              size_t chunks, size_t chunkSize);
+    void close();
+
+    // True if this build can decode the codec.
+    static bool supported(Compression codec);
+    static const char* codecName(Compression codec);
+
+protected:
+    int_type underflow() override;
+
+private:
+    struct Chunk {
+        std::vector<char> data;
+        size_t size = 0;
+    };
+
+    void decodeLoop();
+    bool decodeGzip();
+    bool decodeZstd();
+
+    // Producer side (helper thread)
+    char* acquireChunk();               // blocks until a free chunk is available (nullptr on stop)
+    void publishChunk(size_t size);
+
+    std::unique_ptr<std::streambuf> source_;
+    Compression codec_ = Compression::NONE;
+    std::vector<Chunk> chunks_;
+    size_t chunkSize_ = 0;
+
+    std::thread worker_;
+    std::mutex m_;
+    std::condition_variable cv_;
+    size_t readIdx_ = 0;   // next chunk the parser consumes
+    size_t writeIdx_ = 0;  // next chunk the decoder fills
+    size_t filled_ = 0;    // chunks published but not yet released
+    bool holding_ = false; // parser currently exposes chunk readIdx_
+    bool done_ = false;    // decoder finished (EOF or error)
+    bool stop_ = false;
+    bool opened_ = false;
+};
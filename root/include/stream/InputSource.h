@@ -0,0 +1,27 @@
+// InputSource: picks the byte source behind the CSV / raw streamers.
+// - readAheadBuffers == 0 : plain std::filebuf (blocking reads on the caller's thread).
+// - readAheadBuffers  > 0 : ReadAheadStreambuf keeping that many aligned buffers in flight.
+// - gzip / zstd files (detected by magic bytes) are wrapped in a DecompressStreambuf that
+//   inflates on a helper thread; the compressed bytes still come from the source above.
+#pragma once
+#include <string>
+#include <memory>
+#include <streambuf>
+#include <cstddef>
+
+#include "stream/ReadAheadStreambuf.h"
+#include "stream/DecompressStreambuf.h"
+
+struct InputOptions {
+    size_t readAheadBuffers = 0;
+    size_t readAheadBufferSize = 1 << 20;
+    ReadAheadBackend readAheadBackend = ReadAheadBackend::AUTO;
+    size_t decompressChunks = 4;
+    size_t decompressChunkSize = 1 << 18;
+};
+
+// Detects gzip/zstd by magic bytes; NONE for plain files or on error.
+Compression detectCompression(const std::string& path);
+
+// Returns nullptr if the file cannot be opened.
+std::unique_ptr<std::streambuf> openInputSource(const std::string& path, const InputOptions& opts);
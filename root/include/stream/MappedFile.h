@@ -0,0 +1,38 @@
+// MappedFile: read-only memory mapping of a whole file.
+// - Windows: CreateFileMapping/MapViewOfFile (opened with FILE_FLAG_SEQUENTIAL_SCAN).
+// - POSIX: mmap + madvise(MADV_SEQUENTIAL) so the kernel reads ahead aggressively.
+// - The view is shared, so a file another process is still writing (e.g. a binary
+//   metrics log) shows its updates.
+// - An empty file opens successfully with size() == 0 and data() == nullptr.
+#pragma once
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const noexcept { return opened_; }
+    const uint8_t* data() const noexcept { return data_; }
+    size_t size() const noexcept { return size_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool opened_ = false;
+
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
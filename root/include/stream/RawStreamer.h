@@ -0,0 +1,62 @@
+// RawStreamer: zero-parse pair streamer for binary 8-bit captures.
+// - RAW: headerless stream of uint8 pixels; columns must be supplied externally (--columns).
+// - PGM: binary PGM/PNM ("P5") header is parsed, width becomes the column count,
+//   maxval must be <= 255. Pixel data following the header is streamed until EOF.
+// - By default the file is memory-mapped and nextPair() reads straight from the mapped pages.
+//   With read-ahead or a gzip/zstd capture, bytes come from a streambuf in large chunks instead.
+// - nextPair(a,b) returns true when a pair was produced; false on EOF (a final odd byte is dropped).
+#pragma once
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "stream/MappedFile.h"
+#include "stream/InputSource.h"
+
+enum class RawFormat {
+    RAW,
+    PGM
+};
+
+class RawStreamer {
+public:
+    RawStreamer() = default;
+    ~RawStreamer();
+
+    bool open(const std::string& path, RawFormat format = RawFormat::RAW,
+              const InputOptions& opts = InputOptions());
+    bool nextPair(uint8_t& a, uint8_t& b) {
+        if (pos_ + 2 > end_ && !refill()) return false;
+        a = pos_[0];
+        b = pos_[1];
+        pos_ += 2;
+        return true;
+    }
+    void close();
+
+    // Columns declared by the header (PGM width), or 0 for headerless RAW.
+    int columns() const noexcept { return columns_; }
+
+    // Probe PGM: returns the width from the header, or 0 on error.
+    static int probeColumns(const std::string& path);
+
+    // Parse a binary PGM header. On success fills width/height/maxval and the
+    // offset of the first pixel byte.
+    static bool parsePgmHeader(const uint8_t* data, size_t size,
+                               int& width, int& height, int& maxval, size_t& headerLen);
+
+private:
+    // Streambuf mode: pull the next chunk (carrying over an odd byte). False on EOF.
+    bool refill();
+
+    static constexpr size_t CHUNK_SIZE = 1 << 16;
+
+    MappedFile file_;
+    std::unique_ptr<std::streambuf> source_;
+    std::vector<uint8_t> chunk_;
+    const uint8_t* pos_ = nullptr;
+    const uint8_t* end_ = nullptr;
+    int columns_ = 0;
+};
@@ -0,0 +1,99 @@
+// ReadAheadStreambuf: read-only std::streambuf that keeps N aligned buffers in flight.
+// - URING  : reads are queued on an io_uring (Linux); the kernel fills buffers asynchronously.
+// - THREAD : a helper thread performs blocking reads into the free buffers.
+// - AUTO   : io_uring when available at build and run time, otherwise THREAD.
+// The consumer (parser on the generator thread) only blocks when the next buffer in
+// file order has not been filled yet, e.g. on a cold page cache with a too-shallow queue.
+// A read error is reported on stderr once the bytes before it have been consumed, and
+// underflow() then throws std::ios_base::failure: an istream on top catches it and sets
+// badbit (fail() is true), direct sgetn() callers catch it themselves. Bytes are never skipped.
+#pragma once
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+
+enum class ReadAheadBackend {
+    AUTO,
+    URING,
+    THREAD
+};
+
+class ReadAheadStreambuf : public std::streambuf {
+public:
+    ReadAheadStreambuf();
+    ~ReadAheadStreambuf() override;
+
+    ReadAheadStreambuf(const ReadAheadStreambuf&) = delete;
+    ReadAheadStreambuf& operator=(const ReadAheadStreambuf&) = delete;
+
+    bool open(const std::string& path, size_t buffers, size_t bufferSize,
+              ReadAheadBackend backend = ReadAheadBackend::AUTO);
+    void close();
+
+    bool isOpen() const noexcept { return opened_; }
+    // Backend actually in use ("io_uring" or "thread").
+    const char* backendName() const noexcept;
+
+    // A read failed; error() describes it ("read error at offset N: ...").
+    bool failed() const noexcept { return failed_; }
+    const std::string& error() const noexcept { return error_; }
+
+protected:
+    int_type underflow() override;
+
+private:
+    struct Slot {
+        char*    data = nullptr;
+        size_t   size = 0;      // valid bytes once filled
+        uint64_t offset = 0;    // file offset this slot was issued for
+        bool     filled = false;
+        bool     eof = false;   // no data at this offset
+        int      err = 0;       // read error (errno / Windows error code), no data delivered
+    };
+
+    static constexpr size_t ALIGNMENT = 4096;
+
+    // THREAD backend
+    void readerLoop();
+    // Backend-neutral hooks
+    bool startBackend();
+    void stopBackend();
+    bool waitSlot(size_t idx);
+    void releaseSlot(size_t idx);
+
+    std::vector<Slot> slots_;
+    std::vector<char> storage_;
+    size_t bufferSize_ = 0;
+    size_t current_ = 0;        // slot exposed in the get area
+    bool   haveCurrent_ = false;
+    bool   eof_ = false;
+    uint64_t fileSize_ = 0;
+    uint64_t nextOffset_ = 0;   // next file offset to issue
+    bool opened_ = false;
+    bool useUring_ = false;
+    bool failed_ = false;
+    std::string error_;
+
+#ifdef _WIN32
+    void* file_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+
+    // THREAD backend state
+    std::thread reader_;
+    std::mutex m_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    std::vector<bool> free_;    // slot released by the consumer, ready to be refilled
+
+    // URING backend state (opaque, defined in the .cpp)
+    struct Uring;
+    std::unique_ptr<Uring> uring_;
+};
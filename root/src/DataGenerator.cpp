@@ -1,59 +1,179 @@
 //datagenerator.cpp
 #include "DataGenerator.h"
 #include "Util.h"
+#include "profiler/ModuleProfiler.h"
+#include "profiler/StageLatency.h"
+#include "profiler/Trace.h"
 
 #include <random>
 #include <chrono>
 #include <thread>
 #include <fstream>
 #include "stream/CsvStreamer.h"
+#include "stream/RawStreamer.h"
 #include <iostream>
 #include <string>
 #include <algorithm>
 #include <immintrin.h>
 #include <limits>
 
-// ------------------------------------------------------------
-// Hybrid sleep
-// ------------------------------------------------------------
-static void hybrid_sleep_ns(uint64_t ns) {
-    using namespace std::chrono;
-    if (ns == 0) return;
-
-    auto target = steady_clock::now() + nanoseconds(ns);
-
-    constexpr uint64_t headroom_ns = 2000;
-    if (ns > headroom_ns)
-        std::this_thread::sleep_for(nanoseconds(ns - headroom_ns));
-
-    while (steady_clock::now() < target)
-        util::cpu_relax();
-}
-
 // ------------------------------------------------------------
 // Backpressure-aware push helper
 // ------------------------------------------------------------
-bool DataGenerator::pushWithBackpressure(const DataPair& pair,
-    size_t& blocked_push_count)
+// Works for queue edges and broadcast rings alike (same try_push/push/isShutdown).
+// Time spent waiting on a full sink is added to stall_ns. A push that succeeds first time
+// reads no clock; every failed attempt reads it once to restamp pair.enq_delta_ns, so the
+// copy that lands carries its push time (the reads fall inside the stall, which is spinning
+// anyway). Past the spin limit the wait inside push() is attributed to the queue stage.
+template <typename Sink>
+static bool pushSpinThenBlock(Sink* sink, DataPair& pair, const std::atomic<bool>& running,
+    size_t spinLimit, size_t& blocked_push_count, NowFn now, uint64_t& stall_ns)
 {
     int attempts = 0;
+    uint64_t stall_start = 0;
 
-    while (running && !queue->try_push(pair)) {
+    while (running && !sink->try_push(pair)) {
+        uint64_t t = now();
+        if (attempts == 0) stall_start = t;
+        pair.enq_delta_ns = stageDelta(pair.gen_ts_ns, t);
         ++attempts;
         ++blocked_push_count;
 
-        if (static_cast<size_t>(attempts) < backpressureSpinLimit) {
+        if (static_cast<size_t>(attempts) < spinLimit) {
             util::cpu_relax();
         }
         else {
-            queue->push(pair);
-            if (queue->isShutdown()) return false;
-            return running;
+            sink->push(pair);
+            uint64_t stall_end = now();
+            stall_ns += stall_end - stall_start;
+            CYNLR_TRACE_SPAN("push stall", stall_start, stall_end);
+            return !sink->isShutdown();
         }
     }
+    if (attempts > 0) {
+        uint64_t stall_end = now();
+        stall_ns += stall_end - stall_start;
+        CYNLR_TRACE_SPAN("push stall", stall_start, stall_end);
+    }
+    return true;
+}
+
+bool DataGenerator::pushWithBackpressure(const DataPair& pair,
+    size_t& blocked_push_count)
+{
+    if (overload != OverloadPolicy::BLOCK) {
+        // Drop policies never wait: every destination is offered the pair once.
+        for (ThreadSafeQueue<DataPair>* queue : out_.queues()) offer(queue, pair);
+        for (BroadcastRing<DataPair>* ring : out_.rings()) offer(ring, pair);
+        return running;
+    }
+
+    // Fan-out over queues: every consumer gets its own copy, the slowest one paces the producer.
+    DataPair stamped = pair;
+    for (ThreadSafeQueue<DataPair>* queue : out_.queues()) {
+        if (!pushSpinThenBlock(queue, stamped, running, backpressureSpinLimit, blocked_push_count,
+                               nowFn, queueFullNs))
+            return false;
+    }
+    // Broadcast rings: one write shared by all readers, gated on the slowest critical one.
+    for (BroadcastRing<DataPair>* ring : out_.rings()) {
+        if (!pushSpinThenBlock(ring, stamped, running, backpressureSpinLimit, blocked_push_count,
+                               nowFn, queueFullNs))
+            return false;
+    }
     return running;
 }
 
+// ------------------------------------------------------------
+// Overload policies
+// ------------------------------------------------------------
+static const char* const kOverloadNames[] = { "block", "drop-newest", "drop-oldest", "drop-line" };
+
+bool parseOverloadPolicy(const std::string& name, OverloadPolicy& out)
+{
+    for (int i = 0; i < 4; ++i) {
+        if (name == kOverloadNames[i]) {
+            out = static_cast<OverloadPolicy>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* overloadPolicyName(OverloadPolicy policy)
+{
+    return kOverloadNames[static_cast<int>(policy)];
+}
+
+// Non-blocking delivery; false only when the pair has to wait (BLOCK).
+bool DataGenerator::offer(ThreadSafeQueue<DataPair>* queue, const DataPair& pair)
+{
+    if (queue->try_push(pair) || queue->isShutdown()) return true;
+
+    switch (overload) {
+    case OverloadPolicy::BLOCK:
+        return false;
+    case OverloadPolicy::DROP_NEWEST:
+        recordDrop(pair.seq);
+        return true;
+    case OverloadPolicy::DROP_OLDEST: {
+        DataPair evicted;
+        if (queue->push_evict(pair, evicted)) recordDrop(evicted.seq);
+        return true;
+    }
+    case OverloadPolicy::DROP_LINE: {
+        // Drop from here to the end of the line so the consumer resumes on a line start.
+        uint64_t pairsPerLine = static_cast<uint64_t>(std::max(1, columns / 2));
+        lineDropEnd = (pair.seq / pairsPerLine + 1) * pairsPerLine;
+        recordDrop(pair.seq);
+        return true;
+    }
+    }
+    return true;
+}
+
+bool DataGenerator::offer(BroadcastRing<DataPair>* ring, const DataPair& pair)
+{
+    if (ring->try_push(pair) || ring->isShutdown()) return true;
+    if (overload == OverloadPolicy::BLOCK) return false;
+    recordDrop(pair.seq);
+    return true;
+}
+
+bool DataGenerator::limitReached()
+{
+    if ((pairLimit > 0 && seqCounter >= pairLimit) || (stopAt > 0 && nowFn() >= stopAt))
+        limitHit = true;
+    return limitHit;
+}
+
+bool DataGenerator::inDroppedLine(uint64_t seq)
+{
+    if (seq >= lineDropEnd) return false;
+    recordDrop(seq);
+    return true;
+}
+
+void DataGenerator::recordDrop(uint64_t seq)
+{
+    static constexpr size_t kMaxDropRanges = 4096;
+
+    if (!dropRangeLog.empty()) {
+        DropRange& last = dropRangeLog.back();
+        if (seq >= last.first && seq <= last.last) return; // already dropped for another consumer
+        if (seq == last.last + 1) {
+            last.last = seq;
+            ++droppedCount;
+            return;
+        }
+    }
+    ++droppedCount;
+    if (dropRangeLog.size() < kMaxDropRanges)
+        dropRangeLog.push_back(DropRange{ seq, seq });
+    else
+        ++dropRangesLost;
+}
+
 // ------------------------------------------------------------
 // Output interface implementation
 // ------------------------------------------------------------
@@ -70,19 +190,18 @@ DataGenerator::DataGenerator(ThreadSafeQueue<DataPair>* q,
     int m,
     uint64_t T_ns,
     InputMode mode,
-    const std::string& csvFile,
+    const std::string& inputFile,
     NowFn nowFn,
     SleepFn sleepFn,
     size_t spinLimit)
-    : queue(q),
-    columns(m),
+    : columns(m),
     T_ns(T_ns),
     mode(mode),
     running(false),
     seqCounter(0),
-    csvFile(csvFile),
+    inputFile(inputFile),
     backpressureSpinLimit(spinLimit),
-    profiler_("DataGenerator", 100000), 
+    profiler_("DataGenerator"), 
     totalQueueSizeSamples(0),
     minQueueSize(std::numeric_limits<uint64_t>::max()),
     maxQueueSize(0),
@@ -92,7 +211,10 @@ DataGenerator::DataGenerator(ThreadSafeQueue<DataPair>* q,
     this->nowFn = nowFn ? nowFn : []() {
         return util::now_ns();
     };
-    this->sleepFn = sleepFn ? sleepFn : hybrid_sleep_ns;
+    this->sleepFn = sleepFn ? sleepFn : util::hybrid_sleep_ns;
+    out_.bind(q);
+    // REPLAY paces by the recorded schedule, so T_ns is no budget there
+    pairDeadline.setBudget(mode == InputMode::REPLAY ? 0 : T_ns);
 }
 
 void DataGenerator::start() {
@@ -102,7 +224,7 @@ void DataGenerator::start() {
 }
 
 void DataGenerator::stop() {
-    if (mode == InputMode::CSV) {
+    if (mode != InputMode::RANDOM) {
         if (worker.joinable())
             worker.join();
     } else {
@@ -115,62 +237,314 @@ void DataGenerator::stop() {
 }
 
 // ------------------------------------------------------------
-// Main loop
+// Input helpers (shared by the threaded and pooled paths)
 // ------------------------------------------------------------
-void DataGenerator::run()
+bool DataGenerator::openInput()
 {
-    std::mt19937 rng(std::random_device{}());
-    std::uniform_int_distribution<int> dist(0, 255);
+    rng.seed(std::random_device{}());
+    stopAt = durationLimit_ns > 0 ? nowFn() + durationLimit_ns : 0;
+    limitHit = false;
 
-    int currentColumn = 0;
-
-    CsvStreamer csvStreamer;
     if (mode == InputMode::CSV) {
-        if (!csvStreamer.open(csvFile)) {
-            std::cerr << "Error: Could not open CSV file: " << csvFile << "\n";
-            running = false;
-            return;
+        if (!csvStreamer.open(inputFile, inputOptions)) {
+            std::cerr << "Error: Could not open CSV file: " << inputFile << "\n";
+            return false;
+        }
+    } else if (mode == InputMode::RAW || mode == InputMode::PGM) {
+        RawFormat format = (mode == InputMode::PGM) ? RawFormat::PGM : RawFormat::RAW;
+        if (!rawStreamer.open(inputFile, format, inputOptions)) {
+            std::cerr << "Error: Could not open raw capture: " << inputFile << "\n";
+            return false;
         }
+    } else if (mode == InputMode::REPLAY) {
+        if (!replayReader.open(inputFile)) {
+            std::cerr << "Error: Could not open replay log: " << inputFile << "\n";
+            return false;
+        }
+    }
+
+    if (!captureFile.empty() && !capture.open(captureFile, columns)) {
+        std::cerr << "Warning: capture disabled, could not open " << captureFile << "\n";
+    }
+    return true;
+}
+
+bool DataGenerator::readPixels(DataPair& pair)
+{
+    if (mode == InputMode::RANDOM) {
+        pair.a = static_cast<uint8_t>(dist(rng));
+        pair.b = static_cast<uint8_t>(dist(rng));
+        return true;
+    }
+    if (mode == InputMode::CSV)
+        return csvStreamer.nextPair(pair.a, pair.b);
+    return rawStreamer.nextPair(pair.a, pair.b);
+}
+
+// Absolute target = first pair time + sum of recorded gaps,
+// so sleep overshoot does not accumulate into drift.
+uint64_t DataGenerator::replayTarget(uint32_t delta_ns)
+{
+    if (replayTiming != ReplayTiming::ORIGINAL) return 0;
+    if (seqCounter == 0) {
+        replayBase = nowFn();
+        return 0;
+    }
+    replayOffset += delta_ns;
+    return replayBase + replayOffset;
+}
+
+void DataGenerator::stampPair(DataPair& pair)
+{
+    pair.gen_ts_ns = nowFn();
+    pair.gen_ts_valid = true;
+    pair.seq = seqCounter++;
+
+    if (capture.isOpen())
+        capture.record(pair.a, pair.b, pair.gen_ts_ns);
+
+    // Sample queue size for memory profiling
+    size_t qsize = out_.size();
+    totalQueueSizeSamples += qsize;
+    ++queueSizeSampleCount;
+    minQueueSize = std::min(minQueueSize, (uint64_t)qsize);
+    maxQueueSize = std::max(maxQueueSize, (uint64_t)qsize);
+    CYNLR_TRACE_COUNTER("queue depth", qsize);
+}
+
+void DataGenerator::finishInput()
+{
+    capture.close();
+    uint64_t now = nowFn();
+    util_.stop(now);
+    if (live_.enabled()) publishLive(now);
+
+    // Explicit EOF shutdown (a pair/duration limit ends a random stream the same way)
+    if (mode != InputMode::RANDOM || limitHit)
+        out_.shutdown();
+
+    running.store(false, std::memory_order_release);
+}
+
+void DataGenerator::recordLive(uint64_t pair_time, uint64_t now)
+{
+    live_.working().service.record(pair_time);
+    if (live_.due(now)) publishLive(now);
+}
+
+void DataGenerator::publishLive(uint64_t now)
+{
+    LiveBlockStats& live = live_.working();
+    live.items = profiler_.histogram().count();
+    live.dropped = droppedCount;
+    live.deadlineMisses = pairDeadline.missed();
+    live.stall_ns = queueFullNs;
+    live.busy_ns = util_.busyNs(now);
+    live.idle_ns = util_.idleNs(now);
+    live.queueDepthSum = totalQueueSizeSamples;
+    live.queueSamples = queueSizeSampleCount;
+    live.queueDepth = out_.size();
+    live.queueCapacity = out_.capacity();
+    if (perf_.enabled()) perf_.sample(live.perf);
+    live_.publish(now);
+}
+
+// ------------------------------------------------------------
+// Main loop
+// ------------------------------------------------------------
+void DataGenerator::run()
+{
+    placementReport_ = applyThreadPlacement(placement_);
+    placed_.store(true, std::memory_order_release);
+    CYNLR_TRACE_THREAD_NAME("generator");
+
+    if (!openInput()) {
+        running = false;
+        return;
     }
+    perf_.begin();
 
-    while (running) {
-        uint64_t pair_start = util::now_ns();
+    int currentColumn = 0;
+    uint64_t prev_end = 0;
 
+    while (running && !limitReached()) {
         DataPair pair{};
+        uint64_t target = 0;
 
-        // ------------------ produce data ------------------
-        if (mode == InputMode::RANDOM) {
-            pair.a = static_cast<uint8_t>(dist(rng));
-            pair.b = static_cast<uint8_t>(dist(rng));
-        } else {
-            if (!csvStreamer.nextPair(pair.a, pair.b)) break;
+        // ------------------ replay pacing ------------------
+        if (mode == InputMode::REPLAY) {
+            uint32_t delta_ns = 0;
+            if (!replayReader.next(pair.a, pair.b, delta_ns)) break;
+            target = replayTarget(delta_ns);
+            uint64_t now = nowFn();
+            if (target > now) sleepFn(target - now);
         }
 
-        pair.gen_ts_ns = nowFn();
-        pair.gen_ts_valid = true;
-        pair.seq = seqCounter++;
+        uint64_t pair_start = nowFn();
+        util_.busy(pair_start);
 
-        // Sample queue size for memory profiling
-        size_t qsize = queue->size();
-        totalQueueSizeSamples += qsize;
-        ++queueSizeSampleCount;
-        minQueueSize = std::min(minQueueSize, (uint64_t)qsize);
-        maxQueueSize = std::max(maxQueueSize, (uint64_t)qsize);
+        // ------------------ produce data ------------------
+        if (mode != InputMode::REPLAY && !readPixels(pair)) break;
 
-        emit(pair);
+        stampPair(pair);
+        // Sleep overshoot: against the replay target, or T_ns after the previous pair ended
+        if (mode == InputMode::REPLAY)
+            pair.pace_late_ns = stageDelta(target, pair.gen_ts_ns);
+        else if (prev_end != 0)
+            pair.pace_late_ns = stageDelta(prev_end + T_ns, pair_start);
+        uint64_t stalled = queueFullNs;
+        if (!inDroppedLine(pair.seq))
+            emit(pair);
+        util_.waited(queueFullNs - stalled);
 
-        uint64_t pair_time = util::now_ns() - pair_start;
+        uint64_t pair_end = nowFn();
+        util_.idle(pair_end);
+        uint64_t pair_time = pair_end - pair_start;
         profiler_.recordSample(pair_time);
+        pairDeadline.record(pair.seq, pair_time);
+        if (live_.enabled()) recordLive(pair_time, pair_end);
+        CYNLR_TRACE_SPAN("produce", pair_start, pair_end);
+        CYNLR_PROFILE_RECORD("DataGenerator.produce", pair_time);
+        prev_end = pair_end;
 
         currentColumn = (currentColumn + 2) % columns;
-        sleepFn(T_ns);
+        if (mode != InputMode::REPLAY) {
+            CYNLR_TRACE_SCOPE("pace sleep");
+            CYNLR_PROFILE_SCOPE("DataGenerator.pace_sleep");
+            sleepFn(T_ns);
+        }
     }
 
-    // Explicit EOF shutdown
-    if (mode == InputMode::CSV)
-        queue->shutdown();
+    perf_.end();
+    finishInput();
+}
 
-    running.store(false, std::memory_order_release);
+// ------------------------------------------------------------
+// Pooled execution
+// ------------------------------------------------------------
+void DataGenerator::startSteps()
+{
+    running.store(true, std::memory_order_release);
+    profiler_.startBlock(util::now_ns());
+    perf_.markPooled();
+    inputOpen = openInput();
+    hasPending = false;
+    nextDue = 0;
+}
+
+void DataGenerator::requestStop()
+{
+    // File modes run to EOF, as stop() does for the threaded path.
+    if (mode == InputMode::RANDOM)
+        running.store(false, std::memory_order_release);
+}
+
+void DataGenerator::stopSteps()
+{
+    profiler_.stopBlock(util::now_ns());
+}
+
+Block::StepResult DataGenerator::finishSteps()
+{
+    hasPending = false;
+    finishInput();
+    return StepResult::Done;
+}
+
+// Fan-out without blocking: resumes at pendingSink so no consumer sees the pair twice.
+// A shut-down consumer no longer takes input and is skipped; drop policies apply as in run().
+bool DataGenerator::tryEmitPending()
+{
+    const auto& queues = out_.queues();
+    const auto& rings = out_.rings();
+    while (pendingSink < queues.size() + rings.size()) {
+        bool delivered = (pendingSink < queues.size())
+            ? offer(queues[pendingSink], pending)
+            : offer(rings[pendingSink - queues.size()], pending);
+        if (!delivered) return false;
+        ++pendingSink;
+    }
+    return true;
+}
+
+uint64_t DataGenerator::idleWaitNs() const
+{
+    uint64_t due = pendingDueNs();
+    if (due == 0) return 0;
+    uint64_t now = nowFn();
+    return due > now ? due - now : 1;
+}
+
+Block::StepResult DataGenerator::step(size_t maxItems)
+{
+    if (!inputOpen) return finishSteps();
+
+    size_t produced = 0;
+    while (produced < maxItems) {
+        if (!hasPending) {
+            if (!running.load(std::memory_order_acquire) || limitReached()) return finishSteps();
+
+            DataPair pair{};
+            if (mode == InputMode::REPLAY) {
+                uint32_t delta_ns = 0;
+                if (!replayReader.next(pair.a, pair.b, delta_ns)) return finishSteps();
+                pendingDue = replayTarget(delta_ns);
+            } else {
+                if (!readPixels(pair)) return finishSteps();
+                pendingDue = nextDue;
+            }
+            pending = pair;
+            hasPending = true;
+            pendingStamped = false;
+            pendingSink = 0;
+        }
+
+        if (!pendingStamped) {
+            if (pendingDue > nowFn()) break; // not due yet: free the worker
+            pendingStart = nowFn();
+            util_.busy(pendingStart);
+            stampPair(pending);
+            if (pendingDue > 0) pending.pace_late_ns = stageDelta(pendingDue, pending.gen_ts_ns);
+            pendingStamped = true;
+            if (inDroppedLine(pending.seq)) {
+                hasPending = false;
+                ++produced;
+                continue;
+            }
+        }
+
+        if (stallSince != 0) {
+            uint64_t retry = nowFn();
+            pending.enq_delta_ns = stageDelta(pending.gen_ts_ns, retry);
+            util_.busy(retry);
+        }
+        if (!tryEmitPending()) {
+            ++totalBlockedPushes;
+            uint64_t now = nowFn();
+            if (stallSince == 0) stallSince = now;
+            util_.idle(now);   // until the retry: the worker is free for other blocks
+            break;
+        }
+        if (stallSince != 0) {
+            uint64_t stall_end = nowFn();
+            queueFullNs += stall_end - stallSince;
+            CYNLR_TRACE_SPAN("push stall", stallSince, stall_end);
+            stallSince = 0;
+        }
+        uint64_t pair_end = nowFn();
+        util_.idle(pair_end);
+        uint64_t pair_time = pair_end - pendingStart;
+        profiler_.recordSample(pair_time);
+        pairDeadline.record(pending.seq, pair_time);
+        if (live_.enabled()) recordLive(pair_time, pair_end);
+        CYNLR_TRACE_SPAN("produce", pendingStart, pair_end);
+        CYNLR_PROFILE_RECORD("DataGenerator.produce", pair_time);
+        hasPending = false;
+        ++produced;
+        if (mode != InputMode::REPLAY && T_ns > 0)
+            nextDue = nowFn() + T_ns;
+    }
+    return produced > 0 ? StepResult::Progress : StepResult::Idle;
 }
 
 // ------------------------------------------------------------
@@ -189,13 +563,42 @@ void DataGenerator::printStats() const {
         std::cout << "  Min queue size: " << min_qsize << "\n";
         std::cout << "  Max queue size: " << maxQueueSize << "\n";
         
-        if (queue) {
-            size_t capacity = queue->capacity();
+        if (out_.connected()) {
+            size_t capacity = out_.capacity();
             double utilization = (avg_queue_size / capacity) * 100.0;
             std::cout << "  Queue capacity: " << capacity << "\n";
             std::cout << "  Avg utilization: " << utilization << "%\n";
         }
     }
 
+    if (overload != OverloadPolicy::BLOCK) {
+        std::cout << "\nOverload policy: " << overloadPolicyName(overload) << "\n";
+        std::cout << "  Dropped pairs: " << droppedCount << " in " << dropRangeLog.size() + dropRangesLost
+                  << " range(s)\n";
+        const size_t shown = std::min<size_t>(dropRangeLog.size(), 10);
+        for (size_t i = 0; i < shown; ++i)
+            std::cout << "    seq " << dropRangeLog[i].first << "-" << dropRangeLog[i].last << "\n";
+        if (dropRangeLog.size() + dropRangesLost > shown)
+            std::cout << "    ...\n";
+    }
+
+    if (queueFullNs > 0)
+        std::cout << "\nQueue-full stall: " << queueFullNs / 1e6 << " ms\n";
+
+    if (util_.started()) {
+        std::cout << "\n";
+        util_.print();
+    }
+
+    if (pairDeadline.budget() > 0) {
+        std::cout << "\n";
+        pairDeadline.printStats();
+    }
+
+    if (perf_.enabled()) {
+        std::cout << "\n";
+        perf_.print(2 * profiler_.histogram().count());
+    }
+
     std::cout << "-----------------------------------\n";
 }
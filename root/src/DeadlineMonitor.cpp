@@ -0,0 +1,166 @@
+#include "DeadlineMonitor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+// Heap order for worst_: the smallest of the kept misses sits at front().
+static bool greaterMiss(const DeadlineMiss& a, const DeadlineMiss& b) {
+    return a.actual_ns > b.actual_ns;
+}
+
+// Intervals below half the alert rate before shed work is restored.
+static constexpr unsigned kCalmIntervalsToRestore = 3;
+
+// ========================
+// DeadlineMonitor
+// ========================
+
+DeadlineMonitor::DeadlineMonitor(const std::string& name, uint64_t budget_ns, size_t worstK)
+    : name_(name), budget_(budget_ns), worstK_(worstK > 0 ? worstK : 1)
+{
+    worst_.reserve(worstK_);
+}
+
+void DeadlineMonitor::logWorst(uint64_t seq, uint64_t actual_ns)
+{
+    if (worst_.size() == worstK_) {
+        std::pop_heap(worst_.begin(), worst_.end(), greaterMiss);
+        worst_.pop_back();
+    }
+    worst_.push_back(DeadlineMiss{ seq, actual_ns });
+    std::push_heap(worst_.begin(), worst_.end(), greaterMiss);
+}
+
+std::vector<DeadlineMiss> DeadlineMonitor::worst() const
+{
+    std::vector<DeadlineMiss> sorted = worst_;
+    std::sort(sorted.begin(), sorted.end(), greaterMiss);
+    return sorted;
+}
+
+void DeadlineMonitor::printStats() const
+{
+    if (budget_ == 0) return;
+    uint64_t c = checked();
+    uint64_t m = missed();
+    std::cout << "Deadline " << name_ << " (budget " << budget_ << " ns): "
+              << m << " / " << c << " missed";
+    if (c > 0) std::cout << " (" << (100.0 * m / c) << "%)";
+    std::cout << "\n";
+
+    std::vector<DeadlineMiss> w = worst();
+    if (!w.empty()) {
+        std::cout << "  Worst:";
+        for (size_t i = 0; i < w.size() && i < 5; ++i)
+            std::cout << " seq " << w[i].seq << "=" << w[i].actual_ns << "ns";
+        std::cout << "\n";
+    }
+}
+
+// ========================
+// DeadlineWatchdog
+// ========================
+
+DeadlineWatchdog::DeadlineWatchdog(uint64_t interval_ms, double alertRate)
+    : interval_ms_(interval_ms > 0 ? interval_ms : 1), alertRate_(alertRate)
+{
+}
+
+DeadlineWatchdog::~DeadlineWatchdog()
+{
+    stop();
+}
+
+void DeadlineWatchdog::watch(const std::string& owner, const std::vector<DeadlineMonitor*>& monitors,
+                             std::function<void(bool)> shed)
+{
+    Group g;
+    g.owner = owner;
+    for (DeadlineMonitor* m : monitors) {
+        if (m) g.monitors.push_back(Watched{ m, m->checked(), m->missed() });
+    }
+    if (g.monitors.empty()) return;
+    g.shed = std::move(shed);
+    groups_.push_back(std::move(g));
+}
+
+void DeadlineWatchdog::start()
+{
+    if (worker_.joinable()) return;
+    stopping_ = false;
+    worker_ = std::thread(&DeadlineWatchdog::run, this);
+}
+
+void DeadlineWatchdog::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) worker_.join();
+}
+
+bool DeadlineWatchdog::poll()
+{
+    for (Group& g : groups_) {
+        bool overBudget = false;
+        bool calm = true;
+        for (Watched& w : g.monitors) {
+            uint64_t c = w.monitor->checked();
+            uint64_t m = w.monitor->missed();
+            uint64_t dc = c - w.lastChecked;
+            uint64_t dm = m - w.lastMissed;
+            w.lastChecked = c;
+            w.lastMissed = m;
+            if (dc == 0) continue;
+
+            double rate = static_cast<double>(dm) / dc;
+            if (rate > alertRate_) {
+                overBudget = true;
+                if (!g.alerting) {
+                    std::cerr << "[Watchdog] ALERT " << w.monitor->name() << ": " << dm << " of " << dc
+                              << " (" << (100.0 * rate) << "%) over the " << w.monitor->budget()
+                              << " ns budget in the last " << interval_ms_ << " ms\n";
+                }
+            }
+            if (rate > alertRate_ / 2) calm = false;
+        }
+
+        if (overBudget) {
+            g.calmIntervals = 0;
+            if (!g.alerting) {
+                g.alerting = true;
+                alerting_.fetch_add(1, std::memory_order_relaxed);
+                alerts_.fetch_add(1, std::memory_order_relaxed);
+                if (g.shed) {
+                    std::cerr << "[Watchdog] " << g.owner << ": shedding optional work (metrics recording)\n";
+                    g.shed(true);
+                }
+            }
+        } else if (g.alerting) {
+            g.calmIntervals = calm ? g.calmIntervals + 1 : 0;
+            if (g.calmIntervals >= kCalmIntervalsToRestore) {
+                g.alerting = false;
+                alerting_.fetch_sub(1, std::memory_order_relaxed);
+                std::cerr << "[Watchdog] " << g.owner << ": deadlines recovered"
+                          << (g.shed ? "; restoring optional work\n" : "\n");
+                if (g.shed) g.shed(false);
+            }
+        }
+    }
+    return shedding();
+}
+
+void DeadlineWatchdog::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        cv_.wait_for(lock, std::chrono::milliseconds(interval_ms_), [this] { return stopping_; });
+        if (stopping_) break;
+        lock.unlock();
+        poll();
+        lock.lock();
+    }
+}
@@ -2,6 +2,7 @@
 #include "FilterBlock.h"
 
 #include "Util.h"
+#include "profiler/ModuleProfiler.h"
 
 #include <iostream>
 #include <chrono>
@@ -17,6 +18,9 @@
 
 static constexpr int    TAPS = 9;
 static constexpr int    CENTER = TAPS / 2;
+// A sample's output is computed CENTER samples after it arrives, i.e. this many pairs later
+static constexpr uint64_t kOutputLagPairs = CENTER / 2;
+static_assert(CENTER % 2 == 0 && kOutputLagPairs < 4, "inFlight_ holds the pairs awaiting output");
 
 static constexpr double KERNEL[TAPS] = {
     0.00025177,
@@ -48,7 +52,7 @@ FilterBlock::FilterBlock(
     : worker(),
     running(false),
     ready(false),
-    queue(q),
+    nowFn(util::now_ns),
     metrics(metrics_),
     circ_buf{},
     buf_idx(0),
@@ -60,12 +64,14 @@ FilterBlock::FilterBlock(
     sum_queue_latency_ns(0),
     min_queue_latency_ns(std::numeric_limits<uint64_t>::max()),
     max_queue_latency_ns(0),
-    profiler_("FilterBlock", 100000),
+    profiler_("FilterBlock"),
     totalQueueSizeSamples(0),
     minQueueSize(std::numeric_limits<uint64_t>::max()),
     maxQueueSize(0),
     queueSizeSampleCount(0)
 {
+    in_.bind(q);
+
     // Default: use built-in kernel
     for (int i = 0; i < TAPS; ++i) fir_kernel[i] = KERNEL[i];
     if (useFileKernel && !kernelFile.empty()) {
@@ -113,7 +119,7 @@ bool FilterBlock::loadKernelFromFile(const std::string& path) {
 void FilterBlock::start()
 {
     running = true;
-    profiler_.startBlock(util::now_ns());
+    profiler_.startBlock(nowFn());
     worker = std::thread(&FilterBlock::run, this);
 }
 
@@ -121,16 +127,18 @@ void FilterBlock::stop()
 {
     running = false;
 
-    if (queue)
-        queue->shutdown();
+    in_.shutdown();
 
     if (worker.joinable())
         worker.join();
 
-    profiler_.stopBlock(util::now_ns());
+    profiler_.stopBlock(nowFn());
+    if (live_.enabled()) publishLive(nowFn());
 
-    if (metrics)
+    if (metrics) {
+        if (shedRunPairs > 0) endShedRun();
         metrics->flush();
+    }
 }
 
 // ========================
@@ -160,6 +168,7 @@ double FilterBlock::applyCurrentWindow() const
 
 inline bool FilterBlock::processSample(double sample, uint64_t proc_start, uint64_t& out_ts)
 {
+    CYNLR_PROFILE_SCOPE("FilterBlock.process_sample");
     pushSample(sample);
 
     if (buf_count < TAPS)
@@ -167,7 +176,7 @@ inline bool FilterBlock::processSample(double sample, uint64_t proc_start, uint6
 
     double filtered = applyCurrentWindow();
     int output = (filtered >= TV) ? 1 : 0;
-    out_ts = util::now_ns();
+    out_ts = nowFn();
     (void)output;
 
     currentColumn = (currentColumn + 1) % columns;
@@ -180,8 +189,28 @@ void FilterBlock::flushWithZeros()
     for (int i = 0; i < CENTER; ++i)
     {
         uint64_t dummy_ts = 0;
-        processSample(0.0, util::now_ns(), dummy_ts);
+        processSample(0.0, nowFn(), dummy_ts);
     }
+
+    // The zero padding emitted the outputs of the last pairs
+    uint64_t now = nowFn();
+    for (uint64_t i = stagePairs_ > kOutputLagPairs ? stagePairs_ - kOutputLagPairs : 0; i < stagePairs_; ++i)
+        emitStages(i, now);
+    util_.stop(now);
+}
+
+void FilterBlock::endShedRun()
+{
+    metrics->recordShed(shedRunFirst, shedRunLast, shedRunPairs);
+    shedRunPairs = 0;
+}
+
+void FilterBlock::emitStages(uint64_t pairIndex, uint64_t emitted_ns)
+{
+    PairStages& st = inFlight_[pairIndex % 4];
+    if (!st.valid) return;
+    stages_.record(st, emitted_ns);
+    st.valid = false;
 }
 
 // ========================
@@ -190,20 +219,28 @@ void FilterBlock::flushWithZeros()
 
 void FilterBlock::run()
 {
+    placementReport_ = applyThreadPlacement(placement_);
+    placed_.store(true, std::memory_order_release);
+    CYNLR_TRACE_THREAD_NAME("filter");
+    perf_.begin();
+
     ready.store(true, std::memory_order_release);
 
     while (true)
     {
         DataPair pair;
 
-        while (!queue->try_pop(pair)) {
-            if (queue->isShutdown()) {
+        while (!in_.try_pop(pair)) {
+            if (in_.exhausted()) {
                 flushWithZeros();
+                perf_.end();
                 ready.store(false, std::memory_order_release);
                 return;
             }
+            markIdle();
             util::cpu_relax();
         }
+        markBusy();
 
         if (pair.seq == std::numeric_limits<uint64_t>::max())
         {
@@ -211,60 +248,178 @@ void FilterBlock::run()
             break;
         }
 
-        size_t qsize = queue->size();
-        totalQueueSizeSamples += qsize;
-        ++queueSizeSampleCount;
-        minQueueSize = std::min(minQueueSize, (uint64_t)qsize);
-        maxQueueSize = std::max(maxQueueSize, (uint64_t)qsize);
+        processPair(pair);
+    }
 
-        uint64_t pop_ts = util::now_ns();
-        uint64_t proc_start = util::now_ns();
+    perf_.end();
+    ready.store(false, std::memory_order_release);
+}
 
-        uint64_t queue_latency = 0;
-        if (pair.gen_ts_valid)
-        {
-            assert(proc_start >= pair.gen_ts_ns && "proc_start < gen_ts_ns: possible timestamp bug");
-            queue_latency = proc_start > pair.gen_ts_ns
-                ? proc_start - pair.gen_ts_ns
-                : 0;
-
-            ++totalPairsProcessed;
-            sum_queue_latency_ns += queue_latency;
-            min_queue_latency_ns = std::min(min_queue_latency_ns, queue_latency);
-            max_queue_latency_ns = std::max(max_queue_latency_ns, queue_latency);  
+void FilterBlock::processPair(const DataPair& pair)
+{
+    CYNLR_TRACE_SCOPE("filter pair");
+    CYNLR_PROFILE_SCOPE("FilterBlock.process_pair");
+
+    // A jump in seq marks pairs the generator dropped; fan-in interleaves sources, so skip it there.
+    if (in_.sourceCount() == 1) {
+        if (pair.seq > expectedSeq) {
+            ++seqGaps;
+            missingPairs += pair.seq - expectedSeq;
         }
+        expectedSeq = pair.seq + 1;
+    }
+
+    size_t qsize = in_.size();
+    totalQueueSizeSamples += qsize;
+    ++queueSizeSampleCount;
+    minQueueSize = std::min(minQueueSize, (uint64_t)qsize);
+    maxQueueSize = std::max(maxQueueSize, (uint64_t)qsize);
+
+    uint64_t pop_ts = nowFn();
+    uint64_t proc_start = nowFn();
+    if (!util_.started()) util_.busy(pop_ts);
+
+    uint64_t queue_latency = 0;
+    if (pair.gen_ts_valid)
+    {
+        assert(proc_start >= pair.gen_ts_ns && "proc_start < gen_ts_ns: possible timestamp bug");
+        queue_latency = proc_start > pair.gen_ts_ns
+            ? proc_start - pair.gen_ts_ns
+            : 0;
+
+        ++totalPairsProcessed;
+        sum_queue_latency_ns += queue_latency;
+        min_queue_latency_ns = std::min(min_queue_latency_ns, queue_latency);
+        max_queue_latency_ns = std::max(max_queue_latency_ns, queue_latency);  
+    }
+
+    uint64_t out0_ts = 0, out1_ts = 0;
+    bool produced0 = processSample(static_cast<double>(pair.a), proc_start, out0_ts);
+    bool produced1 = processSample(static_cast<double>(pair.b), proc_start, out1_ts);
 
-        uint64_t out0_ts = 0, out1_ts = 0;
-        bool produced0 = processSample(static_cast<double>(pair.a), proc_start, out0_ts);
-        bool produced1 = processSample(static_cast<double>(pair.b), proc_start, out1_ts);
+    if (produced1) {
+        uint64_t proc1 = out1_ts - proc_start;
+        profiler_.recordSample(proc1);  
+        pairDeadline.record(pair.seq, proc1);
+        if (produced0) gapDeadline.record(pair.seq, out1_ts - out0_ts);
+    }
+
+    // Stage stamps: the pair waits in inFlight_ until the FIR emits its outputs
+    PairStages& st = inFlight_[stagePairs_ % 4];
+    st.valid = pair.gen_ts_valid;
+    if (st.valid) {
+        st.gen_ns = pair.gen_ts_ns;
+        st.pace = pair.pace_late_ns;
+        st.enq = pair.enq_delta_ns;
+        st.deq = stageDelta(pair.gen_ts_ns, pop_ts);
+        st.filtered = stageDelta(pair.gen_ts_ns, produced1 ? out1_ts : proc_start);
+    }
+    if (produced1 && stagePairs_ >= kOutputLagPairs) emitStages(stagePairs_ - kOutputLagPairs, out1_ts);
+    ++stagePairs_;
+
+    if (live_.enabled()) {
+        LiveBlockStats& live = live_.working();
+        if (pair.gen_ts_valid) live.latency.record(queue_latency);
+        if (produced1) live.service.record(out1_ts - proc_start);
+        uint64_t now = produced1 ? out1_ts : proc_start;
+        if (live_.due(now)) publishLive(now);
+    }
 
-        if (produced1) {
-            uint64_t proc1 = out1_ts - proc_start;
-            profiler_.recordSample(proc1);  
+    if (metrics && metricsShed.load(std::memory_order_relaxed))
+    {
+        if (shedRunPairs++ == 0) shedRunFirst = pair.seq;
+        shedRunLast = pair.seq;
+        ++shedPairs;
+    }
+    else if (metrics)
+    {
+        if (shedRunPairs > 0) endShedRun();
+        if (sampler_.wants(proc_start)) {
+            PairMetrics m;
+            m.seq = pair.seq;
+            m.gen_ts_ns = pair.gen_ts_ns;
+            m.gen_ts_valid = pair.gen_ts_valid;
+            m.pop_ts_ns = pop_ts;
+            m.proc_start_ns = proc_start;
+            m.out0_ts_ns = out0_ts;
+            m.out1_ts_ns = out1_ts;
+            m.queue_latency_ns = queue_latency;
+            m.proc0_ns = produced0 ? (out0_ts - proc_start) : 0;
+            m.proc1_ns = produced1 ? (out1_ts - proc_start) : 0;
+            m.inter_output_delta_ns = (produced0 && produced1) ? (out1_ts - out0_ts) : 0;
+            sampler_.submit(m, *metrics);
         }
+    }
+}
 
-        if (metrics)
-        {
-            uint64_t proc0 = produced0 ? (out0_ts - proc_start) : 0;
-            uint64_t proc1 = produced1 ? (out1_ts - proc_start) : 0;
-            uint64_t inter = (produced0 && produced1) ? (out1_ts - out0_ts) : 0;
-
-            metrics->recordPair(
-                pair.seq,
-                pair.gen_ts_ns,
-                pair.gen_ts_valid,
-                pop_ts,
-                proc_start,
-                out0_ts,
-                out1_ts,
-                queue_latency,
-                proc0,
-                proc1,
-                inter);
+void FilterBlock::publishLive(uint64_t now)
+{
+    LiveBlockStats& live = live_.working();
+    live.items = queueSizeSampleCount;
+    live.outputs = profiler_.histogram().count();
+    live.dropped = missingPairs;
+    live.deadlineMisses = pairDeadline.missed() + gapDeadline.missed();
+    live.stall_ns = idleNs;
+    live.busy_ns = util_.busyNs(now);
+    live.idle_ns = util_.idleNs(now);
+    live.queueDepthSum = totalQueueSizeSamples;
+    live.queueSamples = queueSizeSampleCount;
+    live.queueDepth = in_.size();
+    live.queueCapacity = in_.capacity();
+    if (perf_.enabled()) perf_.sample(live.perf);
+    live_.publish(now);
+}
+
+// ========================
+// Pooled execution
+// ========================
+
+void FilterBlock::startSteps()
+{
+    running = true;
+    perf_.markPooled();
+    profiler_.startBlock(nowFn());
+    ready.store(true, std::memory_order_release);
+}
+
+Block::StepResult FilterBlock::step(size_t maxItems)
+{
+    DataPair pair;
+    if (maxItems == 0 || !in_.try_pop(pair)) {
+        if (in_.exhausted()) {
+            flushWithZeros();
+            ready.store(false, std::memory_order_release);
+            return StepResult::Done;
         }
+        markIdle();
+        return StepResult::Idle;
     }
 
-    ready.store(false, std::memory_order_release);
+    CYNLR_TRACE_SCOPE("filter batch");
+    size_t processed = 0;
+    do {
+        markBusy();
+        if (pair.seq == std::numeric_limits<uint64_t>::max()) {
+            flushWithZeros();
+            ready.store(false, std::memory_order_release);
+            return StepResult::Done;
+        }
+        processPair(pair);
+        ++processed;
+    } while (processed < maxItems && in_.try_pop(pair));
+    return StepResult::Progress;
+}
+
+void FilterBlock::stopSteps()
+{
+    running = false;
+    profiler_.stopBlock(nowFn());
+    if (live_.enabled()) publishLive(nowFn());
+
+    if (metrics) {
+        if (shedRunPairs > 0) endShedRun();
+        metrics->flush();
+    }
 }
 
 // ========================
@@ -291,6 +446,23 @@ void FilterBlock::printStats() const
             << " max=" << max_queue_latency_ns << "\n";
     }
 
+    if (seqGaps > 0)
+        std::cout << "Sequence gaps: " << seqGaps << " (" << missingPairs << " pairs missing upstream)\n";
+
+    if (idleNs > 0)
+        std::cout << "Idle (input empty): " << idleNs / 1e6 << " ms\n";
+
+    util_.print();
+    pairDeadline.printStats();
+    gapDeadline.printStats();
+    stages_.printStats();
+    perf_.print(2 * queueSizeSampleCount);
+    if (metrics && metrics->droppedRecords() > 0)
+        std::cout << "Metrics dropped: " << metrics->droppedRecords() << " records (" << metrics->dropReason() << ")\n";
+    if (shedPairs > 0)
+        std::cout << "Metrics shed: " << shedPairs << " pairs not recorded (deadline watchdog)\n";
+    if (metrics) sampler_.printStats();
+
     // Print processing time from profiler
     if (stats.count > 0)
     {
@@ -318,8 +490,8 @@ void FilterBlock::printStats() const
         std::cout << "  Min queue size: " << min_qsize << "\n";
         std::cout << "  Max queue size: " << maxQueueSize << "\n";
         
-        if (queue) {
-            size_t capacity = queue->capacity();
+        if (in_.connected()) {
+            size_t capacity = in_.capacity();
             double utilization = (avg_queue_size / capacity) * 100.0;
             std::cout << "  Queue capacity: " << capacity << "\n";
             std::cout << "  Avg utilization: " << utilization << "%\n";
@@ -0,0 +1,183 @@
+#include "MultiPipeline.h"
+#include "FilterBlock.h"
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+
+// "cpu=<list>" through the --place parser, so lists are validated the same way.
+static bool parseCpus(const std::string& list, std::vector<int>& out) {
+    std::string block;
+    ThreadPlacement p;
+    if (!parsePlacementSpec("pipeline:cpu=" + list, block, p)) return false;
+    out = p.cpus;
+    return true;
+}
+
+bool applyPipelineSpec(const std::string& spec, Config& config, std::string& name)
+{
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ';')) {
+        if (item.empty()) continue;
+        size_t eq = item.find('=');
+        if (eq == std::string::npos || eq == 0) {
+            std::cerr << "Bad --pipeline entry (expected key=value): " << item << "\n";
+            return false;
+        }
+        std::string key = item.substr(0, eq);
+        std::string val = item.substr(eq + 1);
+
+        try {
+            if (key == "name") {
+                if (val.empty()) { std::cerr << "Empty pipeline name\n"; return false; }
+                name = val;
+            }
+            else if (key == "mode") {
+                if (val == "random") config.mode = InputMode::RANDOM;
+                else if (val == "csv") config.mode = InputMode::CSV;
+                else if (val == "raw") config.mode = InputMode::RAW;
+                else if (val == "pgm") config.mode = InputMode::PGM;
+                else if (val == "replay") config.mode = InputMode::REPLAY;
+                else { std::cerr << "Unknown mode: " << val << "\n"; return false; }
+            }
+            else if (key == "csv") config.csvFile = val;
+            else if (key == "raw") config.rawFile = val;
+            else if (key == "replay") config.replayFile = val;
+            else if (key == "columns") {
+                config.columns = std::stoi(val);
+                config.columnsSet = true;
+            }
+            else if (key == "T_ns") config.T_ns = std::stoull(val);
+            else if (key == "threshold") config.threshold = std::stod(val);
+            else if (key == "filterfile") {
+                config.filterFile = val;
+                config.filter = FilterType::FILE;
+            }
+            else if (key == "queue-capacity") config.queueCapacity = static_cast<size_t>(std::stoul(val));
+            else if (key == "overload") {
+                if (!parseOverloadPolicy(val, config.overload)) {
+                    std::cerr << "Unknown overload policy: " << val << "\n";
+                    return false;
+                }
+            }
+            else if (key == "executor") {
+                if (val == "threads") config.execution = ExecutionMode::THREADS;
+                else if (val == "pool") config.execution = ExecutionMode::POOL;
+                else { std::cerr << "Unknown executor: " << val << "\n"; return false; }
+            }
+            else if (key == "cpu" || key == "generator-cpu" || key == "filter-cpu") {
+                std::vector<int> cpus;
+                if (!parseCpus(val, cpus)) return false;
+                if (key != "filter-cpu") config.placements["generator"].cpus = cpus;
+                if (key != "generator-cpu") config.placements["filter"].cpus = cpus;
+            }
+            else {
+                std::cerr << "Unknown --pipeline key: " << key << "\n";
+                return false;
+            }
+        }
+        catch (const std::exception& ex) {
+            std::cerr << "Invalid value for pipeline key '" << key << "': " << ex.what() << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+PipelineSummary summarizePipeline(const std::string& name, const PipelineContext& ctx, const Config& config)
+{
+    PipelineSummary s;
+    s.name = name;
+    s.target = config.T_ns > 0 ? 1e9 / static_cast<double>(config.T_ns) : 0.0;
+
+    if (ctx.filter) {
+        const FilterBlock& f = *ctx.filter;
+        BlockProfiler::Stats st = f.profiler_.getStats();
+        s.pairs = f.totalPairsProcessed;
+        s.elapsed_ms = st.execution_time_ms;
+        if (f.totalPairsProcessed > 0) {
+            s.latency_avg_ns = static_cast<double>(f.sum_queue_latency_ns) / f.totalPairsProcessed;
+            s.latency_max_ns = f.max_queue_latency_ns;
+        }
+        s.proc_p50_ns = st.median_ns;
+        s.proc_p99_ns = st.p99_ns;
+        s.proc = f.profiler_.histogram();
+    } else if (ctx.generator) {
+        BlockProfiler::Stats st = ctx.generator->profileStats();
+        s.pairs = st.count;
+        s.elapsed_ms = st.execution_time_ms;
+    }
+    if (s.elapsed_ms > 0)
+        s.throughput = s.pairs * 1000.0 / s.elapsed_ms;
+    return s;
+}
+
+AggregateSummary aggregateSummaries(const std::vector<PipelineSummary>& summaries, double wall_ms)
+{
+    AggregateSummary a;
+    a.pipelines = summaries.size();
+    a.wall_ms = wall_ms;
+
+    double weightedLatency = 0.0;
+    bool first = true;
+    LatencyHistogram proc(summaries.empty() ? LatencyHistogram::kDefaultSubBucketBits
+                                            : summaries.front().proc.subBucketBits());
+    for (const auto& s : summaries) {
+        proc.merge(s.proc);
+        a.pairs += s.pairs;
+        weightedLatency += s.latency_avg_ns * s.pairs;
+        if (a.worstLatency.empty() || s.latency_max_ns > a.latency_max_ns) {
+            a.latency_max_ns = s.latency_max_ns;
+            a.worstLatency = s.name;
+        }
+        if (first || s.throughput < a.min_throughput) {
+            a.min_throughput = s.throughput;
+            a.slowest = s.name;
+            first = false;
+        }
+    }
+    if (a.pairs > 0) a.latency_avg_ns = weightedLatency / a.pairs;
+    a.proc_p50_ns = proc.percentile(0.50);
+    a.proc_p99_ns = proc.percentile(0.99);
+    a.proc_max_ns = proc.max();
+    if (wall_ms > 0) a.throughput = a.pairs * 1000.0 / wall_ms;
+    return a;
+}
+
+void printPipelineSummaries(const std::vector<PipelineSummary>& summaries, double wall_ms)
+{
+    std::cout << "\n=== Per-pipeline summary ===\n";
+    std::cout << std::left << std::setw(14) << "pipeline" << std::right
+              << std::setw(12) << "pairs"
+              << std::setw(14) << "pairs/sec"
+              << std::setw(14) << "target/sec"
+              << std::setw(14) << "lat avg ns"
+              << std::setw(14) << "lat max ns"
+              << std::setw(12) << "proc p50"
+              << std::setw(12) << "proc p99" << "\n";
+    for (const auto& s : summaries) {
+        std::cout << std::left << std::setw(14) << s.name << std::right
+                  << std::setw(12) << s.pairs
+                  << std::setw(14) << static_cast<uint64_t>(s.throughput)
+                  << std::setw(14) << static_cast<uint64_t>(s.target)
+                  << std::setw(14) << static_cast<uint64_t>(s.latency_avg_ns)
+                  << std::setw(14) << s.latency_max_ns
+                  << std::setw(12) << s.proc_p50_ns
+                  << std::setw(12) << s.proc_p99_ns << "\n";
+    }
+
+    AggregateSummary a = aggregateSummaries(summaries, wall_ms);
+    std::cout << "\n=== Aggregate (" << a.pipelines << " pipelines) ===\n";
+    std::cout << "Total pairs:          " << a.pairs << "\n";
+    std::cout << "Wall time:            " << a.wall_ms << " ms\n";
+    std::cout << "Aggregate throughput: " << a.throughput << " pairs/sec\n";
+    std::cout << "Latency (ns):         avg=" << a.latency_avg_ns
+              << " max=" << a.latency_max_ns << " (" << a.worstLatency << ")\n";
+    if (a.proc_max_ns > 0)
+        std::cout << "Processing (ns):      p50=" << a.proc_p50_ns << " p99=" << a.proc_p99_ns
+                  << " max=" << a.proc_max_ns << " (all outputs)\n";
+    std::cout << "Slowest pipeline:     " << a.slowest << " (" << a.min_throughput << " pairs/sec)\n";
+    std::cout << "============================\n";
+}
@@ -1,25 +1,399 @@
 #include "Pipeline.h"
 #include "DataGenerator.h"
 #include "FilterBlock.h"
+#include "DeadlineMonitor.h"
+#include "StatsReporter.h"
 #include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <unordered_map>
+
+// Pooled steps: an idle block due within kStepSpinNs is resubmitted at once (a timer would
+// overshoot); a parked block with nothing due is rerun after kStepParkNs if nobody wakes it.
+static const uint64_t kStepSpinNs = 50000;
+static const uint64_t kStepParkNs = 1000000;
+
+// ========================
+// Graph wiring
+// ========================
+
+static PortBase* findPort(const std::vector<PortBase*>& ports, const std::string& name) {
+    for (PortBase* p : ports) {
+        if (p && p->name() == name) return p;
+    }
+    return nullptr;
+}
+
+bool Pipeline::resolvePorts(Block* from, const std::string& outPort,
+                            Block* to, const std::string& inPort,
+                            PortBase*& out, PortBase*& in) const
+{
+    if (!from || !to) {
+        std::cerr << "[Pipeline] connect: null block\n";
+        return false;
+    }
+    out = findPort(from->outputPorts(), outPort);
+    if (!out) {
+        std::cerr << "[Pipeline] " << from->name() << " has no output port '" << outPort << "'\n";
+        return false;
+    }
+    in = findPort(to->inputPorts(), inPort);
+    if (!in) {
+        std::cerr << "[Pipeline] " << to->name() << " has no input port '" << inPort << "'\n";
+        return false;
+    }
+    return true;
+}
+
+bool Pipeline::connect(Block* from, const std::string& outPort,
+                       Block* to, const std::string& inPort,
+                       size_t capacity)
+{
+    PortBase* out = nullptr;
+    PortBase* in = nullptr;
+    if (!resolvePorts(from, outPort, to, inPort, out, in)) return false;
+    return connectPorts(from, *out, to, *in, capacity, false, true);
+}
+
+bool Pipeline::connectBroadcast(Block* from, const std::string& outPort,
+                                Block* to, const std::string& inPort,
+                                size_t capacity, bool critical)
+{
+    PortBase* out = nullptr;
+    PortBase* in = nullptr;
+    if (!resolvePorts(from, outPort, to, inPort, out, in)) return false;
+    return connectPorts(from, *out, to, *in, capacity, true, critical);
+}
+
+bool Pipeline::connectPorts(Block* from, PortBase& out, Block* to, PortBase& in, size_t capacity,
+                            bool broadcast, bool critical)
+{
+    std::string label = from->name() + "." + out.name() + " -> " + to->name() + "." + in.name();
+    if (out.type() != in.type()) {
+        std::cerr << "[Pipeline] Type mismatch on " << label << ": "
+                  << out.type().name() << " vs " << in.type().name() << "\n";
+        return false;
+    }
+
+    // A broadcast output owns a single ring shared by all of its readers.
+    EdgeBase* edge = nullptr;
+    if (broadcast) {
+        for (auto& e : edges_) {
+            if (e->fromPort == &out && e->isBroadcast()) { edge = e.get(); break; }
+        }
+    }
+    if (!edge) {
+        std::unique_ptr<EdgeBase> owned = broadcast ? out.makeBroadcastEdge(capacity) : out.makeEdge(capacity);
+        if (!out.attach(*owned)) {
+            std::cerr << "[Pipeline] Could not attach edge " << label << "\n";
+            return false;
+        }
+        owned->from = from;
+        owned->fromPort = &out;
+        edge = owned.get();
+        edges_.push_back(std::move(owned)); // the output port now points into it
+    }
+    size_t reader = broadcast ? edge->addReader(critical) : 0;
+    if (!in.attach(*edge, reader)) {
+        std::cerr << "[Pipeline] Could not attach edge " << label << "\n";
+        return false;
+    }
+
+    links_.push_back(Link{ from, to, edge, label, critical });
+    return true;
+}
+
+// Kahn's algorithm; ties keep insertion order so linear pipelines stay in addBlock order.
+bool Pipeline::topologicalOrder(std::vector<Block*>& order) const
+{
+    std::unordered_map<Block*, size_t> indegree;
+    for (const auto& b : blocks_) indegree[b.get()] = 0;
+    for (const auto& l : links_) ++indegree[l.to];
+
+    order.clear();
+    std::vector<bool> placed(blocks_.size(), false);
+    while (order.size() < blocks_.size()) {
+        bool progress = false;
+        for (size_t i = 0; i < blocks_.size(); ++i) {
+            Block* b = blocks_[i].get();
+            if (placed[i] || indegree[b] != 0) continue;
+            placed[i] = true;
+            order.push_back(b);
+            for (const auto& l : links_) {
+                if (l.from == b) --indegree[l.to];
+            }
+            progress = true;
+        }
+        if (!progress) return false;
+    }
+    return true;
+}
+
+// ========================
+// Lifecycle
+// ========================
+
+bool Pipeline::start(WorkStealingPool* pool, size_t batch)
+{
+    std::vector<Block*> order;
+    if (!topologicalOrder(order)) {
+        std::cerr << "[Pipeline] Graph has a cycle; not starting\n";
+        return false;
+    }
+
+    pool_ = pool;
+    batch_ = batch > 0 ? batch : 1;
+
+    // Consumers first, so every queue has a reader before its producer runs.
+    started_.clear();
+    std::vector<StepTask*> pooled;
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        Block* b = *it;
+        started_.push_back(b);
+
+        if (pool_ && b->supportsStep()) {
+            std::cout << "[Pipeline] Scheduling " << b->name() << " on the pool\n";
+            std::shared_ptr<StepTask> task = std::make_shared<StepTask>();
+            task->block = b;
+            task->pool = pool_;
+            task->batch = batch_;
+            for (auto& e : edges_) {
+                if (e->from == b) task->outputs.push_back(e.get());
+            }
+            b->startSteps();
+            pooled.push_back(task.get());
+            tasks_.push_back(std::move(task));
+            continue;
+        }
+
+        std::cout << "[Pipeline] Starting " << b->name() << "\n";
+        b->start();
+
+        if (!b->inputPorts().empty()) {
+            // Ready handshake, bounded so a block that never reports ready cannot hang startup
+            for (int i = 0; i < 1000 && !b->isReady(); ++i)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // Tasks are submitted once every neighbour is known, so the first park can be woken.
+    for (StepTask* t : pooled) {
+        for (const Link& l : links_) {
+            Block* other = l.from == t->block ? l.to : l.to == t->block ? l.from : nullptr;
+            if (!other) continue;
+            StepTask* n = nullptr;
+            for (StepTask* p : pooled) {
+                if (p->block == other) n = p;
+            }
+            if (!n) t->wakeable = false;
+            else if (std::find(t->neighbours.begin(), t->neighbours.end(), n) == t->neighbours.end())
+                t->neighbours.push_back(n);
+        }
+    }
+    for (StepTask* t : pooled) pool_->submit([t] { runStep(t); });
+    return true;
+}
+
+void Pipeline::runStep(StepTask* t)
+{
+    // Wake-ups from here on are seen by this step or turn the park below into a rerun.
+    t->state.store(STEP_RUNNING, std::memory_order_seq_cst);
+    Block::StepResult r = t->block->step(t->batch);
+    if (r == Block::StepResult::Done) {
+        // Same as stop() for a threaded block: downstream drains and sees end-of-stream.
+        for (EdgeBase* e : t->outputs) e->shutdown();
+        for (StepTask* n : t->neighbours) wakeStep(n);
+        t->state.store(STEP_DONE, std::memory_order_seq_cst);
+        // Notify under the lock: once it is released, stop() may return and destroy the task.
+        std::lock_guard<std::mutex> lock(t->mutex);
+        t->done = true;
+        t->doneCv.notify_all();
+        return;
+    }
+
+    if (r == Block::StepResult::Progress) {
+        t->idleStreak = 0;
+        // Input for the consumers, room for the producers
+        for (StepTask* n : t->neighbours) wakeStep(n);
+    } else {
+        uint64_t wait = t->block->idleWaitNs();
+        if (t->wakeable && (wait == 0 || wait > kStepSpinNs)) {
+            int running = STEP_RUNNING;
+            if (t->state.compare_exchange_strong(running, STEP_PARKED, std::memory_order_seq_cst)) {
+                // Rerun shortly before the block is due (the last kStepSpinNs are polled), or
+                // after the backstop; the timer keeps the task alive should the pipeline stop first.
+                std::shared_ptr<StepTask> keep = t->shared_from_this();
+                t->pool->submitAfter(wait > 0 ? wait - kStepSpinNs : kStepParkNs,
+                                     [keep] { wakeStep(keep.get()); });
+                return;
+            }
+            // Woken during the step: there may be work already
+        } else if (++t->idleStreak > 64) {
+            // Long idle poll: give other threads on this core a turn before polling again.
+            std::this_thread::yield();
+        }
+    }
+    // Back of the worker's deque: the other tasks queued there run first.
+    t->pool->submit([t] { runStep(t); });
+}
+
+void Pipeline::wakeStep(StepTask* t)
+{
+    int s = t->state.load(std::memory_order_seq_cst);
+    for (;;) {
+        if (s == STEP_PARKED) {
+            if (t->state.compare_exchange_weak(s, STEP_RUNNING, std::memory_order_seq_cst)) {
+                t->pool->submit([t] { runStep(t); });
+                return;
+            }
+        } else if (s == STEP_RUNNING) {
+            if (t->state.compare_exchange_weak(s, STEP_NOTIFIED, std::memory_order_seq_cst)) return;
+        } else {
+            return; // already notified, or done
+        }
+    }
+}
+
+void Pipeline::stop()
+{
+    // Producers first: each block's outputs are closed once it stops,
+    // so downstream blocks drain their queues and see end-of-stream.
+    for (auto it = started_.rbegin(); it != started_.rend(); ++it) {
+        Block* b = *it;
+        std::cout << "[Pipeline] Stopping " << b->name() << "\n";
+
+        StepTask* task = nullptr;
+        for (auto& t : tasks_) {
+            if (t->block == b) { task = t.get(); break; }
+        }
+        if (task) {
+            b->requestStop();
+            wakeStep(task); // a parked source would otherwise wait for its timer
+            std::unique_lock<std::mutex> lock(task->mutex);
+            task->doneCv.wait(lock, [task] { return task->done; });
+            lock.unlock();
+            b->stopSteps();
+            continue;
+        }
+
+        b->stop();
+        for (auto& e : edges_) {
+            if (e->from == b) e->shutdown();
+        }
+    }
+    started_.clear();
+    tasks_.clear();
+}
+
+void Pipeline::printStats() const
+{
+    std::cout << "\n=== Pipeline Statistics ===\n";
+    if (pool_) {
+        std::cout << "Executor: work-stealing pool (" << pool_->size() << " workers, batch "
+                  << batch_ << ")\n";
+    }
+    if (!links_.empty()) {
+        std::cout << "\nEdges:\n";
+        for (const auto& l : links_) {
+            std::cout << "  " << l.label << " (";
+            if (l.edge->isBroadcast())
+                std::cout << "broadcast" << (l.critical ? "" : ", non-critical") << ", ";
+            std::cout << "capacity " << l.edge->capacity() << ")\n";
+        }
+    }
+    for (const auto& b : blocks_) {
+        std::cout << "\n[" << b->name() << "]\n";
+        b->printStats();
+    }
+    std::cout << "===========================\n";
+}
+
+void Pipeline::printPlacement() const
+{
+    std::cout << "\n=== Thread placement ===\n";
+    if (pool_)
+        std::cout << "  pool: " << pool_->size() << " workers (--place=pool:...)\n";
+    for (const auto& b : blocks_) {
+        bool pooled = false;
+        for (const auto& t : tasks_) pooled = pooled || t->block == b.get();
+        if (pooled) continue;
+        PlacementReport r;
+        bool have = false;
+        // Workers apply their placement as they start; give them a moment.
+        for (int i = 0; i < 500 && !(have = b->placementReport(r)); ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        if (have)
+            std::cout << "  " << b->name() << ": " << describePlacement(r) << "\n";
+    }
+    for (const auto& l : links_) {
+        int node = memoryNumaNode(l.edge->storage());
+        std::cout << "  " << l.label << ": buffer on node "
+                  << (node >= 0 ? std::to_string(node) : std::string("?")) << "\n";
+    }
+    std::cout << "========================\n";
+}
+
+void Pipeline::watchDeadlines(DeadlineWatchdog& watchdog, bool shed)
+{
+    for (auto& b : blocks_) {
+        Block* block = b.get();
+        std::vector<DeadlineMonitor*> monitors;
+        for (DeadlineMonitor* m : block->deadlineMonitors()) {
+            if (m->budget() > 0) monitors.push_back(m);
+        }
+        std::function<void(bool)> hook;
+        if (shed && block->hasOptionalWork()) hook = [block](bool on) { block->shedOptionalWork(on); };
+        watchdog.watch(block->name(), monitors, hook);
+    }
+}
+
+void Pipeline::reportLiveStats(StatsReporter& reporter, const std::string& prefix)
+{
+    for (auto& b : blocks_) {
+        if (LiveStatsPublisher* live = b->liveStats())
+            reporter.watch(prefix + b->name(), live);
+    }
+}
+
+// ========================
+// Factory
+// ========================
 
 PipelineContext buildPipeline(const Config& config,
-                              ThreadSafeQueue<DataPair>* queue,
                               MetricsCollector* metrics)
 {
     PipelineContext ctx;
     ctx.generator = nullptr;
+    ctx.execution = config.execution;
+    // Default batch: one line of pairs
+    ctx.batch = config.batchPairs > 0 ? config.batchPairs
+                                      : static_cast<size_t>(std::max(1, config.columns / 2));
 
     // Always add DataGenerator (source block)
+    const std::string& inputFile =
+        (config.mode == InputMode::CSV) ? config.csvFile :
+        (config.mode == InputMode::REPLAY) ? config.replayFile : config.rawFile;
     auto gen = std::make_unique<DataGenerator>(
-        queue,
+        nullptr,
         config.columns,
         config.T_ns,
         config.mode,
-        config.csvFile
+        inputFile
     );
+    gen->setCaptureFile(config.captureFile);
+    gen->setReplayTiming(config.replayTiming);
+    gen->setInputOptions(config.input);
+    gen->setOverloadPolicy(config.overload);
+    gen->setProfiling(config.profilePrecisionBits, config.profileRawSamples);
+    gen->setPerfCounters(config.perfCounters);
+    if (config.saturate)
+        gen->setStopAfter(config.saturatePixels / 2, config.saturateMs * 1000000ULL);
+    auto genPlacement = config.placements.find("generator");
+    if (genPlacement != config.placements.end())
+        gen->setPlacement(genPlacement->second);
     ctx.generator = gen.get(); // store pointer before moving ownership
-    ctx.pipeline.addBlock(std::move(gen));
+    Block* source = ctx.pipeline.addBlock(std::move(gen));
 
     // Conditionally add FilterBlock
     if (config.enableFilter) {
@@ -27,17 +401,35 @@ PipelineContext buildPipeline(const Config& config,
         auto filter = std::make_unique<FilterBlock>(
             config.columns,
             config.threshold,
-            queue,
+            nullptr,
             metrics,
             useFileKernel,
             config.filterFile
         );
-        ctx.pipeline.addBlock(std::move(filter));
+        ThreadPlacement filterPlacement;
+        auto it = config.placements.find("filter");
+        if (it != config.placements.end()) filterPlacement = it->second;
+        filter->setPlacement(filterPlacement);
+        filter->setDeadlineBudgets(config.T_ns, config.outputBudget_ns);
+        filter->profiler_.configure(config.profilePrecisionBits, config.profileRawSamples);
+        filter->setPerfCounters(config.perfCounters);
+        filter->setMetricsSampling(config.metricsSampling);
+        ctx.filter = filter.get();
+        Block* sink = ctx.pipeline.addBlock(std::move(filter));
+
+        // numa: allocate the edge from the consumer's CPUs so first-touch
+        // puts the queue pages on the filter's node.
+        std::vector<int> allocCpus = filterPlacement.numaLocal ? filterPlacement.cpus : std::vector<int>();
+        runPinned(allocCpus, [&] {
+            if (config.broadcast)
+                ctx.pipeline.connectBroadcast(source, "out", sink, "in", config.queueCapacity);
+            else
+                ctx.pipeline.connect(source, "out", sink, "in", config.queueCapacity);
+        });
     }
 
-    // Future: Add more blocks here based on config flags
-    // if (config.enableTransform) { ctx.pipeline.addBlock(...); }
-    // if (config.enableAggregator) { ctx.pipeline.addBlock(...); }
+    // Further stages (correction, detection, output) add a block here and
+    // connect() its ports; fan-out/fan-in is just more edges on the same port.
 
     return ctx;
-}
\ No newline at end of file
+}
@@ -0,0 +1,243 @@
+#include "Simulation.h"
+#include "Config.h"
+#include "DataGenerator.h"
+#include "FilterBlock.h"
+#include "ThreadSafeQueue.h"
+#include "Util.h"
+#include "profiler/LatencyHistogram.h"
+
+#include <iostream>
+#include <sstream>
+#include <random>
+#include <limits>
+#include <algorithm>
+#include <vector>
+
+uint64_t VirtualClock::now_ = 1;
+
+static constexpr uint64_t kWaiting = std::numeric_limits<uint64_t>::max();
+static constexpr uint64_t kStart = 1;                // 0 means "unset" to the profilers
+static constexpr uint64_t kDefaultRandomPairs = 1000000;
+
+bool parseSimulationSpec(const std::string& spec, SimulationOptions& opts)
+{
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ';')) {
+        if (item.empty()) continue;
+        size_t eq = item.find('=');
+        if (eq == std::string::npos || eq == 0) {
+            std::cerr << "Bad --simulate entry (expected key=value): " << item << "\n";
+            return false;
+        }
+        std::string key = item.substr(0, eq);
+        std::string val = item.substr(eq + 1);
+
+        try {
+            if (key == "gen") opts.gen_ns = std::stoull(val);
+            else if (key == "push") opts.push_ns = std::stoull(val);
+            else if (key == "filter") opts.filter_ns = std::stoull(val);
+            else if (key == "metrics") opts.metrics_ns = std::stoull(val);
+            else if (key == "stall") opts.stall_ns = std::stoull(val);
+            else if (key == "stall-rate") {
+                opts.stall_rate = std::stod(val);
+                if (opts.stall_rate < 0.0 || opts.stall_rate > 1.0) {
+                    std::cerr << "stall-rate must be between 0 and 1\n";
+                    return false;
+                }
+            }
+            else if (key == "pairs") opts.pairs = std::stoull(val);
+            else if (key == "ms") opts.duration_ms = std::stoull(val);
+            else if (key == "seed") opts.seed = std::stoull(val);
+            else {
+                std::cerr << "Unknown --simulate key: " << key << "\n";
+                return false;
+            }
+        }
+        catch (const std::exception& ex) {
+            std::cerr << "Invalid value for --simulate key '" << key << "': " << ex.what() << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Keeps the queue latency of the pair the filter just took (virtual pop - stamp).
+class SimCollector : public MetricsCollector {
+public:
+    void recordPair(uint64_t, uint64_t, bool, uint64_t, uint64_t, uint64_t, uint64_t,
+                    uint64_t queue_latency_ns, uint64_t, uint64_t, uint64_t) override {
+        lastQueueLatency = queue_latency_ns;
+    }
+    void flush() override {}
+
+    uint64_t lastQueueLatency = 0;
+};
+
+bool runSimulation(const Config& config, SimulationResult& out)
+{
+    const SimulationOptions& opts = config.sim;
+    out = SimulationResult();
+
+    const std::string& inputFile =
+        (config.mode == InputMode::CSV) ? config.csvFile :
+        (config.mode == InputMode::REPLAY) ? config.replayFile : config.rawFile;
+
+    VirtualClock::set(kStart);
+    ThreadSafeQueue<DataPair> queue(config.queueCapacity);
+    DataGenerator gen(&queue, config.columns, config.T_ns, config.mode, inputFile,
+                      VirtualClock::now, VirtualClock::sleep);
+    gen.setReplayTiming(config.replayTiming);
+    gen.setInputOptions(config.input);
+    gen.setOverloadPolicy(config.overload);
+    gen.setDeadlineBudget(0); // step time is modeled here, not measured
+
+    SimCollector collector;
+    FilterBlock filter(config.columns, config.threshold, &queue, &collector,
+                       config.filter == FilterType::FILE, config.filterFile);
+    filter.setClock(VirtualClock::now);
+    filter.setDeadlineBudgets(0, 0);
+
+    std::mt19937_64 rng(opts.seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    const uint64_t pairLimit = opts.pairs > 0 ? opts.pairs
+        : (config.mode == InputMode::RANDOM && opts.duration_ms == 0 ? kDefaultRandomPairs : 0);
+    const uint64_t endAt = opts.duration_ms > 0 ? kStart + opts.duration_ms * 1000000ULL : kWaiting;
+    const uint64_t metricsCost = config.stats ? opts.metrics_ns : 0;
+
+    LatencyHistogram latency;
+    std::vector<uint64_t> timeAtSize(queue.capacity() + 1, 0);
+    uint64_t filterBusy = 0;
+    uint64_t blockedSince = 0;
+
+    // Each actor's next event time; kWaiting = asleep until the other one wakes it.
+    uint64_t genAt = kStart;
+    uint64_t filterAt = kWaiting;
+    bool genDone = false;
+    uint64_t last = kStart;
+
+    uint64_t wall0 = util::now_ns();
+    gen.startSteps();
+    filter.startSteps();
+
+    while (true) {
+        // Filter first on ties: a pop at t frees space for a push at t.
+        bool runGen = !genDone && genAt < filterAt;
+        if (!runGen && filterAt == kWaiting) break;
+        uint64_t t = runGen ? genAt : filterAt;
+
+        timeAtSize[std::min(queue.size(), timeAtSize.size() - 1)] += t - last;
+        last = t;
+        VirtualClock::set(t);
+
+        if (runGen) {
+            Block::StepResult r = Block::StepResult::Done;
+            if (t < endAt && (pairLimit == 0 || out.generated < pairLimit))
+                r = gen.step(1);
+
+            if (r == Block::StepResult::Progress) {
+                ++out.generated;
+                if (blockedSince) {
+                    out.blocked_ns += t - blockedSince;
+                    blockedSince = 0;
+                }
+                genAt = t + opts.gen_ns + opts.push_ns;
+                if (filterAt == kWaiting) filterAt = t + opts.push_ns;
+            } else if (r == Block::StepResult::Idle) {
+                uint64_t due = gen.pendingDueNs();
+                if (due > t) {
+                    genAt = due;
+                } else {
+                    // Queue full: sleep until the filter frees a slot
+                    if (!blockedSince) blockedSince = t;
+                    genAt = kWaiting;
+                }
+            } else {
+                genDone = true;
+                queue.shutdown();
+                if (filterAt == kWaiting) filterAt = t;
+            }
+            continue;
+        }
+
+        uint64_t cost = opts.filter_ns + metricsCost;
+        bool stalled = opts.stall_rate > 0.0 && unit(rng) < opts.stall_rate;
+        if (stalled) cost += opts.stall_ns;
+
+        Block::StepResult r = filter.step(1);
+        if (r == Block::StepResult::Progress) {
+            ++out.processed;
+            if (stalled) ++out.stalls;
+            latency.record(collector.lastQueueLatency + cost);
+            filterBusy += cost;
+            filterAt = t + cost;
+            if (genAt == kWaiting) genAt = t;
+        } else if (r == Block::StepResult::Idle) {
+            filterAt = kWaiting;
+        } else {
+            break;
+        }
+    }
+
+    gen.stopSteps();
+    filter.stopSteps();
+    out.wall_ms = (util::now_ns() - wall0) / 1e6;
+
+    if (out.generated == 0 && config.mode != InputMode::RANDOM) {
+        std::cerr << "Simulation produced no pairs (input missing or empty).\n";
+        return false;
+    }
+
+    out.dropped = gen.droppedPairs();
+    out.virtual_ns = last - kStart;
+    out.target_rate = (config.mode != InputMode::REPLAY && config.T_ns > 0) ? 1e9 / config.T_ns : 0.0;
+    out.achieved_rate = out.virtual_ns > 0 ? out.processed * 1e9 / out.virtual_ns : 0.0;
+    out.filter_utilization = out.virtual_ns > 0 ? static_cast<double>(filterBusy) / out.virtual_ns : 0.0;
+
+    out.capacity = queue.capacity();
+    uint64_t area = 0;
+    for (size_t s = 0; s < timeAtSize.size(); ++s) {
+        area += timeAtSize[s] * s;
+        if (timeAtSize[s] > 0) out.occupancy_max = s;
+    }
+    out.occupancy_avg = out.virtual_ns > 0 ? static_cast<double>(area) / out.virtual_ns : 0.0;
+    uint64_t seen = 0;
+    for (size_t s = 0; s < timeAtSize.size(); ++s) {
+        seen += timeAtSize[s];
+        if (seen * 100 >= out.virtual_ns * 99) {
+            out.occupancy_p99 = s;
+            break;
+        }
+    }
+
+    out.latency_avg_ns = latency.avg();
+    out.latency_p50_ns = latency.percentile(0.50);
+    out.latency_p99_ns = latency.percentile(0.99);
+    out.latency_max_ns = latency.max();
+    return true;
+}
+
+void printSimulation(const SimulationResult& r)
+{
+    std::cout << "\n=== Simulation (virtual time) ===\n";
+    std::cout << "Simulated time:     " << r.virtual_ns / 1e6 << " ms (ran in " << r.wall_ms << " ms)\n";
+    std::cout << "Pairs:              " << r.generated << " generated, " << r.processed << " filtered";
+    if (r.dropped > 0) std::cout << ", " << r.dropped << " dropped";
+    std::cout << "\n";
+    std::cout << "Throughput:         " << static_cast<uint64_t>(r.achieved_rate) << " pairs/sec";
+    if (r.target_rate > 0) std::cout << " (target " << static_cast<uint64_t>(r.target_rate) << ")";
+    std::cout << "\n";
+    std::cout << "Filter utilisation: " << 100.0 * r.filter_utilization << "%";
+    if (r.stalls > 0) std::cout << " (" << r.stalls << " stalls)";
+    std::cout << "\n";
+    std::cout << "Queue occupancy:    avg=" << r.occupancy_avg << " p99=" << r.occupancy_p99
+              << " max=" << r.occupancy_max << " of " << r.capacity << "\n";
+    if (r.blocked_ns > 0 && r.virtual_ns > 0)
+        std::cout << "Generator blocked:  " << r.blocked_ns / 1e6 << " ms ("
+                  << 100.0 * r.blocked_ns / r.virtual_ns << "% of the run)\n";
+    std::cout << "Latency (ns):       avg=" << r.latency_avg_ns << " p50=" << r.latency_p50_ns
+              << " p99=" << r.latency_p99_ns << " max=" << r.latency_max_ns
+              << " (stamp -> outputs done)\n";
+    std::cout << "=================================\n";
+}
@@ -0,0 +1,206 @@
+#include "StatsReporter.h"
+#include "profiler/LiveStats.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+// Blocks publish at most this often (or four times per report interval, if shorter).
+static constexpr uint64_t kMaxPublishInterval_ns = 1000000;
+
+// One block's figures over an interval
+struct IntervalStats {
+    uint64_t items = 0;
+    double rate = 0.0;
+    uint64_t lat_p50 = 0, lat_p99 = 0, lat_max = 0;
+    uint64_t svc_p50 = 0, svc_p99 = 0, svc_max = 0;
+    double queue_avg = 0.0;
+    uint64_t queue_last = 0, queue_capacity = 0;
+    uint64_t dropped = 0;
+    uint64_t misses = 0;
+    double stall_pct = 0.0;
+    double busy_pct = -1.0;   // < 0: no busy / idle time in the interval
+    uint64_t total = 0;
+    PerfSample perf{}; // counter deltas over the interval (mask 0 = not collected)
+};
+
+static std::string jsonEscape(const std::string& s)
+{
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+static void intervalOf(const LiveBlockStats& cur, const LiveBlockStats& last, uint64_t start_ns,
+                       IntervalStats& s)
+{
+    uint64_t from = last.published_ns ? last.published_ns : start_ns;
+    uint64_t dt = cur.published_ns > from ? cur.published_ns - from : 0;
+    s.items = cur.items - last.items;
+    s.total = cur.items;
+    s.rate = dt > 0 ? s.items * 1e9 / dt : 0.0;
+
+    LiveHistogram h;
+    cur.latency.since(last.latency, h);
+    s.lat_p50 = h.percentile(0.50);
+    s.lat_p99 = h.percentile(0.99);
+    s.lat_max = h.max;
+    cur.service.since(last.service, h);
+    s.svc_p50 = h.percentile(0.50);
+    s.svc_p99 = h.percentile(0.99);
+    s.svc_max = h.max;
+
+    uint64_t samples = cur.queueSamples - last.queueSamples;
+    s.queue_avg = samples ? static_cast<double>(cur.queueDepthSum - last.queueDepthSum) / samples : 0.0;
+    s.queue_last = cur.queueDepth;
+    s.queue_capacity = cur.queueCapacity;
+    s.dropped = cur.dropped - last.dropped;
+    s.misses = cur.deadlineMisses - last.deadlineMisses;
+    s.stall_pct = dt > 0 ? std::min(100.0, 100.0 * (cur.stall_ns - last.stall_ns) / dt) : 0.0;
+    uint64_t busy = cur.busy_ns - last.busy_ns, idle = cur.idle_ns - last.idle_ns;
+    if (busy + idle > 0) s.busy_pct = 100.0 * busy / (busy + idle);
+    // Counters start at zero when the worker opens them, so the first interval is cur itself.
+    s.perf = last.perf.mask ? perfDelta(cur.perf, last.perf) : cur.perf;
+}
+
+// Per-pixel hardware counter figures: ", IPC 1.52, 38.1 cycles/px, ..." or JSON members.
+static void perfFields(const IntervalStats& s, bool json, std::ostream& line)
+{
+    const PerfSample& p = s.perf;
+    double pixels = 2.0 * s.items;
+    if (p.mask == 0 || s.items == 0) return;
+    static const char* const kText[] = { "cycles/px", "instr/px", "L1D-miss/px", "LLC-miss/px", "br-miss/px" };
+    static const char* const kJson[] = { "cycles_px", "instr_px", "l1d_miss_px", "llc_miss_px", "branch_miss_px" };
+
+    line << std::setprecision(2);
+    if (json) {
+        line << ",\"perf\":{\"context_switches\":" << p.value[PERF_CONTEXT_SWITCHES];
+        if (p.has(PERF_CYCLES) && p.has(PERF_INSTRUCTIONS) && p.value[PERF_CYCLES] > 0)
+            line << ",\"ipc\":" << static_cast<double>(p.value[PERF_INSTRUCTIONS]) / p.value[PERF_CYCLES];
+        for (int e = 0; e < PERF_CONTEXT_SWITCHES; ++e)
+            if (p.has(e)) line << ",\"" << kJson[e] << "\":" << p.value[e] / pixels;
+        line << "}";
+        return;
+    }
+    if (p.has(PERF_CYCLES) && p.has(PERF_INSTRUCTIONS) && p.value[PERF_CYCLES] > 0)
+        line << ", IPC " << static_cast<double>(p.value[PERF_INSTRUCTIONS]) / p.value[PERF_CYCLES];
+    for (int e = 0; e < PERF_CONTEXT_SWITCHES; ++e)
+        if (p.has(e)) line << ", " << p.value[e] / pixels << " " << kText[e];
+    if (p.value[PERF_CONTEXT_SWITCHES] > 0) line << ", " << p.value[PERF_CONTEXT_SWITCHES] << " ctx switches";
+}
+
+StatsReporter::StatsReporter(uint64_t interval_ms, ReportFormat format, std::ostream& out)
+    : interval_ms_(interval_ms > 0 ? interval_ms : 1), format_(format), out_(out),
+      current_(new LiveBlockStats())
+{
+}
+
+StatsReporter::~StatsReporter()
+{
+    stop();
+}
+
+void StatsReporter::watch(const std::string& name, LiveStatsPublisher* live)
+{
+    if (!live) return;
+    live->enable(std::min(kMaxPublishInterval_ns, interval_ms_ * 1000000 / 4));
+    std::unique_ptr<LiveBlockStats> last(new LiveBlockStats());
+    live->read(*last);
+    watched_.push_back(Watched{ name, live, std::move(last) });
+}
+
+void StatsReporter::start()
+{
+    if (worker_.joinable()) return;
+    stopping_ = false;
+    start_ns_ = util::now_ns();
+    worker_ = std::thread(&StatsReporter::run, this);
+}
+
+void StatsReporter::stop()
+{
+    if (!worker_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+    poll();
+}
+
+void StatsReporter::poll()
+{
+    double elapsed_s = start_ns_ ? (util::now_ns() - start_ns_) / 1e9 : 0.0;
+    std::ostringstream line;
+    line << std::fixed;
+
+    if (format_ == ReportFormat::JSON)
+        line << "{\"t_s\":" << std::setprecision(3) << elapsed_s << ",\"blocks\":[";
+
+    for (size_t i = 0; i < watched_.size(); ++i) {
+        Watched& w = watched_[i];
+        w.live->read(*current_);
+        IntervalStats s;
+        intervalOf(*current_, *w.last, start_ns_, s);
+        std::swap(w.last, current_);
+
+        if (format_ == ReportFormat::JSON) {
+            if (i > 0) line << ",";
+            line << std::setprecision(1)
+                 << "{\"name\":\"" << jsonEscape(w.name) << "\""
+                 << ",\"items\":" << s.items << ",\"total\":" << s.total
+                 << ",\"rate\":" << s.rate
+                 << ",\"latency_ns\":{\"p50\":" << s.lat_p50 << ",\"p99\":" << s.lat_p99 << ",\"max\":" << s.lat_max << "}"
+                 << ",\"service_ns\":{\"p50\":" << s.svc_p50 << ",\"p99\":" << s.svc_p99 << ",\"max\":" << s.svc_max << "}"
+                 << ",\"queue\":{\"avg\":" << s.queue_avg << ",\"last\":" << s.queue_last
+                 << ",\"capacity\":" << s.queue_capacity << "}"
+                 << ",\"dropped\":" << s.dropped << ",\"deadline_misses\":" << s.misses
+                 << ",\"stall_pct\":" << s.stall_pct;
+            if (s.busy_pct >= 0.0) line << ",\"busy_pct\":" << s.busy_pct;
+            perfFields(s, true, line);
+            line << "}";
+            continue;
+        }
+
+        line << "[live " << std::setprecision(3) << elapsed_s << "s] " << w.name << ": ";
+        if (s.items == 0) {
+            line << "idle (" << s.total << " total)";
+        } else {
+            line << std::setprecision(0) << s.rate << " items/s";
+            if (s.lat_max > 0)
+                line << ", latency p50=" << s.lat_p50 << " p99=" << s.lat_p99 << " max=" << s.lat_max << " ns";
+            line << ", service p50=" << s.svc_p50 << " p99=" << s.svc_p99 << " max=" << s.svc_max << " ns"
+                 << std::setprecision(1) << ", queue avg=" << s.queue_avg << " last=" << s.queue_last;
+            if (s.queue_capacity > 0) line << "/" << s.queue_capacity;
+            if (s.dropped > 0) line << ", dropped " << s.dropped;
+            if (s.misses > 0) line << ", deadline misses " << s.misses;
+            line << ", stalled " << s.stall_pct << "%";
+            if (s.busy_pct >= 0.0) line << ", busy " << s.busy_pct << "%";
+            perfFields(s, false, line);
+        }
+        line << "\n";
+    }
+
+    if (format_ == ReportFormat::JSON) line << "]}\n";
+    out_ << line.str() << std::flush;
+    ++reports_;
+}
+
+void StatsReporter::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        cv_.wait_for(lock, std::chrono::milliseconds(interval_ms_), [this] { return stopping_; });
+        if (stopping_) break;
+        lock.unlock();
+        poll();
+        lock.lock();
+    }
+}
@@ -0,0 +1,271 @@
+#include "ThreadPlacement.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <windows.h>
+# include <psapi.h>
+#else
+# include <pthread.h>
+# include <sched.h>
+# include <unistd.h>
+# include <sys/syscall.h>
+# include <cerrno>
+#endif
+
+// ========================
+// Parsing
+// ========================
+
+// "2,4-5" -> {2,4,5}
+static bool parseCpuList(const std::string& s, std::vector<int>& out) {
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) continue;
+        size_t dash = item.find('-');
+        try {
+            int lo = std::stoi(item.substr(0, dash));
+            int hi = (dash == std::string::npos) ? lo : std::stoi(item.substr(dash + 1));
+            if (lo < 0 || hi < lo) return false;
+            for (int c = lo; c <= hi; ++c) out.push_back(c);
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    return true;
+}
+
+bool parsePlacementSpec(const std::string& spec, std::string& block, ThreadPlacement& out) {
+    std::stringstream ss(spec);
+    std::string tok;
+    if (!std::getline(ss, block, ':') || block.empty()) {
+        std::cerr << "Placement: missing block name in '" << spec << "'\n";
+        return false;
+    }
+    while (std::getline(ss, tok, ':')) {
+        std::string key = tok.substr(0, tok.find('='));
+        std::string val = (tok.find('=') == std::string::npos) ? "" : tok.substr(tok.find('=') + 1);
+        if (key == "cpu" || key == "cpus") {
+            if (!parseCpuList(val, out.cpus) || out.cpus.empty()) {
+                std::cerr << "Placement: bad CPU list '" << val << "'\n";
+                return false;
+            }
+        } else if (key == "fifo" || key == "rr") {
+            out.policy = (key == "fifo") ? SchedPolicy::FIFO : SchedPolicy::RR;
+            try {
+                out.priority = val.empty() ? 50 : std::stoi(val);
+            } catch (const std::exception&) {
+                std::cerr << "Placement: bad priority '" << val << "'\n";
+                return false;
+            }
+            if (out.priority < 1 || out.priority > 99) {
+                std::cerr << "Placement: priority must be 1..99\n";
+                return false;
+            }
+        } else if (key == "numa") {
+            out.numaLocal = true;
+        } else {
+            std::cerr << "Placement: unknown option '" << tok << "'\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// ========================
+// Platform
+// ========================
+
+#ifdef _WIN32
+
+static bool setAffinity(const std::vector<int>& cpus, std::string& notes) {
+    DWORD_PTR mask = 0;
+    for (int c : cpus) {
+        if (c >= static_cast<int>(sizeof(DWORD_PTR) * 8)) {
+            notes += "cpu " + std::to_string(c) + " is outside processor group 0; ";
+            continue;
+        }
+        mask |= DWORD_PTR(1) << c;
+    }
+    if (mask == 0 || SetThreadAffinityMask(GetCurrentThread(), mask) == 0) {
+        notes += "SetThreadAffinityMask failed; ";
+        return false;
+    }
+    return true;
+}
+
+static bool setPolicy(SchedPolicy policy, int priority, std::string& notes) {
+    if (policy == SchedPolicy::DEFAULT) return true;
+    // No FIFO/RR distinction on Windows: map high RT priorities to TIME_CRITICAL.
+    int level = (priority >= 50) ? THREAD_PRIORITY_TIME_CRITICAL : THREAD_PRIORITY_HIGHEST;
+    if (!SetThreadPriority(GetCurrentThread(), level)) {
+        notes += "SetThreadPriority failed; ";
+        return false;
+    }
+    return true;
+}
+
+static void queryPlacement(PlacementReport& r) {
+    // Affinity can only be read back by setting it; report the processor we run on.
+    r.runningCpu = static_cast<int>(GetCurrentProcessorNumber());
+    UCHAR node = 0;
+    if (GetNumaProcessorNode(static_cast<UCHAR>(r.runningCpu), &node)) r.numaNode = node;
+    int level = GetThreadPriority(GetCurrentThread());
+    if (level == THREAD_PRIORITY_TIME_CRITICAL) r.policy = "TIME_CRITICAL";
+    else if (level == THREAD_PRIORITY_HIGHEST) r.policy = "HIGHEST";
+}
+
+static std::vector<int> isolatedCpus() { return {}; }
+
+int memoryNumaNode(const void* p) {
+    PSAPI_WORKING_SET_EX_INFORMATION info = {};
+    info.VirtualAddress = const_cast<void*>(p);
+    if (!QueryWorkingSetEx(GetCurrentProcess(), &info, sizeof(info))) return -1;
+    if (!info.VirtualAttributes.Valid) return -1;
+    return static_cast<int>(info.VirtualAttributes.Node);
+}
+
+#else
+
+static bool setAffinity(const std::vector<int>& cpus, std::string& notes) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus) {
+        if (c < CPU_SETSIZE) CPU_SET(c, &set);
+    }
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0) {
+        notes += std::string("affinity denied (") + std::strerror(rc) + "); ";
+        return false;
+    }
+    return true;
+}
+
+static bool setPolicy(SchedPolicy policy, int priority, std::string& notes) {
+    if (policy == SchedPolicy::DEFAULT) return true;
+    sched_param sp = {};
+    sp.sched_priority = priority;
+    int pol = (policy == SchedPolicy::FIFO) ? SCHED_FIFO : SCHED_RR;
+    int rc = pthread_setschedparam(pthread_self(), pol, &sp);
+    if (rc != 0) {
+        notes += std::string(policy == SchedPolicy::FIFO ? "SCHED_FIFO" : "SCHED_RR") +
+                 " denied (" + std::strerror(rc) + "); ";
+        return false;
+    }
+    return true;
+}
+
+static void queryPlacement(PlacementReport& r) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+        for (int c = 0; c < CPU_SETSIZE; ++c)
+            if (CPU_ISSET(c, &set)) r.cpus.push_back(c);
+    }
+    unsigned cpu = 0, node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+        r.runningCpu = static_cast<int>(cpu);
+        r.numaNode = static_cast<int>(node);
+    }
+    int pol = 0;
+    sched_param sp = {};
+    if (pthread_getschedparam(pthread_self(), &pol, &sp) == 0) {
+        r.policy = (pol == SCHED_FIFO) ? "SCHED_FIFO" : (pol == SCHED_RR) ? "SCHED_RR" : "SCHED_OTHER";
+        r.priority = sp.sched_priority;
+    }
+}
+
+static std::vector<int> isolatedCpus() {
+    std::vector<int> out;
+    std::ifstream in("/sys/devices/system/cpu/isolated");
+    std::string line;
+    if (std::getline(in, line)) parseCpuList(line, out);
+    return out;
+}
+
+int memoryNumaNode(const void* p) {
+#ifdef SYS_move_pages
+    // move_pages with nodes == NULL only queries where each page lives.
+    long page = sysconf(_SC_PAGESIZE);
+    void* pages[1] = { reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(p) & ~static_cast<uintptr_t>(page - 1)) };
+    int status[1] = { -1 };
+    if (syscall(SYS_move_pages, 0, 1, pages, nullptr, status, 0) != 0) return -1;
+    return status[0] >= 0 ? status[0] : -1;
+#else
+    (void)p;
+    return -1;
+#endif
+}
+
+#endif
+
+// ========================
+// Public API
+// ========================
+
+PlacementReport applyThreadPlacement(const ThreadPlacement& placement) {
+    PlacementReport r;
+    if (!placement.cpus.empty())
+        r.affinityOk = setAffinity(placement.cpus, r.notes);
+    r.schedOk = setPolicy(placement.policy, placement.priority, r.notes);
+    queryPlacement(r);
+
+    std::vector<int> isolated = isolatedCpus();
+    for (int c : r.cpus) {
+        if (std::find(isolated.begin(), isolated.end(), c) != isolated.end())
+            r.isolatedCpus.push_back(c);
+    }
+    return r;
+}
+
+void runPinned(const std::vector<int>& cpus, const std::function<void()>& fn) {
+    if (cpus.empty()) {
+        fn();
+        return;
+    }
+    std::thread t([&] {
+        ThreadPlacement p;
+        p.cpus = cpus;
+        applyThreadPlacement(p);
+        fn();
+    });
+    t.join();
+}
+
+static std::string cpuListString(const std::vector<int>& cpus) {
+    std::string s;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) ++j;
+        if (!s.empty()) s += ",";
+        s += std::to_string(cpus[i]);
+        if (j > i) s += "-" + std::to_string(cpus[j]);
+        i = j + 1;
+    }
+    return s;
+}
+
+std::string describePlacement(const PlacementReport& r) {
+    std::ostringstream os;
+    if (!r.cpus.empty()) os << "cpus=" << cpuListString(r.cpus);
+    else os << "cpus=?";
+    if (!r.isolatedCpus.empty()) os << " (isolated: " << cpuListString(r.isolatedCpus) << ")";
+    os << " on cpu " << r.runningCpu;
+    if (r.numaNode >= 0) os << ", node " << r.numaNode;
+    os << ", " << r.policy;
+    if (r.priority > 0) os << "/" << r.priority;
+    if (!r.notes.empty()) os << "  [" << r.notes.substr(0, r.notes.size() - 2) << "]";
+    return os.str();
+}
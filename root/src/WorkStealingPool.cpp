@@ -0,0 +1,148 @@
+#include "WorkStealingPool.h"
+#include "Util.h"
+#include "profiler/Trace.h"
+
+#include <algorithm>
+#include <chrono>
+
+// Set on each worker thread so submit() can find the caller's own deque.
+static thread_local const WorkStealingPool* tlsPool = nullptr;
+static thread_local size_t tlsIndex = 0;
+
+WorkStealingPool::WorkStealingPool(size_t threads, const ThreadPlacement& placement)
+    : placement_(placement)
+{
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t i = 0; i < threads; ++i)
+        workers_.push_back(std::unique_ptr<Worker>(new Worker()));
+    for (size_t i = 0; i < threads; ++i)
+        threads_.emplace_back(&WorkStealingPool::run, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_.store(true, std::memory_order_release);
+    }
+    wake_.notify_all();
+    for (auto& t : threads_) {
+        if (t.joinable()) t.join();
+    }
+}
+
+int WorkStealingPool::currentWorker() const
+{
+    return tlsPool == this ? static_cast<int>(tlsIndex) : -1;
+}
+
+void WorkStealingPool::submit(Task task)
+{
+    size_t index = (tlsPool == this)
+        ? tlsIndex
+        : nextWorker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+    {
+        std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+        workers_[index]->tasks.push_back(std::move(task));
+    }
+    pending_.fetch_add(1, std::memory_order_seq_cst);
+
+    // A worker registers in sleepers_ before it checks pending_, so with no sleeper
+    // registered every worker is bound to see this task.
+    if (sleepers_.load(std::memory_order_seq_cst) == 0) return;
+    // Taking the sleep mutex orders this wake-up after a worker's predicate check.
+    { std::lock_guard<std::mutex> lock(sleepMutex_); }
+    wake_.notify_one();
+}
+
+void WorkStealingPool::submitAfter(uint64_t delay_ns, Task task)
+{
+    uint64_t due = util::now_ns() + delay_ns;
+    {
+        std::lock_guard<std::mutex> lock(timerMutex_);
+        timers_.emplace(due, std::move(task));
+        if (due >= nextTimerNs_.load(std::memory_order_relaxed)) return;
+        nextTimerNs_.store(due, std::memory_order_seq_cst);
+    }
+    // New earliest timer: a sleeping worker may be waiting past it
+    if (sleepers_.load(std::memory_order_seq_cst) == 0) return;
+    { std::lock_guard<std::mutex> lock(sleepMutex_); }
+    wake_.notify_one();
+}
+
+void WorkStealingPool::releaseDueTimers(uint64_t now)
+{
+    std::vector<Task> due;
+    {
+        std::lock_guard<std::mutex> lock(timerMutex_);
+        auto end = timers_.upper_bound(now);
+        for (auto it = timers_.begin(); it != end; ++it) due.push_back(std::move(it->second));
+        timers_.erase(timers_.begin(), end);
+        nextTimerNs_.store(timers_.empty() ? UINT64_MAX : timers_.begin()->first, std::memory_order_seq_cst);
+    }
+    for (Task& t : due) submit(std::move(t));
+}
+
+bool WorkStealingPool::popLocal(size_t index, Task& out)
+{
+    Worker& w = *workers_[index];
+    std::lock_guard<std::mutex> lock(w.mutex);
+    if (w.tasks.empty()) return false;
+    out = std::move(w.tasks.front());
+    w.tasks.pop_front();
+    return true;
+}
+
+bool WorkStealingPool::steal(size_t thief, Task& out)
+{
+    size_t n = workers_.size();
+    for (size_t k = 1; k < n; ++k) {
+        Worker& victim = *workers_[(thief + k) % n];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty()) continue;
+        out = std::move(victim.tasks.back());
+        victim.tasks.pop_back();
+        steals_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::run(size_t index)
+{
+    tlsPool = this;
+    tlsIndex = index;
+    if (!placement_.isDefault())
+        applyThreadPlacement(placement_);
+    CYNLR_TRACE_THREAD_NAME("pool worker");
+
+    while (!stopping_.load(std::memory_order_acquire)) {
+        uint64_t nextTimer = nextTimerNs_.load(std::memory_order_acquire);
+        uint64_t now = nextTimer != UINT64_MAX ? util::now_ns() : 0;
+        if (nextTimer <= now) {
+            releaseDueTimers(now);
+            continue;
+        }
+
+        Task task;
+        if (popLocal(index, task) || steal(index, task)) {
+            pending_.fetch_sub(1, std::memory_order_acq_rel);
+            task();
+            executed_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        auto ready = [this, nextTimer] {
+            return stopping_.load(std::memory_order_acquire) ||
+                   pending_.load(std::memory_order_seq_cst) > 0 ||
+                   nextTimerNs_.load(std::memory_order_seq_cst) < nextTimer;
+        };
+        if (nextTimer == UINT64_MAX)
+            wake_.wait(lock, ready);
+        else
+            wake_.wait_for(lock, std::chrono::nanoseconds(nextTimer - now), ready);
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
@@ -3,27 +3,76 @@
 #include "DataGenerator.h"
 #include "FilterBlock.h"
 #include "stream/CsvStreamer.h"
+#include "stream/RawStreamer.h"
+#include "stream/CaptureLog.h"
+#include "stream/CsvConverter.h"
+#include "StaticStages.h"
 #include "metrics/Collectors.h"
+#include "metrics/BinaryMetricsLog.h"
 #include "Pipeline.h"
+#include "MultiPipeline.h"
+#include "DeadlineMonitor.h"
+#include "StatsReporter.h"
+#include "profiler/ModuleProfiler.h"
+#include "profiler/Trace.h"
+#include "Simulation.h"
 #include "Config.h"
 #include <direct.h>
 #include <limits.h>
 #include <string>
 #include <cstdint>
 #include <algorithm>
+#include <chrono>
+#include <thread>
 
 static void printUsage()
 {
     std::cout
         << "Usage:\n"
-        << "  --mode=random|csv\n"
+        << "  --mode=random|csv|raw|pgm|replay\n"
         << "  --threshold=<number>\n"
         << "  --T_ns=<uint64>\n"
         << "  --columns=<int>\n"
         << "  --filter=default|file\n"
         << "  --stats | --stats=on|1|true\n"
+        << "  --profile-precision=<bits> (profiler histogram sub-bucket bits 1-12, default 5 = ~3%)\n"
+        << "  --profile-raw (also keep every profiler sample for exact percentiles)\n"
+        << "  --perf-counters (per-thread cycles/instructions/cache and branch misses per pixel, Linux)\n"
+        << "  --metrics-format=csv|bin (per-pair metrics file; bin = memory-mapped fixed-size records)\n"
+        << "  --metrics-records=<n> (bin log capacity, default 16M records)\n"
+        << "  --metrics-sample=all|every:<N>|burst:<ms>[:<pairs>]|tail:<ns>[:<pairs>] (pairs recorded by --stats)\n"
         << "  --csv=<path>\n"
+        << "  --raw=<path> (raw/pgm capture; raw needs --columns)\n"
+        << "  --replay=<path> (capture log for --mode=replay)\n"
+        << "  --replay-timing=original|fast\n"
+        << "  --capture=<path> (record generated stream + timing)\n"
+        << "  --readahead=<buffers> (async read-ahead for csv/raw/pgm, 0 = off)\n"
+        << "  --readahead-kb=<KiB per buffer>\n"
+        << "  --readahead-backend=auto|uring|thread\n"
         << "  --filterfile=<path>\n"
+        << "  --queue-capacity=<pairs> (per pipeline edge)\n"
+        << "  --engine=dynamic|static|static-split (static = stages inlined at compile time)\n"
+        << "  --overload=block|drop-newest|drop-oldest|drop-line (generator behaviour on a full queue)\n"
+        << "  --broadcast (share one broadcast ring between generator consumers)\n"
+        << "  --executor=threads|pool (pool = blocks run as tasks on a shared work-stealing pool)\n"
+        << "  --pool-threads=<n> (pool workers, default all hardware threads)\n"
+        << "  --batch=<pairs> (items per pool task step, default one line)\n"
+        << "  --pipeline=\"name=<n>;mode=..;csv=..;cpu=..\" (repeatable: one independent pipeline per spec)\n"
+        << "  --output-budget-ns=<ns> (budget between a pair's two outputs, default 100, 0 = off)\n"
+        << "  --watchdog-ms=<ms> (deadline watchdog interval, default 100, 0 = off)\n"
+        << "  --deadline-alert=<fraction> (miss rate that alerts, default 0.01)\n"
+        << "  --shed (a block stops recording metrics while its own deadlines alert)\n"
+        << "  --live-stats=<ms> [--live-format=text|json] (windowed throughput/latency/queue report while running)\n"
+        << "  --trace=<json> [--trace-events=<n>] (Chrome/Perfetto timeline; build with CYNLR_ENABLE_TRACING)\n"
+        << "  --module-profile[=<csv>] (per-function timers and counters, default module_profile.csv)\n"
+        << "  --place=generator|filter|pool[:cpu=<list>][:fifo=<prio>|:rr=<prio>][:numa] (repeatable)\n"
+        << "  --saturate [--pixels=<n>] [--duration-ms=<ms>] (unpaced, headless throughput ceiling run)\n"
+        << "  --simulate[=\"gen=50;push=20;filter=100;metrics=0;stall=<ns>;stall-rate=<p>;pairs=<n>;ms=<virtual ms>;seed=<n>\"]\n"
+        << "      (virtual-time run with modeled costs: reports queue occupancy and latency, no real waiting)\n"
+        << "  --convert=<csv> --out=<pgm> [--threads=<n>] (convert CSV to binary PGM and exit)\n"
+        << "  --metrics-convert=<bin> --out=<csv> (binary metrics log to CSV and exit)\n"
+        << "  --metrics-summary=<bin> (latency summary of a binary metrics log and exit)\n"
+        << "  --metrics-tail=<bin> [--tail-ms=<ms>] (follow a log while it is written)\n"
         << "  --quiet (suppress output)\n"
         << "  --help\n";
 }
@@ -47,6 +96,9 @@ static bool parseArgs(int argc, char** argv, Config& config)
                 std::string v = arg.substr(7);
                 if (v == "random") config.mode = InputMode::RANDOM;
                 else if (v == "csv") config.mode = InputMode::CSV;
+                else if (v == "raw") config.mode = InputMode::RAW;
+                else if (v == "pgm") config.mode = InputMode::PGM;
+                else if (v == "replay") config.mode = InputMode::REPLAY;
                 else { std::cerr << "Unknown mode: " << v << "\n"; return false; }
             }
             else if (hasPrefix("--threshold=")) {
@@ -57,6 +109,7 @@ static bool parseArgs(int argc, char** argv, Config& config)
             }
             else if (hasPrefix("--columns=")) {
                 config.columns = std::stoi(arg.substr(10));
+                config.columnsSet = true;
             }
             else if (hasPrefix("--filter=")) {
                 std::string v = arg.substr(9);
@@ -72,12 +125,198 @@ static bool parseArgs(int argc, char** argv, Config& config)
                 std::transform(v.begin(), v.end(), v.begin(), ::tolower);
                 config.stats = (v == "on" || v == "1" || v == "true");
             }
+            else if (hasPrefix("--profile-precision=")) {
+                unsigned long bits = std::stoul(arg.substr(20));
+                if (bits < LatencyHistogram::kMinSubBucketBits || bits > LatencyHistogram::kMaxSubBucketBits) {
+                    std::cerr << "--profile-precision must be between " << LatencyHistogram::kMinSubBucketBits
+                              << " and " << LatencyHistogram::kMaxSubBucketBits << "\n";
+                    return false;
+                }
+                config.profilePrecisionBits = static_cast<unsigned>(bits);
+            }
+            else if (arg == "--profile-raw") {
+                config.profileRawSamples = true;
+            }
+            else if (arg == "--perf-counters") {
+                config.perfCounters = true;
+            }
+            else if (hasPrefix("--metrics-format=")) {
+                std::string v = arg.substr(17);
+                if (v == "csv") config.metricsFormat = MetricsFormat::CSV;
+                else if (v == "bin" || v == "binary") config.metricsFormat = MetricsFormat::BINARY;
+                else { std::cerr << "Unknown metrics format: " << v << "\n"; return false; }
+            }
+            else if (hasPrefix("--metrics-records=")) {
+                config.metricsRecords = std::stoull(arg.substr(18));
+                if (config.metricsRecords == 0) {
+                    std::cerr << "--metrics-records must be at least 1\n";
+                    return false;
+                }
+            }
+            else if (hasPrefix("--metrics-sample=")) {
+                if (!parseSamplingSpec(arg.substr(17), config.metricsSampling)) return false;
+            }
+            else if (hasPrefix("--metrics-convert=")) {
+                config.metricsConvert = arg.substr(18);
+            }
+            else if (hasPrefix("--metrics-summary=")) {
+                config.metricsSummary = arg.substr(18);
+            }
+            else if (hasPrefix("--metrics-tail=")) {
+                config.metricsTail = arg.substr(15);
+            }
+            else if (hasPrefix("--tail-ms=")) {
+                config.tailMs = std::stoull(arg.substr(10));
+                if (config.tailMs == 0) config.tailMs = 1;
+            }
             else if (arg == "--quiet" || arg == "-q") {
                 config.quiet = true;
             }
             else if (hasPrefix("--csv=")) {
                 config.csvFile = arg.substr(6);
             }
+            else if (hasPrefix("--raw=")) {
+                config.rawFile = arg.substr(6);
+            }
+            else if (hasPrefix("--replay=")) {
+                config.replayFile = arg.substr(9);
+            }
+            else if (hasPrefix("--replay-timing=")) {
+                std::string v = arg.substr(16);
+                if (v == "original") config.replayTiming = ReplayTiming::ORIGINAL;
+                else if (v == "fast") config.replayTiming = ReplayTiming::FAST;
+                else { std::cerr << "Unknown replay timing: " << v << "\n"; return false; }
+            }
+            else if (hasPrefix("--capture=")) {
+                config.captureFile = arg.substr(10);
+            }
+            else if (hasPrefix("--readahead=")) {
+                config.input.readAheadBuffers = static_cast<size_t>(std::stoul(arg.substr(12)));
+            }
+            else if (hasPrefix("--readahead-kb=")) {
+                config.input.readAheadBufferSize = static_cast<size_t>(std::stoul(arg.substr(15))) * 1024;
+            }
+            else if (hasPrefix("--readahead-backend=")) {
+                std::string v = arg.substr(20);
+                if (v == "auto") config.input.readAheadBackend = ReadAheadBackend::AUTO;
+                else if (v == "uring") config.input.readAheadBackend = ReadAheadBackend::URING;
+                else if (v == "thread") config.input.readAheadBackend = ReadAheadBackend::THREAD;
+                else { std::cerr << "Unknown read-ahead backend: " << v << "\n"; return false; }
+            }
+            else if (hasPrefix("--convert=")) {
+                config.convertInput = arg.substr(10);
+            }
+            else if (hasPrefix("--out=")) {
+                config.convertOutput = arg.substr(6);
+            }
+            else if (hasPrefix("--threads=")) {
+                config.convertThreads = static_cast<unsigned>(std::stoul(arg.substr(10)));
+            }
+            else if (hasPrefix("--queue-capacity=")) {
+                config.queueCapacity = static_cast<size_t>(std::stoul(arg.substr(17)));
+            }
+            else if (hasPrefix("--engine=")) {
+                std::string v = arg.substr(9);
+                if (v == "dynamic") config.engine = Engine::DYNAMIC;
+                else if (v == "static") config.engine = Engine::STATIC;
+                else if (v == "static-split") config.engine = Engine::STATIC_SPLIT;
+                else { std::cerr << "Unknown engine: " << v << "\n"; return false; }
+            }
+            else if (hasPrefix("--executor=")) {
+                std::string v = arg.substr(11);
+                if (v == "threads") config.execution = ExecutionMode::THREADS;
+                else if (v == "pool") config.execution = ExecutionMode::POOL;
+                else { std::cerr << "Unknown executor: " << v << "\n"; return false; }
+            }
+            else if (hasPrefix("--pool-threads=")) {
+                config.poolThreads = static_cast<unsigned>(std::stoul(arg.substr(15)));
+            }
+            else if (hasPrefix("--batch=")) {
+                config.batchPairs = static_cast<size_t>(std::stoul(arg.substr(8)));
+            }
+            else if (hasPrefix("--pipeline=")) {
+                config.pipelineSpecs.push_back(arg.substr(11));
+            }
+            else if (hasPrefix("--overload=")) {
+                if (!parseOverloadPolicy(arg.substr(11), config.overload)) {
+                    std::cerr << "Unknown overload policy: " << arg.substr(11) << "\n";
+                    return false;
+                }
+            }
+            else if (hasPrefix("--output-budget-ns=")) {
+                config.outputBudget_ns = std::stoull(arg.substr(19));
+            }
+            else if (hasPrefix("--watchdog-ms=")) {
+                config.watchdogMs = std::stoull(arg.substr(14));
+            }
+            else if (arg == "--shed") {
+                config.shedOnAlert = true;
+            }
+            else if (hasPrefix("--deadline-alert=")) {
+                config.deadlineAlertRate = std::stod(arg.substr(17));
+                if (config.deadlineAlertRate < 0.0 || config.deadlineAlertRate > 1.0) {
+                    std::cerr << "--deadline-alert must be between 0 and 1\n";
+                    return false;
+                }
+            }
+            else if (hasPrefix("--live-stats=")) {
+                config.liveStatsMs = std::stoull(arg.substr(13));
+            }
+            else if (hasPrefix("--live-format=")) {
+                std::string v = arg.substr(14);
+                if (v == "text") config.liveFormat = ReportFormat::TEXT;
+                else if (v == "json") config.liveFormat = ReportFormat::JSON;
+                else { std::cerr << "Unknown live stats format: " << v << "\n"; return false; }
+            }
+            else if (hasPrefix("--trace=")) {
+                if (!Tracer::compiledIn()) {
+                    std::cerr << "--trace needs a build with CYNLR_ENABLE_TRACING defined\n";
+                    return false;
+                }
+                config.traceFile = arg.substr(8);
+            }
+            else if (arg == "--module-profile") {
+                config.moduleProfileFile = "module_profile.csv";
+            }
+            else if (hasPrefix("--module-profile=")) {
+                config.moduleProfileFile = arg.substr(17);
+            }
+            else if (hasPrefix("--trace-events=")) {
+                config.traceEvents = std::stoull(arg.substr(15));
+                if (config.traceEvents == 0) {
+                    std::cerr << "--trace-events must be positive\n";
+                    return false;
+                }
+            }
+            else if (arg == "--saturate") {
+                config.saturate = true;
+            }
+            else if (hasPrefix("--pixels=")) {
+                config.saturatePixels = std::stoull(arg.substr(9));
+            }
+            else if (hasPrefix("--duration-ms=")) {
+                config.saturateMs = std::stoull(arg.substr(14));
+            }
+            else if (arg == "--simulate") {
+                config.simulate = true;
+            }
+            else if (hasPrefix("--simulate=")) {
+                config.simulate = true;
+                if (!parseSimulationSpec(arg.substr(11), config.sim)) return false;
+            }
+            else if (arg == "--broadcast") {
+                config.broadcast = true;
+            }
+            else if (hasPrefix("--place=")) {
+                std::string block;
+                ThreadPlacement placement;
+                if (!parsePlacementSpec(arg.substr(8), block, placement)) return false;
+                if (block != "generator" && block != "filter" && block != "pool") {
+                    std::cerr << "Unknown block for --place: " << block << "\n";
+                    return false;
+                }
+                config.placements[block] = placement;
+            }
             else if (hasPrefix("--filterfile=")) {
                 config.filterFile = arg.substr(13);
             }
@@ -94,41 +333,376 @@ static bool parseArgs(int argc, char** argv, Config& config)
     return true;
 }
 
-int main(int argc, char** argv) {
-    // Parse CLI arguments
-    Config config;
-    if (!parseArgs(argc, argv, config)) {
+static int runConvert(const Config& config)
+{
+    if (config.convertOutput.empty()) {
+        std::cerr << "--convert requires --out=<path>. Exiting.\n";
+        return 1;
+    }
+    // An explicit --columns overrides the probed CSV line width.
+    int columns = config.columnsSet ? config.columns : 0;
+    ConvertResult result;
+    if (!CsvConverter::convertToPgm(config.convertInput, config.convertOutput,
+                                    columns, config.convertThreads, result)) {
         return 1;
     }
+    if (!config.quiet) {
+        std::cout << "Converted " << result.pixels << " pixels (columns=" << result.columns
+                  << ") to " << config.convertOutput << " in " << result.elapsed_ms
+                  << " ms using " << result.threads << " thread(s)\n";
+        if (result.truncated) {
+            std::cout << "Note: stopped at a malformed token, output is truncated there.\n";
+        }
+    }
+    return 0;
+}
 
-    // Interactive fallback for missing values
+static int runMetricsTool(const Config& config)
+{
+    if (!config.metricsConvert.empty()) {
+        if (config.convertOutput.empty()) {
+            std::cerr << "--metrics-convert requires --out=<path>. Exiting.\n";
+            return 1;
+        }
+        uint64_t rows = 0;
+        uint64_t t0 = util::now_ns();
+        if (!convertMetricsToCsv(config.metricsConvert, config.convertOutput, rows)) return 1;
+        if (!config.quiet) {
+            std::cout << "Converted " << rows << " records to " << config.convertOutput
+                      << " in " << (util::now_ns() - t0) / 1e6 << " ms\n";
+        }
+        return 0;
+    }
+
+    const bool tail = !config.metricsTail.empty();
+    const std::string& path = tail ? config.metricsTail : config.metricsSummary;
+    BinaryMetricsReader reader;
+    if (!reader.open(path)) return 1;
+
+    if (tail) {
+        // One line per interval for the records committed since the last poll
+        uint64_t seen = 0;
+        uint64_t t0 = util::now_ns();
+        while (true) {
+            bool closed = reader.closed();
+            uint64_t n = reader.count();
+            if (n > seen) {
+                MetricsSummary s = summarizeMetrics(reader, seen, n);
+                std::cout << "[" << (util::now_ns() - t0) / 1000000 << " ms] +" << s.records
+                          << " pairs (" << n << " total)  queue p99=" << s.queue_p99_ns
+                          << " max=" << s.queue_max_ns << " ns  proc p99=" << s.proc1_p99_ns
+                          << " ns  inter-output max=" << s.inter_max_ns << " ns\n";
+                seen = n;
+            }
+            if (closed) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(config.tailMs));
+        }
+        std::cout << "\n=== " << path << " (closed) ===\n";
+    } else {
+        std::cout << "\n=== " << path << (reader.closed() ? "" : " (still being written)") << " ===\n";
+    }
+    printMetricsSummary(summarizeMetrics(reader, 0, reader.count()), reader.dropped(), reader.shed());
+    return 0;
+}
+
+// --stats collector for one pipeline: <stem>.csv, or <stem>.bin with --metrics-format=bin
+static MetricsCollector* createMetrics(const Config& config, const std::string& stem)
+{
+    if (!config.stats) return nullptr;
+    if (config.metricsFormat == MetricsFormat::BINARY) {
+        MetricsCollector* m = CreateBinaryMetricsLog(stem + ".bin", config.metricsRecords);
+        if (!m) std::cerr << "Continuing without per-pair metrics.\n";
+        return m;
+    }
+    return CreateFileMetricsCollector(stem + ".csv");
+}
+
+// Interactive fallback for a threshold, T (ns) or CSV path missing from the command line.
+// label prefixes the prompts (a --pipeline name in sharded runs).
+static void promptMissingValues(Config& config, const std::string& label)
+{
     if (config.threshold <= 0) {
-        std::cout << "Enter threshold (TV): ";
+        std::cout << label << "Enter threshold (TV): ";
         std::cin >> config.threshold;
     }
-    if (config.T_ns < 500) {
-        std::cout << "Enter process time T (ns, >=500): ";
+    if (config.T_ns < 500 && !config.saturate) {
+        std::cout << label << "Enter process time T (ns, >=500): ";
         std::cin >> config.T_ns;
     }
     if (config.mode == InputMode::CSV && config.csvFile.empty()) {
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        std::cout << "Enter CSV file path (press Enter to use \"test.csv\"): ";
+        std::cout << label << "Enter CSV file path (press Enter to use \"test.csv\"): ";
         std::string input;
         std::getline(std::cin, input);
         if (!input.empty()) config.csvFile = input;
         else config.csvFile = "test.csv";
     }
+}
+
+// Column count from the input header / first line (CSV, PGM, replay); false with a message on failure.
+static bool resolveColumns(Config& config)
+{
     if (config.mode == InputMode::CSV) {
         int probed = CsvStreamer::probeColumns(config.csvFile);
         if (probed <= 0) {
             std::cerr << "Failed to read CSV or zero columns detected. Exiting.\n";
-            return 1;
+            return false;
+        }
+        config.columns = probed;
+        if (!config.quiet) {
+            std::cout << "Detected columns (m) = " << config.columns << "\n";
+        }
+    } else if (config.mode == InputMode::RAW || config.mode == InputMode::PGM) {
+        if (config.rawFile.empty()) {
+            std::cerr << "Raw/PGM mode requires --raw=<path>. Exiting.\n";
+            return false;
+        }
+        if (config.mode == InputMode::PGM) {
+            int probed = RawStreamer::probeColumns(config.rawFile);
+            if (probed <= 0) {
+                std::cerr << "Failed to read PGM header. Exiting.\n";
+                return false;
+            }
+            config.columns = probed;
+            if (!config.quiet) {
+                std::cout << "Detected columns (m) = " << config.columns << "\n";
+            }
+        }
+    } else if (config.mode == InputMode::REPLAY) {
+        int probed = CaptureReader::probeColumns(config.replayFile);
+        if (probed <= 0) {
+            std::cerr << "Failed to read replay log header. Exiting.\n";
+            return false;
         }
         config.columns = probed;
         if (!config.quiet) {
             std::cout << "Detected columns (m) = " << config.columns << "\n";
         }
-    } else if (config.columns <= 0) {
+    }
+    return true;
+}
+
+// --trace / --module-profile: record from before the blocks start until they have stopped,
+// then write the files
+static void startRunProfiling(const Config& config)
+{
+    if (!config.traceFile.empty())
+        Tracer::start(static_cast<size_t>(config.traceEvents));
+    if (!config.moduleProfileFile.empty()) {
+        ModuleProfiler::reset();
+        ModuleProfiler::enable(true);
+    }
+}
+
+static void finishRunProfiling(const Config& config)
+{
+    if (!config.moduleProfileFile.empty()) {
+        ModuleProfiler::enable(false);
+        if (ModuleProfiler::writeCsv(config.moduleProfileFile) && !config.quiet)
+            std::cout << "Module profile: " << ModuleProfiler::snapshot().size() << " entries written to "
+                      << config.moduleProfileFile << "\n";
+    }
+    if (config.traceFile.empty()) return;
+    Tracer::stop();
+    if (!Tracer::writeChromeJson(config.traceFile) || config.quiet) return;
+    std::cout << "Trace: " << Tracer::eventCount() << " events written to " << config.traceFile;
+    if (Tracer::droppedCount() > 0)
+        std::cout << " (" << Tracer::droppedCount() << " dropped on full buffers, see --trace-events)";
+    std::cout << "\n";
+}
+
+// --pipeline (repeatable): independent generator -> filter pipelines, one per spec,
+// each with its own blocks, queues, kernel, placement and metrics file.
+static int runSharded(const Config& base)
+{
+    if (base.engine != Engine::DYNAMIC) {
+        std::cerr << "--pipeline requires --engine=dynamic. Exiting.\n";
+        return 1;
+    }
+
+    std::vector<Config> configs;
+    std::vector<std::string> names;
+    for (size_t i = 0; i < base.pipelineSpecs.size(); ++i) {
+        Config c = base;
+        c.pipelineSpecs.clear();
+        std::string name = "pipeline" + std::to_string(i);
+        if (!applyPipelineSpec(base.pipelineSpecs[i], c, name)) return 1;
+        if (std::find(names.begin(), names.end(), name) != names.end()) {
+            std::cerr << "Duplicate pipeline name: " << name << ". Exiting.\n";
+            return 1;
+        }
+        // Same checks as a single pipeline, per spec (a spec may set its own threshold / T_ns)
+        promptMissingValues(c, "[" + name + "] ");
+        if (!c.quiet) {
+            std::cout << "[" << name << "] ";
+        }
+        if (!resolveColumns(c)) return 1;
+        if (c.columns <= 0) {
+            std::cerr << "[" << name << "] Invalid columns (m). Exiting.\n";
+            return 1;
+        }
+        configs.push_back(c);
+        names.push_back(name);
+    }
+
+    // Declared before the contexts so the collectors outlive the blocks using them.
+    startRunProfiling(base);
+    std::vector<std::unique_ptr<MetricsCollector>> metrics;
+    std::vector<std::unique_ptr<PipelineContext>> contexts;
+    bool anyPool = false;
+    bool anyRandom = false;
+    for (size_t i = 0; i < configs.size(); ++i) {
+        MetricsCollector* m = createMetrics(configs[i], "pair_metrics_" + names[i]);
+        metrics.emplace_back(m);
+        contexts.emplace_back(new PipelineContext(buildPipeline(configs[i], m)));
+        anyPool = anyPool || contexts.back()->execution == ExecutionMode::POOL;
+        anyRandom = anyRandom || configs[i].mode == InputMode::RANDOM;
+    }
+
+    // Pool-mode pipelines share one pool (that is the point of the pool)
+    std::unique_ptr<WorkStealingPool> pool;
+    if (anyPool) {
+        auto placed = base.placements.find("pool");
+        pool.reset(new WorkStealingPool(base.poolThreads,
+            placed != base.placements.end() ? placed->second : ThreadPlacement()));
+    }
+
+    // One watchdog over every pipeline's deadlines
+    std::unique_ptr<DeadlineWatchdog> watchdog;
+    if (base.watchdogMs > 0) {
+        watchdog.reset(new DeadlineWatchdog(base.watchdogMs, base.deadlineAlertRate));
+        for (auto& ctx : contexts) ctx->pipeline.watchDeadlines(*watchdog, base.shedOnAlert);
+    }
+    std::unique_ptr<StatsReporter> reporter;
+    if (base.liveStatsMs > 0) {
+        reporter.reset(new StatsReporter(base.liveStatsMs, base.liveFormat, std::cout));
+        for (size_t i = 0; i < contexts.size(); ++i)
+            contexts[i]->pipeline.reportLiveStats(*reporter, names[i] + "/");
+    }
+
+    if (!base.quiet) {
+        std::cout << "Starting " << contexts.size() << " pipelines...\n";
+    }
+    uint64_t t0 = util::now_ns();
+    for (size_t i = 0; i < contexts.size(); ++i) {
+        PipelineContext& ctx = *contexts[i];
+        if (!ctx.pipeline.start(ctx.execution == ExecutionMode::POOL ? pool.get() : nullptr, ctx.batch)) {
+            for (size_t j = 0; j < i; ++j) contexts[j]->pipeline.stop();
+            return 1;
+        }
+        if (!base.quiet && !configs[i].placements.empty()) {
+            std::cout << "[" << names[i] << "]";
+            ctx.pipeline.printPlacement();
+        }
+    }
+    if (watchdog) watchdog->start();
+    if (reporter) reporter->start();
+
+    // File-driven pipelines end at EOF; random ones run until Enter.
+    if (anyRandom) {
+        if (std::cin.rdbuf()->in_avail() > 0 && std::cin.peek() == '\n') {
+            std::cin.get();
+        }
+        std::string dummy;
+        std::getline(std::cin, dummy);
+    }
+    for (size_t i = 0; i < contexts.size(); ++i) {
+        if (configs[i].mode == InputMode::RANDOM || !contexts[i]->generator) continue;
+        while (contexts[i]->generator->isRunning()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    if (!base.quiet) {
+        std::cout << "Stopping pipelines...\n";
+    }
+    if (watchdog) watchdog->stop();
+    for (auto& ctx : contexts) ctx->pipeline.stop();
+    if (reporter) reporter->stop(); // last partial interval
+    finishRunProfiling(base);
+    double wall_ms = (util::now_ns() - t0) / 1e6;
+
+    if (!base.quiet) {
+        std::vector<PipelineSummary> summaries;
+        for (size_t i = 0; i < contexts.size(); ++i) {
+            std::cout << "\n########## " << names[i] << " ##########\n";
+            contexts[i]->pipeline.printStats();
+            summaries.push_back(summarizePipeline(names[i], *contexts[i], configs[i]));
+        }
+        printPipelineSummaries(summaries, wall_ms);
+    }
+    return 0;
+}
+
+// Sustained rate of an unpaced run plus where the time went: the generator waiting on a
+// full queue means the filter is the ceiling; the filter idling means the source is.
+static void printSaturation(const PipelineContext& ctx, double run_ms)
+{
+    uint64_t pairs = ctx.filter ? ctx.filter->totalPairsProcessed
+                                : (ctx.generator ? ctx.generator->profileStats().count : 0);
+    double seconds = run_ms / 1000.0;
+    std::cout << "\n=== Saturation (unpaced) ===\n";
+    std::cout << "Pixels:            " << pairs * 2 << " (" << pairs << " pairs)\n";
+    std::cout << "Elapsed:           " << run_ms << " ms\n";
+    if (seconds > 0)
+        std::cout << "Sustained rate:    " << static_cast<uint64_t>(pairs * 2 / seconds) << " pixels/sec ("
+                  << static_cast<uint64_t>(pairs / seconds) << " pairs/sec)\n";
+    if (ctx.generator && run_ms > 0) {
+        double ms = ctx.generator->queueFullStallNs() / 1e6;
+        std::cout << "Queue-full stall:  " << ms << " ms (" << 100.0 * ms / run_ms << "% of the run)\n";
+    }
+    if (ctx.filter && run_ms > 0) {
+        double ms = ctx.filter->idleNs / 1e6;
+        std::cout << "Consumer idle:     " << ms << " ms (" << 100.0 * ms / run_ms << "% of the run)\n";
+    }
+    std::cout << "============================\n";
+}
+
+int main(int argc, char** argv) {
+    // Parse CLI arguments
+    Config config;
+    if (!parseArgs(argc, argv, config)) {
+        return 1;
+    }
+
+    if (!config.convertInput.empty()) {
+        return runConvert(config);
+    }
+    if (!config.metricsConvert.empty() || !config.metricsSummary.empty() || !config.metricsTail.empty()) {
+        return runMetricsTool(config);
+    }
+
+    if (config.saturate) {
+        if (!config.pipelineSpecs.empty() || config.engine != Engine::DYNAMIC || config.simulate) {
+            std::cerr << "--saturate runs the single dynamic pipeline only. Exiting.\n";
+            return 1;
+        }
+        config.T_ns = 0;
+        if (config.mode == InputMode::RANDOM && config.saturatePixels == 0 && config.saturateMs == 0)
+            config.saturateMs = 1000;
+        // Headless: a missing value is a usage error, never a prompt
+        const char* missing = config.threshold <= 0 ? "--threshold=<number> (> 0)"
+                            : config.mode == InputMode::CSV && config.csvFile.empty() ? "--csv=<path>"
+                            : nullptr;
+        if (missing) {
+            std::cerr << "--saturate is headless and cannot prompt: give " << missing << ". Exiting.\n";
+            return 1;
+        }
+    }
+
+    if (!config.pipelineSpecs.empty()) {
+        return runSharded(config);
+    }
+
+    promptMissingValues(config, "");
+    if (!resolveColumns(config)) {
+        return 1;
+    }
+    if (config.mode == InputMode::RANDOM && config.columns <= 0) {
+        if (config.saturate) {
+            std::cerr << "--saturate is headless and cannot prompt: give --columns=<int> (> 0). Exiting.\n";
+            return 1;
+        }
         std::cout << "Enter columns (m): ";
         std::cin >> config.columns;
     }
@@ -137,22 +711,72 @@ int main(int argc, char** argv) {
         return 0;
     }
 
+    if (config.simulate) {
+        if (!config.quiet) {
+            std::cout << "Simulating pipeline in virtual time...\n";
+        }
+        SimulationResult result;
+        if (!runSimulation(config, result)) return 1;
+        if (!config.quiet) printSimulation(result);
+        return 0;
+    }
+
+    if (config.engine != Engine::DYNAMIC) {
+        if (!config.quiet) {
+            std::cout << "Starting static pipeline...\n";
+        }
+        if (config.mode == InputMode::RANDOM) {
+            if (std::cin.rdbuf()->in_avail() > 0 && std::cin.peek() == '\n') {
+                std::cin.get();
+            }
+        }
+        startRunProfiling(config);
+        int rc = runStaticEngine(config);
+        finishRunProfiling(config);
+        return rc;
+    }
+
     // Create shared resources
-    const size_t pairsCapacity = 128;
-    ThreadSafeQueue<DataPair> queue(pairsCapacity);
-    MetricsCollector* metrics = config.stats ? CreateFileMetricsCollector("pair_metrics.csv") : nullptr;
+    startRunProfiling(config);
+    MetricsCollector* metrics = createMetrics(config, "pair_metrics");
 
-    // Build pipeline from config
-    auto ctx = buildPipeline(config, &queue, metrics);
+    // Build pipeline from config (queues are created per edge)
+    auto ctx = buildPipeline(config, metrics);
 
     if (!config.quiet) {
         std::cout << "Starting pipeline...\n";
     }
-    ctx.pipeline.start();
+    // Pool mode: blocks become tasks on a fixed set of workers instead of owning threads
+    std::unique_ptr<WorkStealingPool> pool;
+    if (ctx.execution == ExecutionMode::POOL) {
+        auto placed = config.placements.find("pool");
+        pool.reset(new WorkStealingPool(config.poolThreads,
+            placed != config.placements.end() ? placed->second : ThreadPlacement()));
+    }
+    std::unique_ptr<DeadlineWatchdog> watchdog;
+    if (config.watchdogMs > 0) {
+        watchdog.reset(new DeadlineWatchdog(config.watchdogMs, config.deadlineAlertRate));
+        ctx.pipeline.watchDeadlines(*watchdog, config.shedOnAlert);
+    }
+    std::unique_ptr<StatsReporter> reporter;
+    if (config.liveStatsMs > 0) {
+        reporter.reset(new StatsReporter(config.liveStatsMs, config.liveFormat, std::cout));
+        ctx.pipeline.reportLiveStats(*reporter);
+    }
+    if (!ctx.pipeline.start(pool.get(), ctx.batch)) {
+        delete metrics;
+        return 1;
+    }
+    if (!config.quiet && !config.placements.empty()) {
+        ctx.pipeline.printPlacement();
+    }
+    if (watchdog) watchdog->start();
+    if (reporter) reporter->start();
+    uint64_t runStart = util::now_ns();
 
     // Wait for completion
-    if (config.mode == InputMode::CSV) {
-        // Wait for generator to finish naturally
+    if (config.mode != InputMode::RANDOM || config.saturate) {
+        // Wait for generator to finish naturally (EOF or the --saturate limit)
         if (ctx.generator) {
             while (ctx.generator->isRunning()) {
                 std::this_thread::sleep_for(std::chrono::milliseconds(1));
@@ -165,20 +789,25 @@ int main(int argc, char** argv) {
         }
         std::string dummy;
         std::getline(std::cin, dummy);
-
-        // Signal shutdown
-        DataPair sentinel{};
-        sentinel.seq = std::numeric_limits<uint64_t>::max();
-        queue.push(sentinel);
+        // Pipeline::stop() closes the generator's output edges, which ends the filter
     }
 
     if (!config.quiet) {
         std::cout << "Stopping pipeline...\n";
     }
+    if (watchdog) {
+        watchdog->stop();
+        if (!config.quiet && watchdog->alerts() > 0)
+            std::cout << "Deadline watchdog: " << watchdog->alerts() << " alert(s)\n";
+    }
     ctx.pipeline.stop();
+    double run_ms = (util::now_ns() - runStart) / 1e6;
+    if (reporter) reporter->stop(); // last partial interval
+    finishRunProfiling(config);
 
     if (!config.quiet) {
         ctx.pipeline.printStats();
+        if (config.saturate) printSaturation(ctx, run_ms);
     }
 
     if (metrics) {
@@ -0,0 +1,384 @@
+#include "metrics/BinaryMetricsLog.h"
+#include "metrics/Collectors.h"
+#include "profiler/LatencyHistogram.h"
+#include "profiler/Trace.h"
+#include "Util.h"
+
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#ifdef _WIN32
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <windows.h>
+#else
+# include <sys/mman.h>
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+static const char kMagic[8] = { 'C', 'Y', 'N', 'L', 'R', 'M', 'E', 'T' };
+static constexpr uint32_t kVersion = 1;
+
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "header count is accessed atomically");
+
+// The header count is shared with other processes; access it as an atomic in place.
+static std::atomic<uint64_t>& atomicField(uint64_t& field) {
+    return *reinterpret_cast<std::atomic<uint64_t>*>(&field);
+}
+static const std::atomic<uint64_t>& atomicField(const uint64_t& field) {
+    return *reinterpret_cast<const std::atomic<uint64_t>*>(&field);
+}
+static std::atomic<uint32_t>& atomicState(uint32_t& field) {
+    return *reinterpret_cast<std::atomic<uint32_t>*>(&field);
+}
+static const std::atomic<uint32_t>& atomicState(const uint32_t& field) {
+    return *reinterpret_cast<const std::atomic<uint32_t>*>(&field);
+}
+
+static uint32_t sat32(uint64_t v) {
+    return v > std::numeric_limits<uint32_t>::max() ? std::numeric_limits<uint32_t>::max()
+                                                    : static_cast<uint32_t>(v);
+}
+static uint16_t sat16(uint64_t v) {
+    return v > std::numeric_limits<uint16_t>::max() ? std::numeric_limits<uint16_t>::max()
+                                                    : static_cast<uint16_t>(v);
+}
+
+// ========================
+// Writer
+// ========================
+
+BinaryMetricsLog::BinaryMetricsLog(const std::string& path, uint64_t capacityRecords)
+    : path_(path), capacity_(capacityRecords > 0 ? capacityRecords : 1)
+{
+    mappedBytes_ = sizeof(BinaryMetricsHeader) + static_cast<size_t>(capacity_) * sizeof(BinaryPairRecord);
+    void* view = nullptr;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "BinaryMetricsLog: failed to create " << path << "\n";
+        return;
+    }
+    file_ = file;
+    LARGE_INTEGER size;
+    size.QuadPart = static_cast<LONGLONG>(mappedBytes_);
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE,
+                                        static_cast<DWORD>(size.HighPart), size.LowPart, nullptr);
+    if (!mapping) {
+        std::cerr << "BinaryMetricsLog: failed to size " << path << "\n";
+        close();
+        return;
+    }
+    mapping_ = mapping;
+    view = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, 0);
+#else
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "BinaryMetricsLog: failed to create " << path << "\n";
+        return;
+    }
+    fd_ = fd;
+    // Sparse: disk blocks are only allocated for pages that get written.
+    if (ftruncate(fd, static_cast<off_t>(mappedBytes_)) != 0) {
+        std::cerr << "BinaryMetricsLog: failed to size " << path << "\n";
+        close();
+        return;
+    }
+    view = mmap(nullptr, mappedBytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) view = nullptr;
+#endif
+
+    if (!view) {
+        std::cerr << "BinaryMetricsLog: failed to map " << path << "\n";
+        close();
+        return;
+    }
+
+    header_ = static_cast<BinaryMetricsHeader*>(view);
+    records_ = reinterpret_cast<BinaryPairRecord*>(header_ + 1);
+    std::memset(header_, 0, sizeof(BinaryMetricsHeader));
+    std::memcpy(header_->magic, kMagic, sizeof(kMagic));
+    header_->version = kVersion;
+    header_->recordSize = sizeof(BinaryPairRecord);
+    header_->capacity = capacity_;
+    header_->startNs = util::now_ns();
+    atomicState(header_->state).store(WRITING, std::memory_order_release);
+}
+
+BinaryMetricsLog::~BinaryMetricsLog()
+{
+    close();
+}
+
+void BinaryMetricsLog::recordPair(uint64_t seq,
+                                  uint64_t gen_ts_ns,
+                                  bool gen_ts_valid,
+                                  uint64_t pop_ts_ns,
+                                  uint64_t proc_start_ns,
+                                  uint64_t out0_ts_ns,
+                                  uint64_t out1_ts_ns,
+                                  uint64_t queue_latency_ns,
+                                  uint64_t proc0_ns,
+                                  uint64_t proc1_ns,
+                                  uint64_t inter_output_delta_ns)
+{
+    (void)queue_latency_ns;       // = gen_age + start_delta
+    (void)inter_output_delta_ns;  // = out1 - out0
+    if (!header_) return;
+    if (count_ == capacity_) {
+        std::atomic<uint64_t>& dropped = atomicField(header_->dropped);
+        dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+
+    BinaryPairRecord& r = records_[count_];
+    r.seq = seq;
+    r.pop_ts_ns = pop_ts_ns;
+    r.gen_age_ns = gen_ts_valid && pop_ts_ns > gen_ts_ns ? sat32(pop_ts_ns - gen_ts_ns) : 0;
+    r.start_delta_ns = proc_start_ns > pop_ts_ns ? sat16(proc_start_ns - pop_ts_ns) : 0;
+    r.flags = static_cast<uint16_t>((gen_ts_valid ? kGenValid : 0) |
+                                    (out0_ts_ns != 0 ? kOut0 : 0) |
+                                    (out1_ts_ns != 0 ? kOut1 : 0));
+    r.proc0_ns = sat32(proc0_ns);
+    r.proc1_ns = sat32(proc1_ns);
+
+    // Publish: a tailing reader sees the record once it sees the count.
+    atomicField(header_->count).store(++count_, std::memory_order_release);
+}
+
+void BinaryMetricsLog::flush()
+{
+    if (!header_) return;
+    CYNLR_TRACE_SCOPE("metrics flush");
+#ifdef _WIN32
+    FlushViewOfFile(header_, 0);
+#else
+    msync(header_, mappedBytes_, MS_ASYNC);
+#endif
+}
+
+void BinaryMetricsLog::recordShed(uint64_t firstSeq, uint64_t lastSeq, uint64_t pairs)
+{
+    (void)firstSeq;
+    (void)lastSeq;
+    if (!header_) return;
+    std::atomic<uint64_t>& shed = atomicField(header_->shed);
+    shed.store(shed.load(std::memory_order_relaxed) + pairs, std::memory_order_relaxed);
+}
+
+uint64_t BinaryMetricsLog::droppedRecords() const
+{
+    return header_ ? atomicField(header_->dropped).load(std::memory_order_relaxed) : 0;
+}
+
+void BinaryMetricsLog::close()
+{
+    uint64_t used = sizeof(BinaryMetricsHeader) + count_ * sizeof(BinaryPairRecord);
+    if (header_) {
+        uint64_t lost = droppedRecords();
+        if (lost > 0)
+            std::cerr << "BinaryMetricsLog: " << lost << " records dropped (" << path_
+                      << " full at " << capacity_ << " records)\n";
+        atomicState(header_->state).store(CLOSED, std::memory_order_release);
+    }
+
+#ifdef _WIN32
+    if (header_) UnmapViewOfFile(header_);
+    if (mapping_) CloseHandle(static_cast<HANDLE>(mapping_));
+    if (file_) {
+        if (header_) {
+            // Trim the unused tail (fails harmlessly while a reader still maps the file).
+            LARGE_INTEGER end;
+            end.QuadPart = static_cast<LONGLONG>(used);
+            if (SetFilePointerEx(static_cast<HANDLE>(file_), end, nullptr, FILE_BEGIN))
+                SetEndOfFile(static_cast<HANDLE>(file_));
+        }
+        CloseHandle(static_cast<HANDLE>(file_));
+    }
+    mapping_ = nullptr;
+    file_ = nullptr;
+#else
+    if (header_) munmap(header_, mappedBytes_);
+    if (fd_ >= 0) {
+        if (header_ && ftruncate(fd_, static_cast<off_t>(used)) != 0)
+            std::cerr << "BinaryMetricsLog: could not trim " << path_ << "\n";
+        ::close(fd_);
+    }
+    fd_ = -1;
+#endif
+    header_ = nullptr;
+    records_ = nullptr;
+}
+
+void BinaryMetricsLog::decode(const BinaryPairRecord& r, MetricsRow& out)
+{
+    out.seq = r.seq;
+    out.gen_ts_valid = (r.flags & kGenValid) != 0;
+    out.pop_ts_ns = r.pop_ts_ns;
+    out.gen_ts_ns = out.gen_ts_valid ? r.pop_ts_ns - r.gen_age_ns : 0;
+    out.proc_start_ns = r.pop_ts_ns + r.start_delta_ns;
+    out.queue_latency_ns = out.gen_ts_valid ? static_cast<uint64_t>(r.gen_age_ns) + r.start_delta_ns : 0;
+    bool out0 = (r.flags & kOut0) != 0;
+    bool out1 = (r.flags & kOut1) != 0;
+    out.proc0_ns = r.proc0_ns;
+    out.proc1_ns = r.proc1_ns;
+    out.out0_ts_ns = out0 ? out.proc_start_ns + r.proc0_ns : 0;
+    out.out1_ts_ns = out1 ? out.proc_start_ns + r.proc1_ns : 0;
+    out.inter_output_delta_ns = (out0 && out1) ? out.out1_ts_ns - out.out0_ts_ns : 0;
+}
+
+MetricsCollector* CreateBinaryMetricsLog(const std::string& path, uint64_t capacityRecords)
+{
+    BinaryMetricsLog* log = new BinaryMetricsLog(path, capacityRecords);
+    if (!log->isOpen()) {
+        delete log;
+        return nullptr;
+    }
+    return log;
+}
+
+// ========================
+// Reader / tools
+// ========================
+
+bool BinaryMetricsReader::open(const std::string& path)
+{
+    header_ = nullptr;
+    records_ = nullptr;
+    if (!file_.open(path)) {
+        std::cerr << "Cannot open metrics log " << path << "\n";
+        return false;
+    }
+    if (file_.size() < sizeof(BinaryMetricsHeader)) {
+        std::cerr << path << " is too small to be a metrics log\n";
+        return false;
+    }
+    const BinaryMetricsHeader* h = reinterpret_cast<const BinaryMetricsHeader*>(file_.data());
+    if (std::memcmp(h->magic, kMagic, sizeof(kMagic)) != 0 || h->version != kVersion ||
+        h->recordSize != sizeof(BinaryPairRecord)) {
+        std::cerr << path << " is not a version " << kVersion << " binary metrics log\n";
+        return false;
+    }
+    header_ = h;
+    records_ = reinterpret_cast<const BinaryPairRecord*>(h + 1);
+    return true;
+}
+
+uint64_t BinaryMetricsReader::count() const
+{
+    if (!header_) return 0;
+    uint64_t n = atomicField(header_->count).load(std::memory_order_acquire);
+    // A closed, trimmed file: never read past what was mapped.
+    uint64_t mapped = (file_.size() - sizeof(BinaryMetricsHeader)) / sizeof(BinaryPairRecord);
+    return n < mapped ? n : mapped;
+}
+
+uint64_t BinaryMetricsReader::dropped() const
+{
+    return header_ ? atomicField(header_->dropped).load(std::memory_order_relaxed) : 0;
+}
+
+uint64_t BinaryMetricsReader::shed() const
+{
+    return header_ ? atomicField(header_->shed).load(std::memory_order_relaxed) : 0;
+}
+
+bool BinaryMetricsReader::closed() const
+{
+    return header_ && atomicState(header_->state).load(std::memory_order_acquire) == BinaryMetricsLog::CLOSED;
+}
+
+void BinaryMetricsReader::row(uint64_t i, MetricsRow& out) const
+{
+    BinaryMetricsLog::decode(records_[i], out);
+}
+
+MetricsSummary summarizeMetrics(const BinaryMetricsReader& reader, uint64_t from, uint64_t to)
+{
+    MetricsSummary s;
+    LatencyHistogram queue, proc1;
+    uint64_t firstPop = 0, lastPop = 0;
+    MetricsRow r;
+    for (uint64_t i = from; i < to; ++i) {
+        reader.row(i, r);
+        if (s.records == 0) {
+            s.firstSeq = r.seq;
+            firstPop = r.pop_ts_ns;
+        } else if (r.seq > s.lastSeq + 1) {
+            ++s.seqGaps;
+        }
+        ++s.records;
+        s.lastSeq = r.seq;
+        lastPop = r.pop_ts_ns;
+        if (r.gen_ts_valid) queue.record(r.queue_latency_ns);
+        if (r.out1_ts_ns != 0) proc1.record(r.proc1_ns);
+        if (r.inter_output_delta_ns > s.inter_max_ns) s.inter_max_ns = r.inter_output_delta_ns;
+    }
+    s.span_ns = lastPop > firstPop ? lastPop - firstPop : 0;
+    s.queue_avg_ns = queue.avg();
+    s.queue_p50_ns = queue.percentile(0.50);
+    s.queue_p99_ns = queue.percentile(0.99);
+    s.queue_max_ns = queue.max();
+    s.proc1_avg_ns = proc1.avg();
+    s.proc1_p99_ns = proc1.percentile(0.99);
+    s.proc1_max_ns = proc1.max();
+    return s;
+}
+
+void printMetricsSummary(const MetricsSummary& s, uint64_t dropped, uint64_t shed)
+{
+    std::cout << "Records:            " << s.records;
+    if (s.records > 0) std::cout << " (seq " << s.firstSeq << " - " << s.lastSeq << ")";
+    std::cout << "\n";
+    if (dropped > 0) std::cout << "Dropped (log full): " << dropped << "\n";
+    if (shed > 0) std::cout << "Shed (watchdog):    " << shed << "\n";
+    if (s.seqGaps > 0) std::cout << "Sequence gaps:      " << s.seqGaps << "\n";
+    if (s.span_ns > 0)
+        std::cout << "Span:               " << s.span_ns / 1e6 << " ms ("
+                  << static_cast<uint64_t>((s.records - 1) * 1e9 / s.span_ns) << " pairs/sec)\n";
+    std::cout << "Queue latency (ns): avg=" << s.queue_avg_ns << " p50=" << s.queue_p50_ns
+              << " p99=" << s.queue_p99_ns << " max=" << s.queue_max_ns << "\n";
+    std::cout << "Processing (ns):    avg=" << s.proc1_avg_ns << " p99=" << s.proc1_p99_ns
+              << " max=" << s.proc1_max_ns << "\n";
+    std::cout << "Inter-output max:   " << s.inter_max_ns << " ns\n";
+}
+
+bool convertMetricsToCsv(const std::string& binPath, const std::string& csvPath, uint64_t& rows)
+{
+    rows = 0;
+    BinaryMetricsReader reader;
+    if (!reader.open(binPath)) return false;
+
+    std::ofstream out(csvPath, std::ofstream::out | std::ofstream::trunc);
+    if (!out) {
+        std::cerr << "Cannot write " << csvPath << "\n";
+        return false;
+    }
+    out << kMetricsCsvHeader;
+
+    std::vector<char> buf(1 << 20);
+    char* p = buf.data();
+    char* limit = buf.data() + buf.size() - kMetricsCsvMaxRow;
+    uint64_t n = reader.count();
+    MetricsRow r;
+    for (uint64_t i = 0; i < n; ++i) {
+        reader.row(i, r);
+        p = formatMetricsCsvRow(p, r);
+        if (p >= limit) {
+            out.write(buf.data(), p - buf.data());
+            p = buf.data();
+        }
+    }
+    out.write(buf.data(), p - buf.data());
+    if (reader.shed() > 0) out << "# shed " << reader.shed() << " pairs (deadline watchdog)\n";
+    rows = n;
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,34 @@
+#include "metrics/MetricsCsv.h"
+
+const char kMetricsCsvHeader[] =
+    "seq,gen_ts_ns,gen_ts_valid,pop_ts_ns,proc_start_ns,out0_ts_ns,out1_ts_ns,"
+    "queue_latency_ns,proc0_ns,proc1_ns,inter_output_delta_ns\n";
+
+// Appends v in decimal; p must have room for 20 digits.
+static char* appendUint(char* p, uint64_t v) {
+    char tmp[20];
+    int n = 0;
+    do {
+        tmp[n++] = static_cast<char>('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+    while (n > 0) *p++ = tmp[--n];
+    return p;
+}
+
+char* formatMetricsCsvRow(char* p, const MetricsRow& r)
+{
+    p = appendUint(p, r.seq);              *p++ = ',';
+    p = appendUint(p, r.gen_ts_ns);        *p++ = ',';
+    *p++ = r.gen_ts_valid ? '1' : '0';     *p++ = ',';
+    p = appendUint(p, r.pop_ts_ns);        *p++ = ',';
+    p = appendUint(p, r.proc_start_ns);    *p++ = ',';
+    p = appendUint(p, r.out0_ts_ns);       *p++ = ',';
+    p = appendUint(p, r.out1_ts_ns);       *p++ = ',';
+    p = appendUint(p, r.queue_latency_ns); *p++ = ',';
+    p = appendUint(p, r.proc0_ns);         *p++ = ',';
+    p = appendUint(p, r.proc1_ns);         *p++ = ',';
+    p = appendUint(p, r.inter_output_delta_ns);
+    *p++ = '\n';
+    return p;
+}
@@ -0,0 +1,118 @@
+#include "metrics/MetricsSampler.h"
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+bool parseSamplingSpec(const std::string& spec, SamplingPolicy& out)
+{
+    std::vector<std::string> parts;
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ':')) parts.push_back(item);
+    if (parts.empty()) parts.push_back("");
+
+    SamplingPolicy p;
+    const std::string& mode = parts[0];
+    try {
+        if (mode == "all" && parts.size() == 1) {
+            p.mode = SamplingMode::ALL;
+        }
+        else if (mode == "every" && parts.size() == 2) {
+            p.mode = SamplingMode::EVERY_N;
+            p.everyN = std::stoull(parts[1]);
+            if (p.everyN == 0) throw std::invalid_argument("N must be at least 1");
+        }
+        else if (mode == "burst" && (parts.size() == 2 || parts.size() == 3)) {
+            p.mode = SamplingMode::BURST;
+            p.burstPeriod_ns = std::stoull(parts[1]) * 1000000ULL;
+            if (parts.size() == 3) p.burstPairs = std::stoull(parts[2]);
+            if (p.burstPeriod_ns == 0 || p.burstPairs == 0) throw std::invalid_argument("period and pairs must be at least 1");
+        }
+        else if (mode == "tail" && (parts.size() == 2 || parts.size() == 3)) {
+            p.mode = SamplingMode::TAIL;
+            p.tailThreshold_ns = std::stoull(parts[1]);
+            if (parts.size() == 3) p.tailWindow = std::stoull(parts[2]);
+        }
+        else {
+            std::cerr << "Bad --metrics-sample (expected all, every:<N>, burst:<ms>[:<pairs>] or tail:<ns>[:<pairs>]): "
+                      << spec << "\n";
+            return false;
+        }
+    }
+    catch (const std::exception& ex) {
+        std::cerr << "Invalid --metrics-sample value '" << spec << "': " << ex.what() << "\n";
+        return false;
+    }
+    out = p;
+    return true;
+}
+
+std::string samplingPolicyName(const SamplingPolicy& p)
+{
+    switch (p.mode) {
+    case SamplingMode::EVERY_N:
+        return "1 in " + std::to_string(p.everyN);
+    case SamplingMode::BURST:
+        return std::to_string(p.burstPairs) + " pairs every " + std::to_string(p.burstPeriod_ns / 1000000) + " ms";
+    case SamplingMode::TAIL:
+        return "tail >= " + std::to_string(p.tailThreshold_ns) + " ns, +/-" + std::to_string(p.tailWindow) + " pairs";
+    default:
+        return "all";
+    }
+}
+
+void MetricsSampler::configure(const SamplingPolicy& policy)
+{
+    policy_ = policy;
+    countdown_ = 1;           // the first pair is always recorded
+    nextBurst_ns_ = 0;
+    burstLeft_ = 0;
+    ring_.assign(policy_.mode == SamplingMode::TAIL ? policy_.tailWindow : 0, PairMetrics());
+    ringHead_ = 0;
+    ringSize_ = 0;
+    postLeft_ = 0;
+    seen_ = recorded_ = triggers_ = 0;
+}
+
+void MetricsSampler::submit(const PairMetrics& p, MetricsCollector& out)
+{
+    if (policy_.mode != SamplingMode::TAIL) {
+        p.recordTo(out);
+        ++recorded_;
+        return;
+    }
+
+    // queue_latency is gen -> proc_start (0 without a stamp), proc1 is proc_start -> second output
+    bool slow = p.queue_latency_ns + p.proc1_ns > policy_.tailThreshold_ns;
+    if (slow) {
+        ++triggers_;
+        // The window before the slow pair, oldest first
+        size_t cap = ring_.size();
+        for (size_t i = 0; i < ringSize_; ++i) {
+            ring_[(ringHead_ + cap - ringSize_ + i) % cap].recordTo(out);
+        }
+        recorded_ += ringSize_;
+        ringSize_ = 0;
+        postLeft_ = policy_.tailWindow;
+    }
+    if (slow || postLeft_ > 0) {
+        if (!slow) --postLeft_;
+        p.recordTo(out);
+        ++recorded_;
+        return;
+    }
+    if (ring_.empty()) return;
+    ring_[ringHead_] = p;
+    ringHead_ = (ringHead_ + 1) % ring_.size();
+    if (ringSize_ < ring_.size()) ++ringSize_;
+}
+
+void MetricsSampler::printStats() const
+{
+    if (policy_.mode == SamplingMode::ALL) return;
+    std::cout << "Metrics sampling (" << samplingPolicyName(policy_) << "): " << recorded_ << " of "
+              << seen_ << " pairs recorded";
+    if (policy_.mode == SamplingMode::TAIL) std::cout << ", " << triggers_ << " slow pairs";
+    std::cout << "\n";
+}
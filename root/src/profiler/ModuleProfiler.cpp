@@ -0,0 +1,138 @@
+#include "profiler/ModuleProfiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+
+// ========================
+// Registry
+// ========================
+
+namespace {
+
+// One thread's samples, indexed by site
+struct ThreadSlots {
+    std::vector<std::unique_ptr<LatencyHistogram>> timers;
+    std::vector<uint64_t> counters;
+};
+
+struct ProfileRegistry {
+    std::mutex mutex;
+    std::vector<std::string> names;
+    std::vector<ModuleProfiler::Kind> kinds;
+    std::vector<std::unique_ptr<ThreadSlots>> threads;
+    std::atomic<uint64_t> generation{1};   // bumped by reset(): cached thread slots go stale
+};
+
+ProfileRegistry& registry()
+{
+    static ProfileRegistry r;
+    return r;
+}
+
+ThreadSlots* threadSlots()
+{
+    thread_local ThreadSlots* slots = nullptr;
+    thread_local uint64_t generation = 0;
+
+    ProfileRegistry& r = registry();
+    uint64_t current = r.generation.load(std::memory_order_acquire);
+    if (slots && generation == current) return slots;
+
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.threads.emplace_back(new ThreadSlots());
+    slots = r.threads.back().get();
+    generation = current;
+    return slots;
+}
+
+} // namespace
+
+std::atomic<bool> ModuleProfiler::enabled_{false};
+
+uint32_t ModuleProfiler::registerSite(const char* name, Kind kind)
+{
+    ProfileRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (size_t i = 0; i < r.names.size(); ++i) {
+        if (r.names[i] == name) return static_cast<uint32_t>(i);
+    }
+    r.names.emplace_back(name);
+    r.kinds.push_back(kind);
+    return static_cast<uint32_t>(r.names.size() - 1);
+}
+
+void ModuleProfiler::record(uint32_t site, uint64_t ns)
+{
+    ThreadSlots* t = threadSlots();
+    if (site >= t->timers.size()) t->timers.resize(site + 1);
+    std::unique_ptr<LatencyHistogram>& h = t->timers[site];
+    if (!h) h.reset(new LatencyHistogram());
+    h->record(ns);
+}
+
+void ModuleProfiler::add(uint32_t site, uint64_t n)
+{
+    ThreadSlots* t = threadSlots();
+    if (site >= t->counters.size()) t->counters.resize(site + 1, 0);
+    t->counters[site] += n;
+}
+
+void ModuleProfiler::reset()
+{
+    ProfileRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.threads.clear();
+    r.generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+std::vector<ModuleProfiler::Entry> ModuleProfiler::snapshot()
+{
+    ProfileRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    std::vector<Entry> entries;
+    for (size_t site = 0; site < r.names.size(); ++site) {
+        Entry e{ r.names[site], r.kinds[site], LatencyHistogram(), 0 };
+        for (const auto& t : r.threads) {
+            if (site < t->timers.size() && t->timers[site]) e.timing.merge(*t->timers[site]);
+            if (site < t->counters.size()) e.count += t->counters[site];
+        }
+        if (e.kind == Kind::TIMING) e.count = e.timing.count();
+        if (e.count > 0) entries.push_back(std::move(e));
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        if (a.kind != b.kind) return a.kind == Kind::TIMING;
+        return a.name < b.name;
+    });
+    return entries;
+}
+
+bool ModuleProfiler::writeCsv(const std::string& path)
+{
+    std::ofstream out(path, std::ofstream::out | std::ofstream::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Module profile: cannot open " << path << " for writing\n";
+        return false;
+    }
+    out << "module,metric,count,avg_ns,min_ns,max_ns,median_ns,p90_ns,p99_ns,p999_ns\n";
+    for (const Entry& e : snapshot()) {
+        out << '"' << e.name << "\",";
+        if (e.kind == Kind::COUNTER) {
+            out << "counter," << e.count << ",,,,,,,\n";
+            continue;
+        }
+        const LatencyHistogram& h = e.timing;
+        out << "timing," << h.count() << "," << h.avg() << "," << h.min() << "," << h.max() << ","
+            << h.percentile(0.50) << "," << h.percentile(0.90) << "," << h.percentile(0.99) << ","
+            << h.percentile(0.999) << "\n";
+    }
+    out.flush();
+    if (!out) {
+        std::cerr << "Module profile: write to " << path << " failed\n";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,250 @@
+#include "profiler/PerfCounters.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#ifdef __linux__
+# include <linux/perf_event.h>
+# include <sys/ioctl.h>
+# include <sys/resource.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+# include <fstream>
+#endif
+
+const char* PerfCounters::eventName(int e)
+{
+    switch (e) {
+    case PERF_CYCLES: return "cycles";
+    case PERF_INSTRUCTIONS: return "instructions";
+    case PERF_L1D_MISSES: return "L1D-misses";
+    case PERF_LLC_MISSES: return "LLC-misses";
+    case PERF_BRANCH_MISSES: return "branch-misses";
+    case PERF_CONTEXT_SWITCHES: return "context-switches";
+    default: return "?";
+    }
+}
+
+PerfCounters::PerfCounters()
+{
+    for (int e = 0; e < kPerfEventCount; ++e) {
+        fds_[e] = -1;
+        ids_[e] = 0;
+    }
+}
+
+PerfCounters::~PerfCounters()
+{
+    close();
+}
+
+#ifdef __linux__
+
+static int perfOpen(uint32_t type, uint64_t config, int groupFd)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = groupFd == -1 ? 1 : 0;   // the leader starts the whole group
+    attr.exclude_kernel = 1;                 // user space only: allowed at paranoid 2
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID |
+                       PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // pid 0, cpu -1: the calling thread, on any CPU
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+
+static std::string paranoidLevel()
+{
+    std::ifstream f("/proc/sys/kernel/perf_event_paranoid");
+    std::string level;
+    if (f >> level) return level;
+    return "?";
+}
+
+bool PerfCounters::open()
+{
+    close();
+
+    struct Spec { int event; uint32_t type; uint64_t config; };
+    const Spec specs[] = {
+        { PERF_CYCLES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_INSTRUCTIONS, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_L1D_MISSES, PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                                               (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                               (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+        { PERF_LLC_MISSES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+        { PERF_BRANCH_MISSES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    };
+
+    int leaderErrno = 0;
+    for (const Spec& s : specs) {
+        int fd = perfOpen(s.type, s.config, leader_);
+        if (fd < 0) {
+            if (leader_ < 0) leaderErrno = errno; // try the next event as leader
+            continue;
+        }
+        if (leader_ < 0) leader_ = fd;
+        fds_[s.event] = fd;
+        ioctl(fd, PERF_EVENT_IOC_ID, &ids_[s.event]);
+        mask_ |= 1u << s.event;
+    }
+
+    if (leader_ >= 0) {
+        ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        status_.clear();
+        for (int e = 0; e < PERF_CONTEXT_SWITCHES; ++e) {
+            if (!((mask_ >> e) & 1u)) {
+                status_ += status_.empty() ? "not supported here: " : ", ";
+                status_ += eventName(e);
+            }
+        }
+    } else {
+        status_ = std::string("hardware counters unavailable (") + std::strerror(leaderErrno) +
+                  ", perf_event_paranoid=" + paranoidLevel() + ")";
+    }
+
+    mask_ |= 1u << PERF_CONTEXT_SWITCHES;
+    return true;
+}
+
+void PerfCounters::close()
+{
+    for (int e = 0; e < kPerfEventCount; ++e) {
+        if (fds_[e] >= 0) ::close(fds_[e]);
+        fds_[e] = -1;
+        ids_[e] = 0;
+    }
+    leader_ = -1;
+    mask_ = 0;
+}
+
+bool PerfCounters::read(PerfSample& out) const
+{
+    std::memset(&out, 0, sizeof(out));
+    if (mask_ == 0) return false;
+
+    if (leader_ >= 0) {
+        // PERF_FORMAT_GROUP | ID | TOTAL_TIME_*: nr, enabled, running, { value, id } x nr
+        uint64_t buf[3 + 2 * kPerfEventCount];
+        ssize_t n = ::read(leader_, buf, sizeof(buf));
+        if (n >= static_cast<ssize_t>(3 * sizeof(uint64_t))) {
+            uint64_t nr = buf[0], enabled = buf[1], running = buf[2];
+            out.running_ns = running;
+            for (uint64_t i = 0; i < nr && i < kPerfEventCount; ++i) {
+                uint64_t value = buf[3 + 2 * i];
+                uint64_t id = buf[4 + 2 * i];
+                if (running > 0 && running < enabled)
+                    value = static_cast<uint64_t>(static_cast<double>(value) * enabled / running);
+                for (int e = 0; e < PERF_CONTEXT_SWITCHES; ++e) {
+                    if (((mask_ >> e) & 1u) && ids_[e] == id) {
+                        out.value[e] = value;
+                        out.mask |= 1u << e;
+                    }
+                }
+            }
+        }
+    }
+
+    rusage ru;
+    if (getrusage(RUSAGE_THREAD, &ru) == 0) {
+        out.value[PERF_CONTEXT_SWITCHES] = static_cast<uint64_t>(ru.ru_nvcsw + ru.ru_nivcsw);
+        out.mask |= 1u << PERF_CONTEXT_SWITCHES;
+    }
+    return out.mask != 0;
+}
+
+#else
+
+bool PerfCounters::open()
+{
+    status_ = "hardware counters need Linux perf_event_open";
+    return false;
+}
+
+void PerfCounters::close()
+{
+    mask_ = 0;
+}
+
+bool PerfCounters::read(PerfSample& out) const
+{
+    std::memset(&out, 0, sizeof(out));
+    return false;
+}
+
+#endif
+
+PerfSample perfDelta(const PerfSample& end, const PerfSample& start)
+{
+    PerfSample d;
+    std::memset(&d, 0, sizeof(d));
+    d.mask = end.mask & start.mask;
+    for (int e = 0; e < kPerfEventCount; ++e) {
+        if (d.has(e)) d.value[e] = end.value[e] >= start.value[e] ? end.value[e] - start.value[e] : 0;
+    }
+    d.running_ns = end.running_ns >= start.running_ns ? end.running_ns - start.running_ns : 0;
+    return d;
+}
+
+void printPerfPerPixel(const PerfSample& d, uint64_t pixels)
+{
+    if (d.mask == 0 || pixels == 0) return;
+    if (d.mask & ~(1u << PERF_CONTEXT_SWITCHES)) {
+        std::cout << "Perf counters per pixel:";
+        for (int e = 0; e < PERF_CONTEXT_SWITCHES; ++e) {
+            if (d.has(e))
+                std::cout << " " << PerfCounters::eventName(e) << "=" << static_cast<double>(d.value[e]) / pixels;
+        }
+        std::cout << "\n";
+        if (d.has(PERF_CYCLES) && d.has(PERF_INSTRUCTIONS) && d.value[PERF_CYCLES] > 0)
+            std::cout << "  IPC: " << static_cast<double>(d.value[PERF_INSTRUCTIONS]) / d.value[PERF_CYCLES] << "\n";
+        if (d.has(PERF_CYCLES) && d.running_ns > 0)
+            std::cout << "  Clock: " << static_cast<double>(d.value[PERF_CYCLES]) / d.running_ns << " GHz (on-CPU)\n";
+    }
+    if (d.has(PERF_CONTEXT_SWITCHES))
+        std::cout << "Context switches: " << d.value[PERF_CONTEXT_SWITCHES] << "\n";
+}
+
+// ========================
+// BlockPerf
+// ========================
+
+void BlockPerf::begin()
+{
+    if (!enabled_) return;
+    ended_ = false;
+    counters_.open();
+    counters_.read(start_);
+}
+
+void BlockPerf::end()
+{
+    if (!counters_.isOpen()) return;
+    counters_.read(end_);
+    counters_.close();
+    ended_ = true;
+}
+
+bool BlockPerf::sample(PerfSample& out) const
+{
+    if (counters_.isOpen()) return counters_.read(out);
+    out = end_;
+    return ended_;
+}
+
+void BlockPerf::print(uint64_t pixels) const
+{
+    if (!enabled_) return;
+    if (pooled_) {
+        std::cout << "Perf counters: per-thread counters need --executor=threads\n";
+        return;
+    }
+    if (!counters_.status().empty())
+        std::cout << "Perf counters: " << counters_.status() << "\n";
+    if (ended_) printPerfPerPixel(perfDelta(end_, start_), pixels);
+}
@@ -0,0 +1,117 @@
+#include "profiler/StageLatency.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+StageLatency::StageLatency(unsigned precisionBits)
+    : endToEnd_(precisionBits),
+      tailCount_(LatencyHistogram::bucketCount(kTailBits), 0),
+      tailSum_(LatencyHistogram::bucketCount(kTailBits) * kStageCount, 0)
+{
+    for (LatencyHistogram& h : stages_) h = LatencyHistogram(precisionBits);
+}
+
+const char* StageLatency::stageName(int s)
+{
+    switch (s) {
+    case STAGE_PACE: return "pace";
+    case STAGE_PUSH: return "push";
+    case STAGE_QUEUE: return "queue";
+    case STAGE_COMPUTE: return "compute";
+    case STAGE_OUTPUT: return "output";
+    default: return "?";
+    }
+}
+
+void StageLatency::record(const PairStages& p, uint64_t emitted_ns)
+{
+    // Stamps are monotonic in a pair's life; clamp the odd cross-thread clock inversion.
+    uint32_t enq = p.enq;
+    uint32_t deq = std::max(p.deq, enq);
+    uint32_t filtered = std::max(p.filtered, deq);
+    uint32_t emitted = std::max(stageDelta(p.gen_ns, emitted_ns), filtered);
+
+    uint64_t ns[kStageCount];
+    ns[STAGE_PACE] = p.pace;
+    ns[STAGE_PUSH] = enq;
+    ns[STAGE_QUEUE] = deq - enq;
+    ns[STAGE_COMPUTE] = filtered - deq;
+    ns[STAGE_OUTPUT] = emitted - filtered;
+
+    uint64_t total = 0;
+    for (int s = 0; s < kStageCount; ++s) {
+        stages_[s].record(ns[s]);
+        total += ns[s];
+    }
+    endToEnd_.record(total);
+
+    size_t b = LatencyHistogram::bucketIndex(total, kTailBits);
+    ++tailCount_[b];
+    for (int s = 0; s < kStageCount; ++s) tailSum_[b * kStageCount + s] += ns[s];
+}
+
+bool StageLatency::merge(const StageLatency& other)
+{
+    if (!endToEnd_.merge(other.endToEnd_)) return false;
+    for (int s = 0; s < kStageCount; ++s) stages_[s].merge(other.stages_[s]);
+    for (size_t i = 0; i < tailCount_.size(); ++i) tailCount_[i] += other.tailCount_[i];
+    for (size_t i = 0; i < tailSum_.size(); ++i) tailSum_[i] += other.tailSum_[i];
+    return true;
+}
+
+void StageLatency::reset()
+{
+    for (LatencyHistogram& h : stages_) h.reset();
+    endToEnd_.reset();
+    std::fill(tailCount_.begin(), tailCount_.end(), 0);
+    std::fill(tailSum_.begin(), tailSum_.end(), 0);
+}
+
+uint64_t StageLatency::tailBreakdown(double q, double (&mean_ns)[kStageCount], uint64_t& threshold_ns) const
+{
+    for (double& m : mean_ns) m = 0.0;
+    threshold_ns = endToEnd_.percentile(q);
+    if (endToEnd_.count() == 0) return 0;
+
+    uint64_t pairs = 0;
+    uint64_t sums[kStageCount] = {};
+    for (size_t b = LatencyHistogram::bucketIndex(threshold_ns, kTailBits); b < tailCount_.size(); ++b) {
+        pairs += tailCount_[b];
+        for (int s = 0; s < kStageCount; ++s) sums[s] += tailSum_[b * kStageCount + s];
+    }
+    if (pairs == 0) return 0;
+    for (int s = 0; s < kStageCount; ++s) mean_ns[s] = static_cast<double>(sums[s]) / pairs;
+    return pairs;
+}
+
+void StageLatency::printStats() const
+{
+    if (count() == 0) return;
+    std::cout << "Latency by stage (ns, " << count() << " pairs):\n";
+    std::cout << "  " << std::left << std::setw(12) << "stage" << std::right
+              << std::setw(10) << "avg" << std::setw(10) << "p50" << std::setw(10) << "p99"
+              << std::setw(10) << "p99.9" << std::setw(12) << "max" << "\n";
+    auto row = [](const char* name, const LatencyHistogram& h) {
+        std::cout << "  " << std::left << std::setw(12) << name << std::right
+                  << std::setw(10) << h.avg() << std::setw(10) << h.percentile(0.50)
+                  << std::setw(10) << h.percentile(0.99) << std::setw(10) << h.percentile(0.999)
+                  << std::setw(12) << h.max() << "\n";
+    };
+    for (int s = 0; s < kStageCount; ++s) row(stageName(s), stages_[s]);
+    row("end-to-end", endToEnd_);
+
+    double mean[kStageCount];
+    uint64_t threshold = 0;
+    uint64_t pairs = tailBreakdown(0.99, mean, threshold);
+    if (pairs == 0) return;
+    double total = 0.0;
+    for (double m : mean) total += m;
+    std::cout << "  p99 tail (>= " << threshold << " ns, " << pairs << " pairs):";
+    for (int s = 0; s < kStageCount; ++s) {
+        std::cout << " " << stageName(s) << " " << std::fixed << std::setprecision(0)
+                  << (total > 0 ? 100.0 * mean[s] / total : 0.0) << "%";
+    }
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::setprecision(6) << "\n";
+}
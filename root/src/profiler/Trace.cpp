@@ -0,0 +1,210 @@
+#include "profiler/Trace.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+// ========================
+// Registry
+// ========================
+
+namespace {
+
+struct TraceRegistry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<TraceBuffer>> buffers;
+    size_t capacity = Tracer::kDefaultEventsPerThread;
+    uint64_t origin_ns = 0;
+    std::atomic<uint64_t> generation{1};   // bumped by start(): cached thread buffers go stale
+};
+
+TraceRegistry& registry()
+{
+    static TraceRegistry r;
+    return r;
+}
+
+} // namespace
+
+std::atomic<bool> Tracer::enabled_{false};
+
+TraceBuffer::TraceBuffer(size_t capacity, uint32_t tid)
+    : events_(new TraceEvent[capacity > 0 ? capacity : 1]), capacity_(capacity > 0 ? capacity : 1), tid_(tid)
+{
+}
+
+bool Tracer::compiledIn()
+{
+#ifdef CYNLR_ENABLE_TRACING
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Tracer::start(size_t eventsPerThread)
+{
+    TraceRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.buffers.clear();
+    r.capacity = eventsPerThread;
+    r.origin_ns = util::now_ns();
+    r.generation.fetch_add(1, std::memory_order_acq_rel);
+    enabled_.store(true, std::memory_order_release);
+}
+
+void Tracer::stop()
+{
+    enabled_.store(false, std::memory_order_release);
+}
+
+TraceBuffer* Tracer::threadBuffer()
+{
+    thread_local TraceBuffer* buffer = nullptr;
+    thread_local uint64_t generation = 0;
+
+    TraceRegistry& r = registry();
+    uint64_t current = r.generation.load(std::memory_order_acquire);
+    if (buffer && generation == current) return buffer;
+
+    // First event of this thread since start(): the only allocation on the recording path
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.buffers.emplace_back(new TraceBuffer(r.capacity, static_cast<uint32_t>(r.buffers.size() + 1)));
+    buffer = r.buffers.back().get();
+    generation = current;
+    return buffer;
+}
+
+void Tracer::complete(const char* name, uint64_t start_ns, uint64_t end_ns)
+{
+    TraceEvent e;
+    e.name = name;
+    e.ts_ns = start_ns;
+    e.dur_ns = end_ns > start_ns ? end_ns - start_ns : 0;
+    e.value = 0;
+    e.phase = 'X';
+    threadBuffer()->push(e);
+}
+
+void Tracer::counter(const char* name, int64_t value)
+{
+    TraceEvent e;
+    e.name = name;
+    e.ts_ns = util::now_ns();
+    e.dur_ns = 0;
+    e.value = value;
+    e.phase = 'C';
+    threadBuffer()->push(e);
+}
+
+void Tracer::instant(const char* name)
+{
+    TraceEvent e;
+    e.name = name;
+    e.ts_ns = util::now_ns();
+    e.dur_ns = 0;
+    e.value = 0;
+    e.phase = 'i';
+    threadBuffer()->push(e);
+}
+
+void Tracer::setThreadName(const char* name)
+{
+    threadBuffer()->threadName = name;
+}
+
+uint64_t Tracer::eventCount()
+{
+    TraceRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    uint64_t n = 0;
+    for (const auto& b : r.buffers) n += b->size();
+    return n;
+}
+
+uint64_t Tracer::droppedCount()
+{
+    TraceRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    uint64_t n = 0;
+    for (const auto& b : r.buffers) n += b->dropped();
+    return n;
+}
+
+// ========================
+// Chrome trace-event JSON
+// ========================
+
+static void writeJsonString(std::ostream& out, const char* s)
+{
+    out << '"';
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') out << '\\';
+        out << *s;
+    }
+    out << '"';
+}
+
+// Microseconds since start(), the unit of "ts" / "dur"
+static void writeMicros(std::ostream& out, uint64_t ns)
+{
+    out << ns / 1000 << '.' << std::setw(3) << std::setfill('0') << ns % 1000;
+}
+
+bool Tracer::writeChromeJson(const std::string& path)
+{
+    std::ofstream out(path, std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+    if (!out.is_open()) {
+        std::cerr << "Trace: cannot open " << path << " for writing\n";
+        return false;
+    }
+
+    TraceRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    uint64_t dropped = 0;
+    bool first = true;
+    auto separator = [&] {
+        out << (first ? "\n" : ",\n");
+        first = false;
+    };
+
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    for (const auto& b : r.buffers) {
+        dropped += b->dropped();
+        separator();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << b->tid()
+            << ",\"args\":{\"name\":";
+        std::string name = b->threadName.empty() ? "thread " + std::to_string(b->tid()) : b->threadName;
+        writeJsonString(out, name.c_str());
+        out << "}}";
+
+        size_t n = b->size();
+        for (size_t i = 0; i < n; ++i) {
+            const TraceEvent& e = (*b)[i];
+            separator();
+            out << "{\"name\":";
+            writeJsonString(out, e.name);
+            out << ",\"ph\":\"" << e.phase << "\",\"pid\":1,\"tid\":" << b->tid() << ",\"ts\":";
+            writeMicros(out, e.ts_ns > r.origin_ns ? e.ts_ns - r.origin_ns : 0);
+            if (e.phase == 'X') {
+                out << ",\"dur\":";
+                writeMicros(out, e.dur_ns);
+            } else if (e.phase == 'C') {
+                // Counters are keyed by name + id, so each thread's series stays separate
+                out << ",\"id\":" << b->tid() << ",\"args\":{\"value\":" << e.value << "}";
+            } else {
+                out << ",\"s\":\"t\"";
+            }
+            out << "}";
+        }
+    }
+    out << "\n],\"otherData\":{\"dropped_events\":" << dropped << "}}\n";
+    out.flush();
+    if (!out) {
+        std::cerr << "Trace: write to " << path << " failed\n";
+        return false;
+    }
+    return true;
+}
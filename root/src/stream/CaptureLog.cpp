@@ -0,0 +1,88 @@
+#include "stream/CaptureLog.h"
+#include <cstring>
+#include <iostream>
+
+// ------------------------------------------------------------
+// CaptureWriter
+// ------------------------------------------------------------
+CaptureWriter::~CaptureWriter() {
+    close();
+}
+
+bool CaptureWriter::open(const std::string& path, int columns) {
+    close();
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        std::cerr << "CaptureWriter: failed to open " << path << "\n";
+        return false;
+    }
+
+    uint8_t header[capture::HEADER_SIZE] = {};
+    std::memcpy(header, capture::MAGIC, sizeof(capture::MAGIC));
+    uint32_t c = static_cast<uint32_t>(columns);
+    header[8]  = static_cast<uint8_t>(c);
+    header[9]  = static_cast<uint8_t>(c >> 8);
+    header[10] = static_cast<uint8_t>(c >> 16);
+    header[11] = static_cast<uint8_t>(c >> 24);
+    std::fwrite(header, 1, sizeof(header), file_);
+
+    buffer_.clear();
+    buffer_.reserve(BUFFER_SIZE + capture::RECORD_SIZE);
+    hasPrev_ = false;
+    prevTs_ = 0;
+    records_ = 0;
+    return true;
+}
+
+void CaptureWriter::flushBuffer() {
+    if (file_ && !buffer_.empty())
+        std::fwrite(buffer_.data(), 1, buffer_.size(), file_);
+    buffer_.clear();
+}
+
+void CaptureWriter::close() {
+    if (!file_) return;
+    flushBuffer();
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+// ------------------------------------------------------------
+// CaptureReader
+// ------------------------------------------------------------
+static bool parseHeader(const uint8_t* data, size_t size, int& columns) {
+    if (!data || size < capture::HEADER_SIZE) return false;
+    if (std::memcmp(data, capture::MAGIC, sizeof(capture::MAGIC)) != 0) return false;
+    uint32_t c = static_cast<uint32_t>(data[8]) | (static_cast<uint32_t>(data[9]) << 8) |
+                 (static_cast<uint32_t>(data[10]) << 16) | (static_cast<uint32_t>(data[11]) << 24);
+    if (c == 0 || c > static_cast<uint32_t>(INT32_MAX)) return false;
+    columns = static_cast<int>(c);
+    return true;
+}
+
+bool CaptureReader::open(const std::string& path) {
+    close();
+    if (!file_.open(path)) return false;
+    if (!parseHeader(file_.data(), file_.size(), columns_)) {
+        std::cerr << "CaptureReader: invalid capture header in " << path << "\n";
+        close();
+        return false;
+    }
+    pos_ = file_.data() + capture::HEADER_SIZE;
+    end_ = file_.data() + file_.size();
+    return true;
+}
+
+void CaptureReader::close() {
+    file_.close();
+    pos_ = end_ = nullptr;
+    columns_ = 0;
+}
+
+int CaptureReader::probeColumns(const std::string& path) {
+    MappedFile f;
+    if (!f.open(path)) return 0;
+    int columns = 0;
+    if (!parseHeader(f.data(), f.size(), columns)) return 0;
+    return columns;
+}
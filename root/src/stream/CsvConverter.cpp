@@ -0,0 +1,158 @@
+#include "stream/CsvConverter.h"
+#include "stream/CsvStreamer.h"
+#include "stream/MappedFile.h"
+#include "stream/InputSource.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct ChunkResult {
+    std::vector<uint8_t> pixels;
+    bool error = false;   // hit a malformed token; pixels holds everything before it
+};
+
+// Same semantics as CsvStreamer::trim + parseClampedUint8 (std::stol based).
+inline bool parseToken(const char* b, const char* e, uint8_t& out) {
+    while (b < e && std::isspace(static_cast<unsigned char>(*b))) ++b;
+    while (e > b && std::isspace(static_cast<unsigned char>(e[-1]))) --e;
+    if (b == e) { out = 0; return true; }
+
+    bool neg = false;
+    if (*b == '+' || *b == '-') { neg = (*b == '-'); ++b; }
+    if (b == e || !std::isdigit(static_cast<unsigned char>(*b))) return false;
+
+    long long v = 0;
+    while (b < e && std::isdigit(static_cast<unsigned char>(*b))) {
+        int d = *b - '0';
+        if (v > (LONG_MAX - d) / 10) return false; // std::stol would throw out_of_range
+        v = v * 10 + d;
+        ++b;
+    }
+    if (neg || v == 0) { out = 0; return true; }
+    out = static_cast<uint8_t>(v > 255 ? 255 : v);
+    return true;
+}
+
+void parseChunk(const char* begin, const char* end, bool lastChunk, ChunkResult& r) {
+    r.pixels.reserve(static_cast<size_t>(end - begin) / 2);
+    const char* tok = begin;
+    for (const char* p = begin; p < end; ++p) {
+        if (*p != ',') continue;
+        uint8_t v;
+        if (!parseToken(tok, p, v)) { r.error = true; return; }
+        r.pixels.push_back(v);
+        tok = p + 1;
+    }
+    // trailing token without a comma only exists at the end of the file
+    if (lastChunk && tok < end) {
+        uint8_t v;
+        if (!parseToken(tok, end, v)) { r.error = true; return; }
+        r.pixels.push_back(v);
+    }
+}
+
+bool writePgm(const std::string& outPath, int columns,
+              const std::vector<ChunkResult>& chunks, uint64_t pixels) {
+    std::FILE* f = std::fopen(outPath.c_str(), "wb");
+    if (!f) {
+        std::cerr << "CsvConverter: failed to open " << outPath << "\n";
+        return false;
+    }
+    uint64_t rows = (pixels + columns - 1) / columns;
+    std::string header = "P5\n" + std::to_string(columns) + " " + std::to_string(rows) + "\n255\n";
+    bool ok = std::fwrite(header.data(), 1, header.size(), f) == header.size();
+
+    uint64_t remaining = pixels;
+    for (const auto& c : chunks) {
+        if (!ok || remaining == 0) break;
+        size_t n = static_cast<size_t>(std::min<uint64_t>(remaining, c.pixels.size()));
+        ok = std::fwrite(c.pixels.data(), 1, n, f) == n;
+        remaining -= n;
+    }
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) std::cerr << "CsvConverter: write error on " << outPath << "\n";
+    return ok;
+}
+
+} // namespace
+
+bool CsvConverter::convertToPgm(const std::string& csvPath, const std::string& outPath,
+                                int columns, unsigned threads, ConvertResult& result) {
+    uint64_t t0 = util::now_ns();
+    result = ConvertResult();
+
+    if (columns <= 0) columns = CsvStreamer::probeColumns(csvPath);
+    if (columns <= 0) {
+        std::cerr << "CsvConverter: failed to read CSV or zero columns detected: " << csvPath << "\n";
+        return false;
+    }
+    result.columns = columns;
+
+    std::vector<ChunkResult> chunks;
+
+    if (detectCompression(csvPath) != Compression::NONE) {
+        // Compressed input cannot be split by offset: stream it on one thread.
+        CsvStreamer s;
+        if (!s.open(csvPath)) return false;
+        chunks.resize(1);
+        uint8_t a, b;
+        while (s.nextPair(a, b)) {
+            chunks[0].pixels.push_back(a);
+            chunks[0].pixels.push_back(b);
+        }
+        result.threads = 1;
+    } else {
+        MappedFile file;
+        if (!file.open(csvPath)) {
+            std::cerr << "CsvConverter: could not open " << csvPath << "\n";
+            return false;
+        }
+        const char* data = reinterpret_cast<const char*>(file.data());
+        size_t size = file.size();
+
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        if (size < threads * size_t(4096)) threads = 1; // not worth splitting
+        result.threads = threads;
+
+        // Chunk boundaries sit just after a ',' so no token straddles two chunks.
+        std::vector<size_t> starts(threads + 1, size);
+        starts[0] = 0;
+        for (unsigned i = 1; i < threads; ++i) {
+            size_t p = std::max(starts[i - 1], size / threads * i);
+            while (p < size && data[p] != ',') ++p;
+            starts[i] = (p < size) ? p + 1 : size;
+        }
+
+        chunks.resize(threads);
+        std::vector<std::thread> workers;
+        for (unsigned i = 0; i < threads; ++i) {
+            workers.emplace_back([&, i] {
+                parseChunk(data + starts[i], data + starts[i + 1], i + 1 == threads, chunks[i]);
+            });
+        }
+        for (auto& w : workers) w.join();
+    }
+
+    // Keep everything up to the first malformed token, then drop a final odd pixel.
+    uint64_t pixels = 0;
+    for (const auto& c : chunks) {
+        pixels += c.pixels.size();
+        if (c.error) { result.truncated = true; break; }
+    }
+    pixels &= ~uint64_t(1);
+    result.pixels = pixels;
+
+    if (!writePgm(outPath, columns, chunks, pixels)) return false;
+
+    result.elapsed_ms = (util::now_ns() - t0) / 1e6;
+    return true;
+}
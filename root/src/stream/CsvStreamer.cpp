@@ -1,4 +1,5 @@
 #include "stream/CsvStreamer.h"
+#include "profiler/ModuleProfiler.h"
 #include <algorithm>
 #include <cctype>
 #include <cstdlib>
@@ -8,15 +9,18 @@ CsvStreamer::~CsvStreamer() {
     close();
 }
 
-bool CsvStreamer::open(const std::string& path) {
+bool CsvStreamer::open(const std::string& path, const InputOptions& opts) {
     close();
-    in_.open(path);
-    opened_ = in_.is_open();
+    source_ = openInputSource(path, opts);
+    if (!source_) return false;
+    in_.rdbuf(source_.get());
+    opened_ = true;
     return opened_;
 }
 
 void CsvStreamer::close() {
-    if (in_.is_open()) in_.close();
+    in_.rdbuf(nullptr);
+    source_.reset();
     opened_ = false;
 }
 
@@ -41,6 +45,7 @@ bool CsvStreamer::parseClampedUint8(const std::string& s, uint8_t& out) {
 
 bool CsvStreamer::nextPair(uint8_t& a, uint8_t& b) {
     if (!opened_) return false;
+    CYNLR_PROFILE_SCOPE("CsvStreamer.next_pair");
     std::string t1, t2;
     // read first token
     if (!std::getline(in_, t1, ',')) {
@@ -70,8 +75,9 @@ bool CsvStreamer::nextPair(uint8_t& a, uint8_t& b) {
 }
 
 int CsvStreamer::probeColumns(const std::string& path) {
-    std::ifstream in(path);
-    if (!in) return 0;
+    std::unique_ptr<std::streambuf> source = openInputSource(path, InputOptions());
+    if (!source) return 0;
+    std::istream in(source.get());
 
     std::string line;
     while (std::getline(in, line)) {
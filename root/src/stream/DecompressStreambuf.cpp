@@ -0,0 +1,230 @@
+#include "stream/DecompressStreambuf.h"
+#include <iostream>
+
+#ifdef CYNLR_WITH_ZLIB
+# include <zlib.h>
+#endif
+#ifdef CYNLR_WITH_ZSTD
+# include <zstd.h>
+#endif
+
+static constexpr size_t INPUT_BUFFER_SIZE = 1 << 16;
+
+DecompressStreambuf::~DecompressStreambuf() {
+    close();
+}
+
+bool DecompressStreambuf::supported(Compression codec) {
+    switch (codec) {
+    case Compression::NONE: return true;
+#ifdef CYNLR_WITH_ZLIB
+    case Compression::GZIP: return true;
+#endif
+#ifdef CYNLR_WITH_ZSTD
+    case Compression::ZSTD: return true;
+#endif
+    default: return false;
+    }
+}
+
+const char* DecompressStreambuf::codecName(Compression codec) {
+    switch (codec) {
+    case Compression::GZIP: return "gzip";
+    case Compression::ZSTD: return "zstd";
+    default: return "none";
+    }
+}
+
+bool DecompressStreambuf::open(std::unique_ptr<std::streambuf> compressed, Compression codec,
+                               size_t chunks, size_t chunkSize) {
+    close();
+    if (!compressed || !supported(codec) || codec == Compression::NONE) return false;
+
+    source_ = std::move(compressed);
+    codec_ = codec;
+    chunkSize_ = chunkSize ? chunkSize : INPUT_BUFFER_SIZE;
+    chunks_.assign(chunks < 2 ? 2 : chunks, Chunk{});
+    for (auto& c : chunks_) c.data.resize(chunkSize_);
+
+    readIdx_ = writeIdx_ = filled_ = 0;
+    holding_ = done_ = stop_ = false;
+    setg(nullptr, nullptr, nullptr);
+
+    opened_ = true;
+    worker_ = std::thread(&DecompressStreambuf::decodeLoop, this);
+    return true;
+}
+
+void DecompressStreambuf::close() {
+    if (!opened_) return;
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) worker_.join();
+    source_.reset();
+    chunks_.clear();
+    setg(nullptr, nullptr, nullptr);
+    opened_ = false;
+}
+
+// ------------------------------------------------------------
+// Producer side (helper thread)
+// ------------------------------------------------------------
+char* DecompressStreambuf::acquireChunk() {
+    std::unique_lock<std::mutex> lk(m_);
+    // filled_ includes the chunk the parser is holding, so it is never overwritten
+    cv_.wait(lk, [&] { return stop_ || filled_ < chunks_.size(); });
+    if (stop_) return nullptr;
+    return chunks_[writeIdx_].data.data();
+}
+
+void DecompressStreambuf::publishChunk(size_t size) {
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        chunks_[writeIdx_].size = size;
+        writeIdx_ = (writeIdx_ + 1) % chunks_.size();
+        ++filled_;
+    }
+    cv_.notify_all();
+}
+
+void DecompressStreambuf::decodeLoop() {
+    bool ok = (codec_ == Compression::GZIP) ? decodeGzip() : decodeZstd();
+    if (!ok) {
+        std::cerr << "DecompressStreambuf: " << codecName(codec_) << " stream is corrupt or truncated\n";
+    }
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        done_ = true;
+    }
+    cv_.notify_all();
+}
+
+bool DecompressStreambuf::decodeGzip() {
+#ifdef CYNLR_WITH_ZLIB
+    z_stream zs = {};
+    if (inflateInit2(&zs, 15 + 32) != Z_OK) return false; // auto-detect gzip/zlib header
+
+    std::vector<char> in(INPUT_BUFFER_SIZE);
+    char* out = acquireChunk();
+    size_t fill = 0;
+    bool ok = true;
+    bool streamEnd = false;
+    bool outputFull = false; // last inflate filled the chunk: it may hold more output
+
+    while (out) {
+        if (zs.avail_in == 0 && (!outputFull || streamEnd)) {
+            std::streamsize n = source_->sgetn(in.data(), static_cast<std::streamsize>(in.size()));
+            if (n <= 0) {
+                ok = streamEnd; // EOF is only clean right after a member ended
+                break;
+            }
+            zs.next_in = reinterpret_cast<Bytef*>(in.data());
+            zs.avail_in = static_cast<uInt>(n);
+        }
+        if (streamEnd) {
+            // concatenated gzip member
+            inflateReset(&zs);
+            streamEnd = false;
+        }
+
+        zs.next_out = reinterpret_cast<Bytef*>(out + fill);
+        zs.avail_out = static_cast<uInt>(chunkSize_ - fill);
+        int r = inflate(&zs, Z_NO_FLUSH);
+        fill = chunkSize_ - zs.avail_out;
+        outputFull = (zs.avail_out == 0);
+
+        if (r == Z_STREAM_END) {
+            streamEnd = true;
+        } else if (r != Z_OK && r != Z_BUF_ERROR) {
+            ok = false;
+            break;
+        }
+        if (fill == chunkSize_) {
+            publishChunk(fill);
+            fill = 0;
+            out = acquireChunk();
+        }
+    }
+    if (out && fill > 0) publishChunk(fill);
+    inflateEnd(&zs);
+    return ok;
+#else
+    return false;
+#endif
+}
+
+bool DecompressStreambuf::decodeZstd() {
+#ifdef CYNLR_WITH_ZSTD
+    ZSTD_DCtx* dctx = ZSTD_createDCtx();
+    if (!dctx) return false;
+
+    std::vector<char> in(INPUT_BUFFER_SIZE);
+    ZSTD_inBuffer input = { in.data(), 0, 0 };
+    char* out = acquireChunk();
+    size_t fill = 0;
+    size_t lastRet = 0;
+    bool ok = true;
+    bool outputFull = false; // last call filled the chunk: the decoder may hold more output
+
+    while (out) {
+        if (input.pos == input.size && !outputFull) {
+            std::streamsize n = source_->sgetn(in.data(), static_cast<std::streamsize>(in.size()));
+            if (n <= 0) {
+                ok = (lastRet == 0); // 0 means the last frame was fully decoded
+                break;
+            }
+            input.size = static_cast<size_t>(n);
+            input.pos = 0;
+        }
+
+        ZSTD_outBuffer output = { out + fill, chunkSize_ - fill, 0 };
+        size_t r = ZSTD_decompressStream(dctx, &output, &input);
+        if (ZSTD_isError(r)) {
+            ok = false;
+            break;
+        }
+        lastRet = r;
+        fill += output.pos;
+        outputFull = (output.pos == output.size);
+
+        if (fill == chunkSize_) {
+            publishChunk(fill);
+            fill = 0;
+            out = acquireChunk();
+        }
+    }
+    if (out && fill > 0) publishChunk(fill);
+    ZSTD_freeDCtx(dctx);
+    return ok;
+#else
+    return false;
+#endif
+}
+
+// ------------------------------------------------------------
+// Consumer side (parser thread)
+// ------------------------------------------------------------
+DecompressStreambuf::int_type DecompressStreambuf::underflow() {
+    if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+    if (!opened_) return traits_type::eof();
+
+    std::unique_lock<std::mutex> lk(m_);
+    if (holding_) {
+        holding_ = false;
+        readIdx_ = (readIdx_ + 1) % chunks_.size();
+        --filled_;
+        cv_.notify_all();
+    }
+    cv_.wait(lk, [&] { return filled_ > 0 || done_; });
+    if (filled_ == 0) {
+        setg(nullptr, nullptr, nullptr);
+        return traits_type::eof();
+    }
+    holding_ = true;
+    Chunk& c = chunks_[readIdx_];
+    setg(c.data.data(), c.data.data(), c.data.data() + c.size);
+    return traits_type::to_int_type(*gptr());
+}
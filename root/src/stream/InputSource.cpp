@@ -0,0 +1,45 @@
+#include "stream/InputSource.h"
+#include <fstream>
+#include <iostream>
+
+Compression detectCompression(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    unsigned char magic[4] = {};
+    if (!in.read(reinterpret_cast<char*>(magic), sizeof(magic))) return Compression::NONE;
+    if (magic[0] == 0x1f && magic[1] == 0x8b) return Compression::GZIP;
+    if (magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd) return Compression::ZSTD;
+    return Compression::NONE;
+}
+
+static std::unique_ptr<std::streambuf> openFileSource(const std::string& path, const InputOptions& opts) {
+    if (opts.readAheadBuffers > 0) {
+        std::unique_ptr<ReadAheadStreambuf> ra(new ReadAheadStreambuf());
+        if (!ra->open(path, opts.readAheadBuffers, opts.readAheadBufferSize, opts.readAheadBackend))
+            return nullptr;
+        return std::unique_ptr<std::streambuf>(ra.release());
+    }
+
+    std::unique_ptr<std::filebuf> fb(new std::filebuf());
+    if (!fb->open(path, std::ios::in | std::ios::binary))
+        return nullptr;
+    return std::unique_ptr<std::streambuf>(fb.release());
+}
+
+std::unique_ptr<std::streambuf> openInputSource(const std::string& path, const InputOptions& opts) {
+    std::unique_ptr<std::streambuf> file = openFileSource(path, opts);
+    if (!file) return nullptr;
+
+    Compression codec = detectCompression(path);
+    if (codec == Compression::NONE) return file;
+
+    if (!DecompressStreambuf::supported(codec)) {
+        std::cerr << "InputSource: " << path << " is " << DecompressStreambuf::codecName(codec)
+                  << "-compressed but this build has no " << DecompressStreambuf::codecName(codec)
+                  << " support\n";
+        return nullptr;
+    }
+    std::unique_ptr<DecompressStreambuf> dec(new DecompressStreambuf());
+    if (!dec->open(std::move(file), codec, opts.decompressChunks, opts.decompressChunkSize))
+        return nullptr;
+    return std::unique_ptr<std::streambuf>(dec.release());
+}
@@ -0,0 +1,115 @@
+#include "stream/RawStreamer.h"
+#include "profiler/ModuleProfiler.h"
+#include <cctype>
+#include <iostream>
+
+// A read-ahead source throws on an I/O error (after reporting it): the stream ends there.
+static std::streamsize readSource(std::streambuf& source, char* dst, size_t n) {
+    try {
+        return source.sgetn(dst, static_cast<std::streamsize>(n));
+    } catch (const std::ios_base::failure&) {
+        return 0;
+    }
+}
+
+RawStreamer::~RawStreamer() {
+    close();
+}
+
+bool RawStreamer::open(const std::string& path, RawFormat format, const InputOptions& opts) {
+    close();
+
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    size_t offset = 0;
+
+    // Memory-map plain files; read-ahead and compressed captures go through a streambuf.
+    if (opts.readAheadBuffers > 0 || detectCompression(path) != Compression::NONE) {
+        source_ = openInputSource(path, opts);
+        if (!source_) return false;
+        // The first chunk is large enough to hold any sane PGM header.
+        chunk_.resize(CHUNK_SIZE);
+        std::streamsize n = readSource(*source_, reinterpret_cast<char*>(chunk_.data()), chunk_.size());
+        data = chunk_.data();
+        size = n > 0 ? static_cast<size_t>(n) : 0;
+    } else {
+        if (!file_.open(path)) return false;
+        data = file_.data();
+        size = file_.size();
+    }
+
+    if (format == RawFormat::PGM) {
+        int width = 0, height = 0, maxval = 0;
+        if (!parsePgmHeader(data, size, width, height, maxval, offset)) {
+            std::cerr << "RawStreamer: invalid PGM header in " << path << "\n";
+            close();
+            return false;
+        }
+        columns_ = width;
+    }
+
+    pos_ = data ? data + offset : nullptr;
+    end_ = data ? data + size : nullptr;
+    return true;
+}
+
+bool RawStreamer::refill() {
+    if (!source_) return false;
+    CYNLR_PROFILE_SCOPE("RawStreamer.refill");
+    size_t carry = static_cast<size_t>(end_ - pos_);
+    if (carry) chunk_[0] = *pos_;
+    std::streamsize n = readSource(*source_, reinterpret_cast<char*>(chunk_.data()) + carry,
+                                   chunk_.size() - carry);
+    pos_ = chunk_.data();
+    end_ = pos_ + carry + (n > 0 ? static_cast<size_t>(n) : 0);
+    return end_ - pos_ >= 2;
+}
+
+void RawStreamer::close() {
+    file_.close();
+    source_.reset();
+    pos_ = end_ = nullptr;
+    columns_ = 0;
+}
+
+// Reads one whitespace-separated decimal field, skipping '#' comments.
+static bool readHeaderInt(const uint8_t* data, size_t size, size_t& i, int& out) {
+    for (;;) {
+        while (i < size && std::isspace(data[i])) ++i;
+        if (i < size && data[i] == '#') {
+            while (i < size && data[i] != '\n') ++i;
+            continue;
+        }
+        break;
+    }
+    if (i >= size || !std::isdigit(data[i])) return false;
+    long v = 0;
+    while (i < size && std::isdigit(data[i])) {
+        v = v * 10 + (data[i] - '0');
+        if (v > 1000000000L) return false;
+        ++i;
+    }
+    out = static_cast<int>(v);
+    return true;
+}
+
+bool RawStreamer::parsePgmHeader(const uint8_t* data, size_t size,
+                                 int& width, int& height, int& maxval, size_t& headerLen) {
+    if (!data || size < 2 || data[0] != 'P' || data[1] != '5') return false;
+    size_t i = 2;
+    if (!readHeaderInt(data, size, i, width)) return false;
+    if (!readHeaderInt(data, size, i, height)) return false;
+    if (!readHeaderInt(data, size, i, maxval)) return false;
+    // exactly one whitespace byte separates maxval from the pixel data
+    if (i >= size || !std::isspace(data[i])) return false;
+    ++i;
+    if (width <= 0 || height < 0 || maxval <= 0 || maxval > 255) return false;
+    headerLen = i;
+    return true;
+}
+
+int RawStreamer::probeColumns(const std::string& path) {
+    RawStreamer s;
+    if (!s.open(path, RawFormat::PGM)) return 0;
+    return s.columns();
+}
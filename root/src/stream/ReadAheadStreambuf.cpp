@@ -0,0 +1,441 @@
+#include "stream/ReadAheadStreambuf.h"
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <ios>
+#include <iostream>
+
+#ifdef _WIN32
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <windows.h>
+#else
+# include <sys/stat.h>
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+#if defined(__linux__) && defined(__has_include)
+# if __has_include(<linux/io_uring.h>)
+#  define CYNLR_HAVE_IO_URING 1
+# endif
+#endif
+
+#ifdef CYNLR_HAVE_IO_URING
+# include <linux/io_uring.h>
+# include <sys/mman.h>
+# include <sys/syscall.h>
+# include <sys/uio.h>
+#endif
+
+// ------------------------------------------------------------
+// Minimal io_uring wrapper (raw syscalls, no liburing dependency)
+// ------------------------------------------------------------
+#ifdef CYNLR_HAVE_IO_URING
+
+struct ReadAheadStreambuf::Uring {
+    int fd = -1;
+    unsigned entries = 0;
+    void* sqRing = nullptr;
+    void* cqRing = nullptr;
+    size_t sqRingSize = 0;
+    size_t cqRingSize = 0;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqesSize = 0;
+
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqMask = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned* cqMask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+
+    std::vector<iovec> iov; // one per slot, kept alive while the read is in flight
+
+    bool init(unsigned n) {
+        io_uring_params p;
+        std::memset(&p, 0, sizeof(p));
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, n, &p));
+        if (fd < 0) return false;
+        entries = p.sq_entries;
+
+        sqRingSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cqRingSize = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single) sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+
+        sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      fd, IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED) { sqRing = nullptr; return false; }
+        if (single) {
+            cqRing = sqRing;
+        } else {
+            cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          fd, IORING_OFF_CQ_RING);
+            if (cqRing == MAP_FAILED) { cqRing = nullptr; return false; }
+        }
+        sqesSize = p.sq_entries * sizeof(io_uring_sqe);
+        void* s = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       fd, IORING_OFF_SQES);
+        if (s == MAP_FAILED) return false;
+        sqes = static_cast<io_uring_sqe*>(s);
+
+        char* sq = static_cast<char*>(sqRing);
+        char* cq = static_cast<char*>(cqRing);
+        sqHead  = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+        sqTail  = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+        sqMask  = reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+        cqHead  = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+        cqTail  = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+        cqMask  = reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+        cqes    = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+        return true;
+    }
+
+    ~Uring() {
+        if (sqes) munmap(sqes, sqesSize);
+        if (cqRing && cqRing != sqRing) munmap(cqRing, cqRingSize);
+        if (sqRing) munmap(sqRing, sqRingSize);
+        if (fd >= 0) ::close(fd);
+    }
+
+    // 0, or the errno of the failure (EAGAIN: submission queue full)
+    int submitRead(int fileFd, size_t slot, char* buf, size_t len, uint64_t off) {
+        unsigned tail = *sqTail;
+        unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        if (tail - head >= entries) return EAGAIN;
+
+        iov[slot].iov_base = buf;
+        iov[slot].iov_len = len;
+
+        unsigned idx = tail & *sqMask;
+        io_uring_sqe* sqe = &sqes[idx];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_READV; // READV (5.1+) rather than READ (5.6+) for older kernels
+        sqe->fd = fileFd;
+        sqe->addr = reinterpret_cast<uint64_t>(&iov[slot]);
+        sqe->len = 1;
+        sqe->off = off;
+        sqe->user_data = slot;
+        sqArray[idx] = idx;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+
+        int r;
+        do {
+            r = static_cast<int>(syscall(__NR_io_uring_enter, fd, 1, 0, 0, nullptr, 0));
+        } while (r < 0 && errno == EINTR);
+        return r >= 0 ? 0 : errno;
+    }
+
+    bool waitCompletion(uint64_t& userData, int& res) {
+        for (;;) {
+            unsigned head = *cqHead;
+            unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+            if (head != tail) {
+                const io_uring_cqe& cqe = cqes[head & *cqMask];
+                userData = cqe.user_data;
+                res = cqe.res;
+                __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+                return true;
+            }
+            int r = static_cast<int>(syscall(__NR_io_uring_enter, fd, 0, 1, IORING_ENTER_GETEVENTS,
+                                             nullptr, 0));
+            if (r < 0 && errno != EINTR) return false;
+        }
+    }
+};
+
+#else
+
+struct ReadAheadStreambuf::Uring {};
+
+#endif
+
+// ------------------------------------------------------------
+// Lifecycle
+// ------------------------------------------------------------
+ReadAheadStreambuf::ReadAheadStreambuf() = default;
+
+ReadAheadStreambuf::~ReadAheadStreambuf() {
+    close();
+}
+
+const char* ReadAheadStreambuf::backendName() const noexcept {
+    return useUring_ ? "io_uring" : "thread";
+}
+
+bool ReadAheadStreambuf::open(const std::string& path, size_t buffers, size_t bufferSize,
+                              ReadAheadBackend backend) {
+    close();
+    if (buffers == 0) buffers = 1;
+    bufferSize_ = std::max<size_t>(ALIGNMENT, (bufferSize + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT);
+
+#ifdef _WIN32
+    HANDLE h = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (h == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER sz;
+    if (!GetFileSizeEx(h, &sz)) { CloseHandle(h); return false; }
+    file_ = h;
+    fileSize_ = static_cast<uint64_t>(sz.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) { ::close(fd); return false; }
+    fd_ = fd;
+    fileSize_ = static_cast<uint64_t>(st.st_size);
+#endif
+
+    // One contiguous allocation, each slot aligned for direct/async I/O.
+    storage_.assign(buffers * bufferSize_ + ALIGNMENT, 0);
+    uintptr_t base = reinterpret_cast<uintptr_t>(storage_.data());
+    base = (base + ALIGNMENT - 1) & ~static_cast<uintptr_t>(ALIGNMENT - 1);
+    slots_.assign(buffers, Slot{});
+    for (size_t i = 0; i < buffers; ++i)
+        slots_[i].data = reinterpret_cast<char*>(base) + i * bufferSize_;
+
+    current_ = 0;
+    haveCurrent_ = false;
+    eof_ = false;
+    failed_ = false;
+    error_.clear();
+    nextOffset_ = 0;
+    stop_ = false;
+    setg(nullptr, nullptr, nullptr);
+
+#ifdef CYNLR_HAVE_IO_URING
+    useUring_ = (backend != ReadAheadBackend::THREAD);
+#else
+    useUring_ = false;
+    (void)backend;
+#endif
+
+    opened_ = true;
+    if (!startBackend()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void ReadAheadStreambuf::close() {
+    if (!opened_) return;
+    stopBackend();
+#ifdef _WIN32
+    if (file_) CloseHandle(static_cast<HANDLE>(file_));
+    file_ = nullptr;
+#else
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+#endif
+    slots_.clear();
+    storage_.clear();
+    storage_.shrink_to_fit();
+    setg(nullptr, nullptr, nullptr);
+    opened_ = false;
+}
+
+// ------------------------------------------------------------
+// Backends
+// ------------------------------------------------------------
+bool ReadAheadStreambuf::startBackend() {
+#ifdef CYNLR_HAVE_IO_URING
+    if (useUring_) {
+        uring_.reset(new Uring());
+        uring_->iov.resize(slots_.size());
+        if (uring_->init(static_cast<unsigned>(slots_.size()))) {
+            for (size_t i = 0; i < slots_.size(); ++i) releaseSlot(i);
+            return true;
+        }
+        // io_uring unavailable at run time (old kernel, seccomp): fall back to a thread
+        uring_.reset();
+        useUring_ = false;
+    }
+#endif
+    free_.assign(slots_.size(), true);
+    reader_ = std::thread(&ReadAheadStreambuf::readerLoop, this);
+    return true;
+}
+
+void ReadAheadStreambuf::stopBackend() {
+    if (useUring_) {
+#ifdef CYNLR_HAVE_IO_URING
+        // Drain in-flight reads before the buffers go away.
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            if (!slots_[i].filled) waitSlot(i);
+        }
+#endif
+        uring_.reset();
+        useUring_ = false;
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (reader_.joinable()) reader_.join();
+}
+
+void ReadAheadStreambuf::readerLoop() {
+    size_t idx = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lk(m_);
+            cv_.wait(lk, [&] { return stop_ || free_[idx]; });
+            if (stop_) return;
+            free_[idx] = false;
+        }
+
+        Slot& slot = slots_[idx];
+        size_t got = 0;
+        int error = 0;
+        while (got < bufferSize_) {
+#ifdef _WIN32
+            DWORD n = 0;
+            if (!ReadFile(static_cast<HANDLE>(file_), slot.data + got,
+                          static_cast<DWORD>(bufferSize_ - got), &n, nullptr)) {
+                error = static_cast<int>(GetLastError());
+                break;
+            }
+#else
+            ssize_t n = ::read(fd_, slot.data + got, bufferSize_ - got);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                error = errno;
+                break;
+            }
+#endif
+            if (n == 0) break;
+            got += static_cast<size_t>(n);
+        }
+
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            slot.size = error ? 0 : got;
+            slot.eof = (got == 0);
+            slot.err = error;
+            slot.offset = nextOffset_;
+            slot.filled = true;
+        }
+        cv_.notify_all();
+        if (got == 0 || error) return;
+        nextOffset_ += got;
+        idx = (idx + 1) % slots_.size();
+    }
+}
+
+bool ReadAheadStreambuf::waitSlot(size_t idx) {
+    Slot& slot = slots_[idx];
+#ifdef CYNLR_HAVE_IO_URING
+    if (useUring_) {
+        while (!slot.filled) {
+            uint64_t which = 0;
+            int res = 0;
+            if (!uring_->waitCompletion(which, res)) {
+                slot.err = errno != 0 ? errno : EIO;
+                slot.filled = true;
+                break;
+            }
+            Slot& done = slots_[which];
+            if (res < 0) {
+                done.err = -res;
+                done.filled = true;
+                continue;
+            }
+            done.size += static_cast<size_t>(res);
+            uint64_t end = std::min<uint64_t>(done.offset + bufferSize_, fileSize_);
+            if (done.offset + done.size < end) {
+                // Short read: queue the remainder into the same slot. The next slot starts
+                // at done.offset + bufferSize_, so a slot that stays short is an error.
+                int err = res == 0 ? EIO // the file shrank under us
+                        : uring_->submitRead(fd_, which, done.data + done.size,
+                                             static_cast<size_t>(end - done.offset - done.size),
+                                             done.offset + done.size);
+                if (err == 0) continue;
+                done.err = err;
+            }
+            done.eof = (done.size == 0);
+            done.filled = true;
+        }
+        return slot.err == 0 && !slot.eof;
+    }
+#endif
+    std::unique_lock<std::mutex> lk(m_);
+    cv_.wait(lk, [&] { return slot.filled || stop_; });
+    return slot.filled && slot.err == 0 && !slot.eof;
+}
+
+void ReadAheadStreambuf::releaseSlot(size_t idx) {
+    Slot& slot = slots_[idx];
+#ifdef CYNLR_HAVE_IO_URING
+    if (useUring_) {
+        slot.size = 0;
+        slot.offset = nextOffset_;
+        slot.filled = false;
+        slot.eof = false;
+        slot.err = 0;
+        if (slot.offset >= fileSize_) {
+            slot.filled = slot.eof = true;
+            return;
+        }
+        slot.err = uring_->submitRead(fd_, idx, slot.data,
+                                      static_cast<size_t>(std::min<uint64_t>(bufferSize_, fileSize_ - slot.offset)),
+                                      slot.offset);
+        if (slot.err != 0) {
+            // Not issued: the consumer stops at this slot, so nextOffset_ stays put
+            slot.filled = true;
+            return;
+        }
+        nextOffset_ += bufferSize_;
+        return;
+    }
+#endif
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        slot.filled = false;
+        slot.size = 0;
+        slot.err = 0;
+        free_[idx] = true;
+    }
+    cv_.notify_all();
+}
+
+// ------------------------------------------------------------
+// streambuf
+// ------------------------------------------------------------
+ReadAheadStreambuf::int_type ReadAheadStreambuf::underflow() {
+    if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+    if (!opened_ || eof_) return traits_type::eof();
+    if (failed_) throw std::ios_base::failure(error_);
+
+    if (haveCurrent_) {
+        releaseSlot(current_);
+        current_ = (current_ + 1) % slots_.size();
+    }
+    haveCurrent_ = true;
+
+    Slot& slot = slots_[current_];
+    if (!waitSlot(current_)) {
+        setg(nullptr, nullptr, nullptr);
+        if (slot.err == 0) {
+            eof_ = true;
+            return traits_type::eof();
+        }
+        failed_ = true;
+#ifdef _WIN32
+        error_ = "read error at offset " + std::to_string(slot.offset) + ": Windows error " + std::to_string(slot.err);
+#else
+        error_ = "read error at offset " + std::to_string(slot.offset) + ": " + std::strerror(slot.err);
+#endif
+        std::cerr << "ReadAheadStreambuf: " << error_ << "\n";
+        throw std::ios_base::failure(error_);
+    }
+    setg(slot.data, slot.data, slot.data + slot.size);
+    return traits_type::to_int_type(*gptr());
+}
@@ -41,6 +41,31 @@ int main() {
 
     std::vector<std::string> tests = {
         "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestCsvStreamer.exe",
+        "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestRawStreamer.exe",
+        "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestCaptureLog.exe",
+        "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestReadAhead.exe",
+        "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestDecompress.exe",
+        "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestCsvConverter.exe",
+        "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestPipeline.exe",
+        "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestBroadcastRing.exe",
+        "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestThreadPlacement.exe",
+        "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestStaticPipeline.exe",
+        "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestWorkStealingPool.exe",
+        "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestMultiPipeline.exe",
+        "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestOverload.exe",
+        "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestDeadlineMonitor.exe",
+        "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestSimulation.exe",
+        "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestSaturation.exe",
+        "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestMetricsCollector.exe",
+        "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestBinaryMetrics.exe",
+        "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestBlockProfiler.exe",
+        "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestLiveStats.exe",
+        "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestPerfCounters.exe",
+        "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestTrace.exe",
+        "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestModuleProfiler.exe",
+        "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestStageLatency.exe",
+        "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestMetricsSampler.exe",
+        "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestUtilization.exe",
         "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestFilterBlock.exe",
         "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestFilterBlockCalc.exe",
         "C:\\Users\\Mrithika\\source\\repos\\cynlr-onboarding-project\\x64\\Release\\tests\\unit\\TestDataGenerator.exe",
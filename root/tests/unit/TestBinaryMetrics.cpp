@@ -0,0 +1,130 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "metrics/Collectors.h"
+#include "metrics/BinaryMetricsLog.h"
+
+static void fail(const std::string &msg) {
+    std::cerr << "FAIL: " << msg << "\n";
+    std::exit(1);
+}
+static void pass(const std::string &msg) {
+    std::cout << "PASS: " << msg << "\n";
+}
+
+static std::vector<std::string> readLines(const std::string& path) {
+    std::ifstream f(path);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(f, line)) lines.push_back(line);
+    return lines;
+}
+
+// Consistent timestamps as FilterBlock produces them; every 4th pair has no generator stamp
+// and every 5th produced only output 0.
+static void recordN(MetricsCollector& m, uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i) {
+        bool valid = i % 4 != 0;
+        uint64_t gen = 1000000 + i * 1000;
+        uint64_t pop = gen + 300 + i % 50;
+        uint64_t start = pop + 20;
+        uint64_t proc0 = 40 + i % 7;
+        uint64_t proc1 = i % 5 == 0 ? 0 : 90 + i % 11;
+        uint64_t out0 = start + proc0;
+        uint64_t out1 = proc1 ? start + proc1 : 0;
+        m.recordPair(i, valid ? gen : 0, valid, pop, start, out0, out1,
+                     valid ? start - gen : 0, proc0, proc1, out1 ? out1 - out0 : 0);
+    }
+}
+
+void testBinaryMetrics() {
+    // Test 1: converted rows match the CSV collector's rows exactly
+    {
+        const uint64_t n = 5000;
+        {
+            std::unique_ptr<MetricsCollector> csv(CreateFileMetricsCollector("test_bin_ref.csv"));
+            std::unique_ptr<MetricsCollector> bin(CreateBinaryMetricsLog("test_bin.bin", 1 << 16));
+            if (!bin) fail("could not create binary log");
+            recordN(*csv, n);
+            recordN(*bin, n);
+        }
+        uint64_t rows = 0;
+        if (!convertMetricsToCsv("test_bin.bin", "test_bin_conv.csv", rows)) fail("convert failed");
+        if (rows != n) fail("converted row count wrong: " + std::to_string(rows));
+        std::vector<std::string> ref = readLines("test_bin_ref.csv");
+        std::vector<std::string> conv = readLines("test_bin_conv.csv");
+        if (ref.size() != n + 1 || conv.size() != ref.size()) fail("line counts differ");
+        for (size_t i = 0; i < ref.size(); ++i)
+            if (ref[i] != conv[i]) fail("row " + std::to_string(i) + " differs: " + conv[i] + " vs " + ref[i]);
+        pass("Round trip matches CSV output");
+    }
+    // Test 2: the closed file is trimmed and reads back with its summary
+    {
+        BinaryMetricsReader reader;
+        if (!reader.open("test_bin.bin")) fail("reader open failed");
+        if (!reader.closed()) fail("log should be CLOSED");
+        if (reader.count() != 5000 || reader.dropped() != 0) fail("count/dropped wrong");
+        std::ifstream f("test_bin.bin", std::ios::binary | std::ios::ate);
+        if (static_cast<uint64_t>(f.tellg()) != sizeof(BinaryMetricsHeader) + 5000 * sizeof(BinaryPairRecord))
+            fail("file not trimmed to the records written");
+        MetricsSummary s = summarizeMetrics(reader, 0, reader.count());
+        if (s.records != 5000 || s.firstSeq != 0 || s.lastSeq != 4999 || s.seqGaps != 0)
+            fail("summary counts wrong");
+        if (s.queue_max_ns != 20 + 300 + 49) fail("queue max wrong: " + std::to_string(s.queue_max_ns));
+        if (s.proc1_max_ns != 100) fail("proc1 max wrong");
+        pass("Trimmed file and summary");
+    }
+    // Test 3: a full log drops (and counts) instead of growing
+    {
+        {
+            BinaryMetricsLog log("test_bin_full.bin", 100);
+            if (!log.isOpen()) fail("could not create small log");
+            recordN(log, 150);
+            if (log.droppedRecords() != 50) fail("expected 50 drops");
+        }
+        BinaryMetricsReader reader;
+        if (!reader.open("test_bin_full.bin")) fail("reader open failed");
+        if (reader.count() != 100 || reader.dropped() != 50) fail("full log header wrong");
+        pass("Full log counts drops");
+    }
+    // Test 4: a reader follows the log while it is still being written
+    {
+        BinaryMetricsLog log("test_bin_live.bin", 1000);
+        BinaryMetricsReader reader;
+        if (!reader.open("test_bin_live.bin")) fail("live open failed");
+        if (reader.closed() || reader.count() != 0) fail("fresh log should be empty and open");
+        recordN(log, 10);
+        if (reader.count() != 10) fail("reader did not see committed records");
+        MetricsRow r;
+        reader.row(9, r);
+        if (r.seq != 9 || !r.gen_ts_valid || r.proc1_ns != 99) fail("live row decoded wrong");
+        log.close();
+        if (!reader.closed()) fail("reader did not see CLOSED");
+        pass("Live tail sees records and close");
+    }
+    // Test 5: values beyond the compact fields saturate instead of wrapping
+    {
+        {
+            BinaryMetricsLog log("test_bin_sat.bin", 4);
+            log.recordPair(7, 0, true, 10000000000ULL, 10000000000ULL + 100000, 0, 0, 0, 5000000000ULL, 0, 0);
+        }
+        BinaryMetricsReader reader;
+        if (!reader.open("test_bin_sat.bin")) fail("reader open failed");
+        MetricsRow r;
+        reader.row(0, r);
+        if (r.proc_start_ns != 10000000000ULL + 65535) fail("start delta should saturate");
+        if (r.proc0_ns != 4294967295ULL) fail("proc0 should saturate");
+        if (r.out0_ts_ns != 0 || r.out1_ts_ns != 0) fail("no outputs flagged");
+        pass("Compact fields saturate");
+    }
+}
+
+int main() {
+    std::cout << "\nRunning binary metrics log unit tests...\n";
+    testBinaryMetrics();
+    std::cout << "All binary metrics log tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include "profiler/BlockProfiler.h"
+#include "profiler/LatencyHistogram.h"
+
+static void fail(const std::string &msg) {
+    std::cerr << "FAIL: " << msg << "\n";
+    std::exit(1);
+}
+static void pass(const std::string &msg) {
+    std::cout << "PASS: " << msg << "\n";
+}
+
+// Same rank convention as LatencyHistogram::percentile
+static uint64_t exactPercentile(const std::vector<uint64_t>& sorted, double q) {
+    return sorted[static_cast<size_t>(q * (sorted.size() - 1))];
+}
+
+void testBlockProfiler() {
+    // Test 1: percentiles stay within the configured relative error
+    {
+        std::mt19937_64 rng(42);
+        std::lognormal_distribution<double> dist(6.0, 1.5); // ~400 ns median, long tail
+        std::vector<uint64_t> values;
+        for (int i = 0; i < 200000; ++i) values.push_back(static_cast<uint64_t>(dist(rng)));
+        std::vector<uint64_t> sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+
+        const unsigned precisions[] = { 3, 5, 7, 10 };
+        for (unsigned bits : precisions) {
+            LatencyHistogram h(bits);
+            for (uint64_t v : values) h.record(v);
+            double tolerance = 1.0 / (1u << bits);
+            const double qs[] = { 0.5, 0.9, 0.99, 0.999 };
+            for (double q : qs) {
+                uint64_t exact = exactPercentile(sorted, q);
+                uint64_t approx = h.percentile(q);
+                if (approx < exact || approx > exact + exact * tolerance + 1)
+                    fail("bits=" + std::to_string(bits) + " q=" + std::to_string(q) + ": " +
+                         std::to_string(approx) + " vs exact " + std::to_string(exact));
+            }
+            if (h.min() != sorted.front() || h.max() != sorted.back()) fail("min/max not exact");
+            if (h.count() != values.size()) fail("count wrong");
+        }
+        pass("Percentiles within precision");
+    }
+    // Test 2: memory is fixed, extreme values are handled
+    {
+        LatencyHistogram h;
+        size_t bytes = h.memoryBytes();
+        h.record(0);
+        h.record(31);
+        h.record(18446744073709551615ULL);
+        for (uint64_t i = 0; i < 1000000; ++i) h.record(i * 7919);
+        if (h.memoryBytes() != bytes) fail("histogram grew");
+        if (bytes > 16 * 1024) fail("default histogram larger than 16 KiB");
+        if (h.max() != 18446744073709551615ULL || h.min() != 0) fail("extremes wrong");
+        if (h.percentile(1.0) != h.max() || h.percentile(0.0) != 0) fail("q=0/1 should give min/max");
+        pass("Fixed memory and extreme values");
+    }
+    // Test 3: merge (blocks / runs) equals recording everything into one histogram
+    {
+        LatencyHistogram a, b, all;
+        for (uint64_t i = 1; i <= 5000; ++i) { a.record(i * 3); all.record(i * 3); }
+        for (uint64_t i = 1; i <= 7000; ++i) { b.record(i * 11 + 100000); all.record(i * 11 + 100000); }
+        if (!a.merge(b)) fail("merge of equal precision failed");
+        if (a.count() != all.count() || a.sum() != all.sum() || a.min() != all.min() || a.max() != all.max())
+            fail("merged totals differ");
+        for (double q = 0.05; q < 1.0; q += 0.05)
+            if (a.percentile(q) != all.percentile(q)) fail("merged percentile differs");
+        LatencyHistogram fine(10);
+        if (fine.merge(a)) fail("merging different precisions should be refused");
+        pass("Merge");
+    }
+    // Test 4: BlockProfiler keeps no raw samples by default; raw mode is exact and opt-in
+    {
+        BlockProfiler p("test");
+        BlockProfiler raw("raw");
+        raw.setRawSamples(true);
+        for (uint64_t i = 1; i <= 1000; ++i) {
+            p.recordSample(i * 100);
+            raw.recordSample(i * 100);
+        }
+        if (!p.getSamples().empty()) fail("default profiler stored raw samples");
+        if (raw.getSamples().size() != 1000) fail("raw profiler lost samples");
+        BlockProfiler::Stats s = p.getStats();
+        BlockProfiler::Stats r = raw.getStats();
+        if (s.count != 1000 || s.min_ns != 100 || s.max_ns != 100000 || s.avg_ns != 50050) fail("exact stats wrong");
+        if (r.p99_ns != 99100 || r.median_ns != 50100) fail("raw percentiles not exact");
+        if (s.p99_ns < 99000 || s.p99_ns > 99000 + 99000 / 32 + 1) fail("histogram p99 out of range");
+
+        BlockProfiler other("other");
+        for (uint64_t i = 0; i < 500; ++i) other.recordSample(1000000);
+        if (!p.merge(other)) fail("profiler merge failed");
+        if (p.getStats().count != 1500 || p.getStats().max_ns != 1000000) fail("profiler merge totals wrong");
+
+        p.configure(8, false);
+        if (p.getStats().count != 0 || p.histogram().subBucketBits() != 8) fail("configure should reset");
+        pass("BlockProfiler histogram and raw modes");
+    }
+}
+
+int main() {
+    std::cout << "\nRunning block profiler unit tests...\n";
+    testBlockProfiler();
+    std::cout << "All block profiler tests passed.\n";
+    return 0;
+}
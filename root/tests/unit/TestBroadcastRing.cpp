@@ -0,0 +1,87 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <cstdint>
+#include "BroadcastRing.h"
+
+static void fail(const std::string &msg) {
+    std::cerr << "FAIL: " << msg << "\n";
+    std::exit(1);
+}
+static void pass(const std::string &msg) {
+    std::cout << "PASS: " << msg << "\n";
+}
+
+void testBroadcastRing() {
+    // Test 1: producer is gated on the slowest critical reader
+    {
+        BroadcastRing<int> ring(4);
+        size_t r1 = ring.addReader();
+        size_t r2 = ring.addReader();
+        for (int i = 0; i < 4; ++i)
+            if (!ring.try_push(i)) fail("push into empty ring failed at " + std::to_string(i));
+        if (ring.try_push(4)) fail("push beyond capacity accepted");
+        int v = -1;
+        for (int i = 0; i < 4; ++i)
+            if (!ring.try_pop(r1, v) || v != i) fail("reader 1 value mismatch at " + std::to_string(i));
+        if (ring.try_pop(r1, v)) fail("reader 1 read past the producer");
+        if (ring.try_push(4)) fail("push accepted while reader 2 still holds the slot");
+        if (!ring.try_pop(r2, v) || v != 0) fail("reader 2 first value mismatch");
+        if (!ring.try_push(4)) fail("push rejected after the slowest reader advanced");
+        if (ring.lag(r1) != 1 || ring.lag(r2) != 4) fail("lag mismatch");
+        pass("Producer gated on slowest critical reader");
+    }
+    // Test 2: a lagging non-critical reader is detached instead of stalling the producer
+    {
+        BroadcastRing<int> ring(4);
+        size_t fast = ring.addReader(true);
+        size_t slow = ring.addReader(false);
+        int v = -1;
+        for (int i = 0; i < 12; ++i) {
+            if (!ring.try_push(i)) fail("producer stalled by non-critical reader at " + std::to_string(i));
+            if (!ring.try_pop(fast, v) || v != i) fail("critical reader mismatch at " + std::to_string(i));
+        }
+        if (!ring.isDetached(slow) || ring.detachedCount() != 1) fail("slow reader not detached");
+        if (ring.try_pop(slow, v)) fail("detached reader still receives");
+        if (!ring.exhausted(slow)) fail("detached reader should be exhausted");
+        if (ring.isDetached(fast)) fail("critical reader detached");
+        pass("Lagging non-critical reader detached");
+    }
+    // Test 3: threaded producer with three readers, every reader sees every item in order
+    {
+        const uint64_t N = 200000;
+        BroadcastRing<uint64_t> ring(64);
+        const size_t readers = 3;
+        std::vector<size_t> ids;
+        for (size_t i = 0; i < readers; ++i) ids.push_back(ring.addReader());
+        std::vector<uint64_t> counts(readers, 0);
+        std::vector<bool> ordered(readers, true);
+        std::vector<std::thread> threads;
+        for (size_t r = 0; r < readers; ++r) {
+            threads.emplace_back([&, r] {
+                uint64_t v = 0;
+                while (!ring.exhausted(ids[r])) {
+                    if (!ring.try_pop(ids[r], v)) continue;
+                    if (v != counts[r]) ordered[r] = false;
+                    ++counts[r];
+                }
+            });
+        }
+        for (uint64_t i = 0; i < N; ++i) ring.push(i);
+        ring.shutdown();
+        for (auto& t : threads) t.join();
+        for (size_t r = 0; r < readers; ++r) {
+            if (counts[r] != N) fail("reader " + std::to_string(r) + " got " + std::to_string(counts[r]));
+            if (!ordered[r]) fail("reader " + std::to_string(r) + " saw items out of order");
+        }
+        pass("Threaded broadcast to three readers");
+    }
+}
+
+int main() {
+    std::cout << "\nRunning BroadcastRing unit tests...\n";
+    testBroadcastRing();
+    std::cout << "All BroadcastRing tests passed.\n";
+    return 0;
+}
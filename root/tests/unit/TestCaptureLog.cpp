@@ -0,0 +1,57 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdint>
+#include "stream/CaptureLog.h"
+
+static void fail(const std::string &msg) {
+    std::cerr << "FAIL: " << msg << "\n";
+    std::exit(1);
+}
+static void pass(const std::string &msg) {
+    std::cout << "PASS: " << msg << "\n";
+}
+
+void testCaptureRoundTrip() {
+    // Test 1: write then read back pixels and deltas
+    {
+        const std::string path = "test_capture_roundtrip.cap";
+        CaptureWriter w;
+        if (!w.open(path, 640)) fail("CaptureWriter.open failed");
+        w.record(1, 2, 1000);
+        w.record(3, 4, 1500);
+        w.record(5, 6, 1500 + 10000000000ULL); // > UINT32_MAX gap
+        if (w.records() != 3) fail("CaptureWriter record count mismatch");
+        w.close();
+
+        if (CaptureReader::probeColumns(path) != 640) fail("CaptureReader probe columns mismatch");
+
+        CaptureReader r;
+        if (!r.open(path)) fail("CaptureReader.open failed");
+        uint8_t a = 0, b = 0;
+        uint32_t d = 0;
+        if (!r.next(a, b, d) || a != 1 || b != 2 || d != 0) fail("record 0 mismatch");
+        if (!r.next(a, b, d) || a != 3 || b != 4 || d != 500) fail("record 1 mismatch");
+        if (!r.next(a, b, d) || a != 5 || b != 6 || d != UINT32_MAX) fail("record 2 should saturate delta");
+        if (r.next(a, b, d)) fail("reader should stop at EOF");
+        pass("CaptureLog round trip");
+    }
+    // Test 2: invalid header rejected
+    {
+        const std::string path = "test_capture_bad.cap";
+        std::ofstream f(path, std::ios::binary);
+        f << "NOTACAPTUREFILE!";
+        f.close();
+        CaptureReader r;
+        if (r.open(path)) fail("CaptureReader accepted bad magic");
+        if (CaptureReader::probeColumns(path) != 0) fail("CaptureReader probe should fail on bad magic");
+        pass("CaptureLog invalid header");
+    }
+}
+
+int main() {
+    std::cout << "\nRunning CaptureLog unit tests...\n";
+    testCaptureRoundTrip();
+    std::cout << "All CaptureLog tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "stream/CsvConverter.h"
+#include "stream/CsvStreamer.h"
+#include "stream/RawStreamer.h"
+
+static void fail(const std::string &msg) {
+    std::cerr << "FAIL: " << msg << "\n";
+    std::exit(1);
+}
+static void pass(const std::string &msg) {
+    std::cout << "PASS: " << msg << "\n";
+}
+
+static void writeText(const std::string& path, const std::string& text) {
+    std::ofstream f(path, std::ios::binary);
+    f << text;
+}
+
+static std::vector<std::pair<int,int>> readCsvPairs(const std::string& path) {
+    std::vector<std::pair<int,int>> out;
+    CsvStreamer s;
+    if (!s.open(path)) fail("CsvStreamer failed to open " + path);
+    uint8_t a = 0, b = 0;
+    while (s.nextPair(a, b)) out.emplace_back(a, b);
+    return out;
+}
+
+static std::vector<std::pair<int,int>> readPgmPairs(const std::string& path) {
+    std::vector<std::pair<int,int>> out;
+    RawStreamer s;
+    if (!s.open(path, RawFormat::PGM)) fail("RawStreamer failed to open " + path);
+    uint8_t a = 0, b = 0;
+    while (s.nextPair(a, b)) out.emplace_back(a, b);
+    return out;
+}
+
+// Converts with 1..4 threads and checks the PGM replays exactly like the CSV.
+static void checkMatchesStreamer(const std::string& csv, const std::string& label) {
+    auto expected = readCsvPairs(csv);
+    for (unsigned threads = 1; threads <= 4; ++threads) {
+        const std::string pgm = "test_csv_converter.pgm";
+        ConvertResult r;
+        if (!CsvConverter::convertToPgm(csv, pgm, 0, threads, r)) fail(label + ": convert failed");
+        if (r.pixels != expected.size() * 2) fail(label + ": pixel count mismatch with " + std::to_string(threads) + " threads");
+        if (readPgmPairs(pgm) != expected) fail(label + ": pairs differ with " + std::to_string(threads) + " threads");
+    }
+}
+
+void testCsvConversion() {
+    // Test 1: large file split across several chunks, with spaces, empties, clamping and signs
+    {
+        const std::string path = "test_csv_converter_big.csv";
+        std::string text;
+        const char* tricky[] = { " 7 ", "", "300", "-5", "+12", "0", "  ", "255", "99999999999" };
+        for (int i = 0; i < 20000; ++i) {
+            text += (i % 97 == 0) ? tricky[(i / 97) % 9] : std::to_string(i % 256);
+            text += (i + 1 < 20000) ? "," : "";
+        }
+        writeText(path, text);
+        if (CsvStreamer::probeColumns(path) != 20000) fail("probeColumns mismatch on big CSV");
+        checkMatchesStreamer(path, "big CSV");
+        pass("Parallel conversion matches CsvStreamer");
+    }
+    // Test 2: malformed token truncates the output at the same pair as the streamer
+    {
+        const std::string path = "test_csv_converter_bad.csv";
+        std::string text;
+        for (int i = 0; i < 9000; ++i) text += std::to_string(i % 200) + ",";
+        text += "abc,";
+        for (int i = 0; i < 9000; ++i) text += "1,";
+        writeText(path, text);
+        checkMatchesStreamer(path, "malformed CSV");
+        ConvertResult r;
+        if (!CsvConverter::convertToPgm(path, "test_csv_converter.pgm", 0, 4, r)) fail("malformed convert failed");
+        if (!r.truncated) fail("malformed CSV should report truncation");
+        pass("Malformed token truncates output");
+    }
+    // Test 3: odd token count drops the final pixel; explicit columns reach the header
+    {
+        const std::string path = "test_csv_converter_odd.csv";
+        writeText(path, "1,2,3,4,5");
+        ConvertResult r;
+        if (!CsvConverter::convertToPgm(path, "test_csv_converter.pgm", 2, 2, r)) fail("odd convert failed");
+        if (r.pixels != 4) fail("odd CSV expected 4 pixels got " + std::to_string(r.pixels));
+        if (RawStreamer::probeColumns("test_csv_converter.pgm") != 2) fail("PGM header columns mismatch");
+        checkMatchesStreamer(path, "odd CSV");
+        pass("Odd token count and explicit columns");
+    }
+    // Test 4: missing input reports failure
+    {
+        ConvertResult r;
+        if (CsvConverter::convertToPgm("no_such_file.csv", "test_csv_converter.pgm", 0, 2, r))
+            fail("missing input should fail");
+        pass("Missing input rejected");
+    }
+}
+
+int main() {
+    std::cout << "\nRunning CsvConverter unit tests...\n";
+    testCsvConversion();
+    std::cout << "All CsvConverter tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,155 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <cstdint>
+#include "DeadlineMonitor.h"
+#include "DataGenerator.h"
+#include "FilterBlock.h"
+#include "metrics/MetricsCollector.h"
+
+static void fail(const std::string &msg) {
+    std::cerr << "FAIL: " << msg << "\n";
+    std::exit(1);
+}
+static void pass(const std::string &msg) {
+    std::cout << "PASS: " << msg << "\n";
+}
+
+class CountingCollector : public MetricsCollector {
+public:
+    void recordPair(uint64_t, uint64_t, bool, uint64_t, uint64_t, uint64_t, uint64_t,
+                    uint64_t, uint64_t, uint64_t, uint64_t) override { ++pairs; }
+    void recordShed(uint64_t firstSeq, uint64_t lastSeq, uint64_t n) override {
+        shedRuns.push_back({ firstSeq, lastSeq, n });
+    }
+    void flush() override {}
+    std::atomic<uint64_t> pairs{0};
+    struct Run { uint64_t first, last, pairs; };
+    std::vector<Run> shedRuns;
+};
+
+void testDeadlineMonitor() {
+    // Test 1: counters and the worst-K log
+    {
+        DeadlineMonitor m("test", 100, 3);
+        const uint64_t samples[] = { 50, 150, 100, 900, 120, 400, 99, 700 };
+        for (uint64_t i = 0; i < 8; ++i) m.record(i, samples[i]);
+        if (m.checked() != 8) fail("checked count wrong");
+        if (m.missed() != 5) fail("missed count wrong: " + std::to_string(m.missed()));
+        std::vector<DeadlineMiss> w = m.worst();
+        if (w.size() != 3) fail("worst log size wrong");
+        if (w[0].seq != 3 || w[0].actual_ns != 900 || w[1].seq != 7 || w[2].seq != 5)
+            fail("worst log order wrong");
+
+        DeadlineMonitor off("off", 0);
+        off.record(0, 1000000);
+        if (off.checked() != 0 || off.missed() != 0) fail("zero budget should disable the monitor");
+        pass("Miss counters and worst-K log");
+    }
+    // Test 2: watchdog alerts once, sheds, and restores after calm intervals
+    {
+        DeadlineMonitor m("test", 100);
+        DeadlineWatchdog wd(10, 0.1);
+        std::vector<bool> calls;
+        wd.watch("block", { &m }, [&](bool shed) { calls.push_back(shed); });
+
+        for (uint64_t i = 0; i < 100; ++i) m.record(i, 10);
+        if (wd.poll() || !calls.empty()) fail("alert below threshold");
+
+        for (uint64_t i = 0; i < 100; ++i) m.record(i, i < 20 ? 500 : 10); // 20% missed
+        if (!wd.poll() || calls.size() != 1 || !calls[0]) fail("no shed above threshold");
+        for (uint64_t i = 0; i < 100; ++i) m.record(i, 500);
+        wd.poll();
+        if (calls.size() != 1 || wd.alerts() != 1) fail("repeated alert while shedding");
+
+        // 6% missed is under the threshold but above half of it: not calm, stay shed
+        for (int round = 0; round < 4; ++round) {
+            for (uint64_t i = 0; i < 100; ++i) m.record(i, i < 6 ? 500 : 10);
+            if (!wd.poll()) fail("restored before calm");
+        }
+        for (int round = 0; round < 3; ++round) {
+            for (uint64_t i = 0; i < 100; ++i) m.record(i, 10);
+            wd.poll();
+        }
+        if (wd.shedding() || calls.size() != 2 || calls[1]) fail("work not restored after calm intervals");
+        pass("Watchdog alert, shed and recovery");
+    }
+    // Test 3: only the block whose own monitors miss sheds; a group without a hook only alerts
+    {
+        DeadlineMonitor gen("gen", 100), filt("filt", 100), other("other", 100);
+        DeadlineWatchdog wd(10, 0.1);
+        std::vector<bool> genCalls, filtCalls;
+        wd.watch("generator", { &gen }, [&](bool shed) { genCalls.push_back(shed); });
+        wd.watch("filter", { &filt }, [&](bool shed) { filtCalls.push_back(shed); });
+        wd.watch(&other);
+
+        for (uint64_t i = 0; i < 100; ++i) {
+            gen.record(i, 500);     // generator misses everything
+            filt.record(i, 10);
+            other.record(i, 500);
+        }
+        if (!wd.poll()) fail("no alert");
+        if (genCalls.size() != 1 || !genCalls[0]) fail("generator did not shed");
+        if (!filtCalls.empty()) fail("filter shed on the generator's misses");
+        if (wd.alerts() != 2) fail("alerts should count both alerting groups");
+        pass("Per-block shedding");
+    }
+    // Test 4: FilterBlock accounts both budgets and sheds metrics recording on request
+    {
+        const int pairs = 2000;
+        ThreadSafeQueue<DataPair> q(4096);
+        CountingCollector metrics;
+        FilterBlock filter(64, 100.0, &q, &metrics);
+        filter.setDeadlineBudgets(1, 1000000000); // pair budget always missed, gap budget never
+        for (int i = 0; i < pairs; ++i) {
+            DataPair p;
+            p.a = static_cast<uint8_t>(i);
+            p.b = static_cast<uint8_t>(i + 1);
+            p.seq = i;
+            q.push(p);
+        }
+        filter.shedOptionalWork(true);
+        for (int i = 0; i < pairs / 2; ++i) {
+            DataPair p;
+            q.try_pop(p);
+            filter.processPair(p);
+        }
+        filter.shedOptionalWork(false);
+        DataPair p;
+        while (q.try_pop(p)) filter.processPair(p);
+
+        if (filter.shedPairs != static_cast<uint64_t>(pairs / 2)) fail("shed pairs wrong");
+        if (metrics.pairs + filter.shedPairs != static_cast<uint64_t>(pairs)) fail("recorded + shed != processed");
+        if (metrics.shedRuns.size() != 1 || metrics.shedRuns[0].first != 0 ||
+            metrics.shedRuns[0].last != pairs / 2 - 1 || metrics.shedRuns[0].pairs != static_cast<uint64_t>(pairs / 2))
+            fail("shed run not reported to the collector");
+        if (filter.pairDeadline.checked() == 0 || filter.pairDeadline.missed() != filter.pairDeadline.checked())
+            fail("pair budget not enforced");
+        if (filter.gapDeadline.checked() == 0 || filter.gapDeadline.missed() != 0)
+            fail("gap budget misreported");
+        pass("FilterBlock deadline accounting and metrics shedding");
+    }
+    // Test 5: generator checks per-pair time against T_ns
+    {
+        std::ofstream("test_deadline.csv") << "1,2,3,4,5,6,7,8";
+        ThreadSafeQueue<DataPair> q(16);
+        DataGenerator gen(&q, 8, 0, InputMode::CSV, "test_deadline.csv");
+        if (gen.deadline().budget() != 0) fail("T_ns = 0 should leave the generator unmonitored");
+        gen.setDeadlineBudget(1000000000);
+        gen.start();
+        gen.stop();
+        if (gen.deadline().checked() != 4 || gen.deadline().missed() != 0) fail("generator deadline counts wrong");
+        pass("Generator per-pair deadline");
+    }
+}
+
+int main() {
+    std::cout << "\nRunning deadline monitor unit tests...\n";
+    testDeadlineMonitor();
+    std::cout << "All deadline monitor tests passed.\n";
+    return 0;
+}
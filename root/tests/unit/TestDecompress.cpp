@@ -0,0 +1,115 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdint>
+#include "stream/InputSource.h"
+#include "stream/CsvStreamer.h"
+#include "stream/RawStreamer.h"
+
+#ifdef CYNLR_WITH_ZLIB
+# include <zlib.h>
+#endif
+
+static void fail(const std::string &msg) {
+    std::cerr << "FAIL: " << msg << "\n";
+    std::exit(1);
+}
+static void pass(const std::string &msg) {
+    std::cout << "PASS: " << msg << "\n";
+}
+
+#ifdef CYNLR_WITH_ZLIB
+// Appends one gzip member holding `data` to `path`.
+static void appendGzipMember(const std::string& path, const std::string& data) {
+    z_stream zs = {};
+    if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        fail("deflateInit2 failed");
+    std::string out(deflateBound(&zs, static_cast<uLong>(data.size())) + 64, '\0');
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    zs.avail_in = static_cast<uInt>(data.size());
+    zs.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    zs.avail_out = static_cast<uInt>(out.size());
+    if (deflate(&zs, Z_FINISH) != Z_STREAM_END) fail("deflate failed");
+    out.resize(zs.total_out);
+    deflateEnd(&zs);
+    std::ofstream f(path, std::ios::binary | std::ios::app);
+    f.write(out.data(), static_cast<std::streamsize>(out.size()));
+}
+#endif
+
+void testCompressedInput() {
+    // Test 1: magic-byte detection
+    {
+        const std::string path = "test_decompress_magic.bin";
+        std::ofstream f(path, std::ios::binary);
+        f.write("\x28\xb5\x2f\xfd\x00", 5);
+        f.close();
+        if (detectCompression(path) != Compression::ZSTD) fail("zstd magic not detected");
+        std::ofstream g(path, std::ios::binary);
+        g << "1,2,3";
+        g.close();
+        if (detectCompression(path) != Compression::NONE) fail("plain file detected as compressed");
+        pass("Compression magic detection");
+    }
+
+#ifdef CYNLR_WITH_ZLIB
+    // Test 2: gzip CSV spread over two concatenated members and many chunks
+    {
+        const std::string path = "test_decompress.csv.gz";
+        std::remove(path.c_str());
+        std::string part1, part2;
+        for (int i = 0; i < 3000; ++i) part1 += std::to_string(i % 256) + ",";
+        for (int i = 3000; i < 6000; ++i) part2 += std::to_string(i % 256) + (i + 1 < 6000 ? "," : "");
+        appendGzipMember(path, part1);
+        appendGzipMember(path, part2);
+
+        if (detectCompression(path) != Compression::GZIP) fail("gzip magic not detected");
+
+        InputOptions opts;
+        opts.decompressChunkSize = 1024; // force many hand-offs through the bounded ring
+        opts.decompressChunks = 2;
+        CsvStreamer s;
+        if (!s.open(path, opts)) fail("CsvStreamer failed to open gzip input");
+        uint8_t a = 0, b = 0;
+        int pairs = 0;
+        while (s.nextPair(a, b)) {
+            if (a != (pairs * 2) % 256 || b != (pairs * 2 + 1) % 256) fail("gzip CSV value mismatch at pair " + std::to_string(pairs));
+            ++pairs;
+        }
+        if (pairs != 3000) fail("gzip CSV expected 3000 pairs got " + std::to_string(pairs));
+        if (CsvStreamer::probeColumns(path) != 6000) fail("gzip CSV probeColumns mismatch");
+        pass("CsvStreamer gzip input");
+    }
+    // Test 3: gzip PGM through RawStreamer
+    {
+        const std::string path = "test_decompress.pgm.gz";
+        std::remove(path.c_str());
+        appendGzipMember(path, std::string("P5\n2 2\n255\n", 11) + std::string("\x01\x02\x03\x04", 4));
+        if (RawStreamer::probeColumns(path) != 2) fail("gzip PGM probeColumns mismatch");
+        RawStreamer s;
+        if (!s.open(path, RawFormat::PGM)) fail("RawStreamer failed to open gzip PGM");
+        uint8_t a = 0, b = 0;
+        if (!s.nextPair(a, b) || a != 1 || b != 2) fail("gzip PGM pair 0 mismatch");
+        if (!s.nextPair(a, b) || a != 3 || b != 4) fail("gzip PGM pair 1 mismatch");
+        if (s.nextPair(a, b)) fail("gzip PGM should end after 2 pairs");
+        pass("RawStreamer gzip input");
+    }
+#else
+    // Test 2: builds without zlib refuse gzip input instead of parsing compressed bytes
+    {
+        const std::string path = "test_decompress_nosupport.gz";
+        std::ofstream f(path, std::ios::binary);
+        f.write("\x1f\x8b\x08\x00", 4);
+        f.close();
+        if (openInputSource(path, InputOptions())) fail("gzip input accepted without zlib support");
+        pass("gzip input rejected without zlib support");
+    }
+#endif
+}
+
+int main() {
+    std::cout << "\nRunning Decompress unit tests...\n";
+    testCompressedInput();
+    std::cout << "All Decompress tests passed.\n";
+    return 0;
+}
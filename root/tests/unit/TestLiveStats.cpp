@@ -0,0 +1,146 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "profiler/LiveStats.h"
+#include "StatsReporter.h"
+#include "FilterBlock.h"
+#include "ThreadSafeQueue.h"
+#include "Util.h"
+
+static void fail(const std::string &msg) {
+    std::cerr << "FAIL: " << msg << "\n";
+    std::exit(1);
+}
+static void pass(const std::string &msg) {
+    std::cout << "PASS: " << msg << "\n";
+}
+
+struct Wide {
+    uint64_t words[256];
+};
+
+void testLiveStats() {
+    // Test 1: SeqLock readers never see a half-written value
+    {
+        SeqLock<Wide> lock;
+        std::atomic<bool> done{false};
+        std::thread writer([&] {
+            Wide w;
+            for (uint64_t i = 1; !done.load(std::memory_order_relaxed); ++i) {
+                for (uint64_t& x : w.words) x = i;
+                lock.store(w);
+            }
+        });
+        Wide r;
+        uint64_t lastSeen = 0;
+        uint64_t end = util::now_ns() + 200000000ULL;
+        while (util::now_ns() < end) {
+            lock.load(r);
+            for (uint64_t x : r.words)
+                if (x != r.words[0]) fail("torn read");
+            if (r.words[0] < lastSeen) fail("value went backwards");
+            lastSeen = r.words[0];
+        }
+        done = true;
+        writer.join();
+        if (lock.version() == 0) fail("writer never published");
+        pass("SeqLock snapshots are consistent");
+    }
+    // Test 2: interval histograms come from the difference of two snapshots
+    {
+        LiveStatsPublisher pub;
+        pub.enable(1);
+        for (uint64_t v = 1; v <= 100; ++v) pub.working().service.record(1000000); // old interval: slow
+        pub.publish(1);
+        LiveBlockStats first;
+        pub.read(first);
+        for (uint64_t v = 1; v <= 100; ++v) pub.working().service.record(v);
+        pub.publish(2);
+        LiveBlockStats second;
+        pub.read(second);
+        LiveHistogram h;
+        second.service.since(first.service, h);
+        if (h.count != 100 || h.sum != 5050) fail("interval count/sum wrong");
+        if (h.max < 100 || h.max > 100 + 100 / 16 + 1) fail("interval max should ignore the earlier interval");
+        if (h.percentile(0.5) < 50 || h.percentile(0.5) > 53) fail("interval p50 wrong");
+        if (pub.publishes() != 2) fail("publish count wrong");
+        pass("Interval histograms");
+    }
+    // Test 3: reporter output (JSON and TEXT) from published snapshots
+    {
+        LiveStatsPublisher pub;
+        std::ostringstream json, text;
+        StatsReporter rj(100, ReportFormat::JSON, json);
+        StatsReporter rt(100, ReportFormat::TEXT, text);
+        rj.watch("blk", &pub);
+        rt.watch("blk", &pub);
+        if (!pub.enabled()) fail("watch should enable publishing");
+
+        LiveBlockStats& w = pub.working();
+        w.items = 500;
+        w.dropped = 3;
+        w.queueDepthSum = 1000;
+        w.queueSamples = 500;
+        w.queueCapacity = 128;
+        for (int i = 0; i < 500; ++i) w.latency.record(200);
+        pub.publish(1);
+        rj.poll();
+        rt.poll();
+        w.items = 1500;
+        pub.publish(1000000001ULL);   // one second later: 1000 items/s
+        rj.poll();
+        rt.poll();
+        rt.poll();                    // nothing new: idle
+
+        std::string j = json.str();
+        if (j.find("\"name\":\"blk\"") == std::string::npos) fail("json missing block");
+        if (j.find("\"items\":1000,\"total\":1500,\"rate\":1000.0") == std::string::npos) fail("json rate wrong: " + j);
+        if (j.find("\"dropped\":3") == std::string::npos) fail("json drops wrong");
+        if (j.find("\"capacity\":128") == std::string::npos) fail("json queue wrong");
+        std::string t = text.str();
+        if (t.find("1000 items/s") == std::string::npos) fail("text rate wrong: " + t);
+        if (t.find("blk: idle (1500 total)") == std::string::npos) fail("text idle line missing: " + t);
+        if (rt.reports() != 3) fail("report count wrong");
+        pass("JSON and text reports");
+    }
+    // Test 4: a running FilterBlock publishes while it works
+    {
+        ThreadSafeQueue<DataPair> q(1024);
+        FilterBlock filter(64, 400.0, &q);
+        std::ostringstream out;
+        StatsReporter reporter(50, ReportFormat::TEXT, out);
+        reporter.watch("filter", filter.liveStats());
+        filter.start();
+        reporter.start();
+        for (uint64_t i = 0; i < 20000; ++i) {
+            DataPair p;
+            p.a = static_cast<uint8_t>(i);
+            p.b = static_cast<uint8_t>(i * 7);
+            p.seq = i;
+            p.gen_ts_ns = util::now_ns();
+            p.gen_ts_valid = true;
+            while (!q.try_push(p)) std::this_thread::yield();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(120));
+        q.shutdown();
+        filter.stop();
+        reporter.stop();
+        LiveBlockStats s;
+        filter.liveStats()->read(s);
+        if (s.items != 20000) fail("filter live items " + std::to_string(s.items));
+        if (s.latency.count != 20000 || s.service.count == 0) fail("filter live histograms empty");
+        if (out.str().find("filter:") == std::string::npos) fail("reporter printed nothing");
+        pass("FilterBlock publishes live stats");
+    }
+}
+
+int main() {
+    std::cout << "\nRunning live stats unit tests...\n";
+    testLiveStats();
+    std::cout << "All live stats tests passed.\n";
+    return 0;
+}
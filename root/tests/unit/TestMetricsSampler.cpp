@@ -0,0 +1,145 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "metrics/MetricsSampler.h"
+#include "FilterBlock.h"
+#include "ThreadSafeQueue.h"
+
+static void fail(const std::string &msg) {
+    std::cerr << "FAIL: " << msg << "\n";
+    std::exit(1);
+}
+static void pass(const std::string &msg) {
+    std::cout << "PASS: " << msg << "\n";
+}
+
+// Keeps the seq of every recorded pair
+class SeqCollector : public MetricsCollector {
+public:
+    std::vector<uint64_t> seqs;
+    void recordPair(uint64_t seq, uint64_t, bool, uint64_t, uint64_t, uint64_t, uint64_t,
+                    uint64_t, uint64_t, uint64_t, uint64_t) override {
+        seqs.push_back(seq);
+    }
+    void flush() override {}
+};
+
+static PairMetrics pairMetrics(uint64_t seq, uint64_t latency_ns) {
+    PairMetrics m = {};
+    m.seq = seq;
+    m.gen_ts_valid = true;
+    m.queue_latency_ns = latency_ns;
+    return m;
+}
+
+// Drives the sampler the way FilterBlock does: one pair every step_ns, latency from slowSeqs
+static void run(MetricsSampler& s, SeqCollector& out, uint64_t pairs, uint64_t step_ns,
+                const std::vector<uint64_t>& slowSeqs = {}) {
+    for (uint64_t seq = 0; seq < pairs; ++seq) {
+        if (!s.wants(1 + seq * step_ns)) continue;
+        bool slow = false;
+        for (uint64_t x : slowSeqs) slow = slow || x == seq;
+        s.submit(pairMetrics(seq, slow ? 50000 : 100), out);
+    }
+}
+
+static std::vector<uint64_t> range(uint64_t first, uint64_t last) {
+    std::vector<uint64_t> v;
+    for (uint64_t i = first; i <= last; ++i) v.push_back(i);
+    return v;
+}
+
+void testMetricsSampler() {
+    // Test 1: spec parsing
+    {
+        SamplingPolicy p;
+        if (!parseSamplingSpec("every:100", p) || p.mode != SamplingMode::EVERY_N || p.everyN != 100) fail("every");
+        if (!parseSamplingSpec("burst:10:500", p) || p.mode != SamplingMode::BURST ||
+            p.burstPeriod_ns != 10000000 || p.burstPairs != 500) fail("burst");
+        if (!parseSamplingSpec("tail:20000", p) || p.mode != SamplingMode::TAIL ||
+            p.tailThreshold_ns != 20000 || p.tailWindow != 64) fail("tail");
+        if (!parseSamplingSpec("all", p) || p.mode != SamplingMode::ALL) fail("all");
+        if (parseSamplingSpec("every:0", p) || parseSamplingSpec("every", p) ||
+            parseSamplingSpec("tail:x", p) || parseSamplingSpec("sometimes", p)) fail("bad specs accepted");
+        pass("Sampling spec parsing");
+    }
+    // Test 2: 1-in-N records the first pair and every Nth after it
+    {
+        MetricsSampler s;
+        SamplingPolicy p;
+        parseSamplingSpec("every:10", p);
+        s.configure(p);
+        SeqCollector out;
+        run(s, out, 100, 1000);
+        if (out.seqs.size() != 10 || out.seqs[0] != 0 || out.seqs[1] != 10 || out.seqs[9] != 90)
+            fail("every:10 recorded " + std::to_string(out.seqs.size()));
+        if (s.seen() != 100 || s.recorded() != 10) fail("every:10 counters");
+        pass("1-in-N sampling");
+    }
+    // Test 3: a burst of consecutive pairs per period
+    {
+        MetricsSampler s;
+        SamplingPolicy p;
+        parseSamplingSpec("burst:1:5", p);   // 5 pairs every 1 ms
+        s.configure(p);
+        SeqCollector out;
+        run(s, out, 3000, 1000);             // 1 pair per us: 3 periods
+        std::vector<uint64_t> want = range(0, 4);
+        for (uint64_t x : range(1000, 1004)) want.push_back(x);
+        for (uint64_t x : range(2000, 2004)) want.push_back(x);
+        if (out.seqs != want) fail("burst recorded " + std::to_string(out.seqs.size()) + " pairs");
+        pass("Burst sampling");
+    }
+    // Test 4: tail-triggered records the window around each slow pair, nothing else
+    {
+        MetricsSampler s;
+        SamplingPolicy p;
+        parseSamplingSpec("tail:20000:3", p);
+        s.configure(p);
+        SeqCollector out;
+        run(s, out, 100, 1000, { 50, 52, 90 });
+        // 47..49 | 50 | 51, 52 (slow: window restarts), 53..55 | 87..89 | 90 | 91..93
+        std::vector<uint64_t> want = range(47, 55);
+        for (uint64_t x : range(87, 93)) want.push_back(x);
+        if (out.seqs != want) fail("tail recorded " + std::to_string(out.seqs.size()) + " pairs");
+        if (s.triggers() != 3) fail("tail triggers");
+
+        MetricsSampler quiet;
+        quiet.configure(p);
+        SeqCollector none;
+        run(quiet, none, 10000, 1000);
+        if (!none.seqs.empty() || quiet.recorded() != 0) fail("tail recorded fast pairs");
+        pass("Tail-triggered sampling");
+    }
+    // Test 5: FilterBlock applies the policy before recordPair
+    {
+        ThreadSafeQueue<DataPair> q(256);
+        SeqCollector out;
+        FilterBlock filter(64, 400.0, &q, &out);
+        SamplingPolicy p;
+        parseSamplingSpec("every:4", p);
+        filter.setMetricsSampling(p);
+        filter.startSteps();
+        for (uint32_t i = 0; i < 200; ++i) {
+            DataPair d;
+            d.a = 10;
+            d.b = 20;
+            d.seq = i;
+            q.push(d);
+        }
+        q.shutdown();
+        while (filter.step(64) != Block::StepResult::Done) {}
+        filter.stopSteps();
+        if (out.seqs.size() != 50 || out.seqs[1] != 4) fail("filter recorded " + std::to_string(out.seqs.size()));
+        if (filter.metricsSampler().seen() != 200) fail("filter sampler saw wrong pair count");
+        pass("FilterBlock sampling");
+    }
+}
+
+int main() {
+    std::cout << "\nRunning metrics sampler unit tests...\n";
+    testMetricsSampler();
+    std::cout << "All metrics sampler tests passed.\n";
+    return 0;
+}
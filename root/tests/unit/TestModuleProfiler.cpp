@@ -0,0 +1,108 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include "profiler/ModuleProfiler.h"
+#include "ThreadSafeQueue.h"
+
+static void fail(const std::string &msg) {
+    std::cerr << "FAIL: " << msg << "\n";
+    std::exit(1);
+}
+static void pass(const std::string &msg) {
+    std::cout << "PASS: " << msg << "\n";
+}
+
+static const ModuleProfiler::Entry* find(const std::vector<ModuleProfiler::Entry>& entries, const std::string& name) {
+    for (const auto& e : entries)
+        if (e.name == name) return &e;
+    return nullptr;
+}
+
+static void timedWork(uint64_t ns) {
+    CYNLR_PROFILE_SCOPE("Test.work");
+    util::hybrid_sleep_ns(ns);
+}
+
+void testModuleProfiler() {
+    // Test 1: disabled sites record nothing
+    {
+        ModuleProfiler::reset();
+        ModuleProfiler::enable(false);
+        timedWork(1000);
+        CYNLR_PROFILE_COUNT("Test.events", 1);
+        if (!ModuleProfiler::snapshot().empty()) fail("disabled profiler recorded samples");
+        pass("Disabled sites are inert");
+    }
+    // Test 2: per-thread samples merge into one entry per name
+    {
+        ModuleProfiler::reset();
+        ModuleProfiler::enable(true);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 3; ++t) {
+            threads.emplace_back([] {
+                for (int i = 0; i < 100; ++i) {
+                    CYNLR_PROFILE_RECORD("Test.known", 1000 + i);
+                    CYNLR_PROFILE_COUNT("Test.events", 2);
+                }
+            });
+        }
+        for (auto& t : threads) t.join();
+        timedWork(50000);
+        ModuleProfiler::enable(false);
+
+        auto entries = ModuleProfiler::snapshot();
+        const ModuleProfiler::Entry* known = find(entries, "Test.known");
+        const ModuleProfiler::Entry* events = find(entries, "Test.events");
+        const ModuleProfiler::Entry* work = find(entries, "Test.work");
+        if (!known || !events || !work) fail("missing entries");
+        if (known->count != 300 || known->timing.min() != 1000 || known->timing.max() != 1099) fail("timer merge wrong");
+        if (known->timing.sum() != 3 * (100 * 1000 + 4950)) fail("timer sum wrong");
+        if (events->kind != ModuleProfiler::Kind::COUNTER || events->count != 600) fail("counter merge wrong");
+        if (work->count != 1 || work->timing.min() < 50000) fail("scope timing wrong");
+        if (entries.back().kind != ModuleProfiler::Kind::COUNTER) fail("counters should come last");
+        pass("Per-thread merge");
+    }
+    // Test 3: module_profile.csv layout
+    {
+        const std::string path = "test_module_profile.csv";
+        if (!ModuleProfiler::writeCsv(path)) fail("write failed");
+        std::ifstream in(path);
+        std::string header, line;
+        std::getline(in, header);
+        if (header != "module,metric,count,avg_ns,min_ns,max_ns,median_ns,p90_ns,p99_ns,p999_ns") fail("header: " + header);
+        bool sawKnown = false, sawCounter = false;
+        while (std::getline(in, line)) {
+            if (line.find("\"Test.known\",timing,300,1049,1000,1099,") == 0) sawKnown = true;
+            if (line == "\"Test.events\",counter,600,,,,,,,") sawCounter = true;
+        }
+        in.close();
+        std::remove(path.c_str());
+        if (!sawKnown || !sawCounter) fail("csv rows wrong");
+        pass("CSV report");
+    }
+    // Test 4: the queue reports full pushes
+    {
+        ModuleProfiler::reset();
+        ModuleProfiler::enable(true);
+        ThreadSafeQueue<int> q(2);
+        int pushed = 0;
+        for (int i = 0; i < 5; ++i) pushed += q.try_push(i) ? 1 : 0;
+        ModuleProfiler::enable(false);
+        auto entries = ModuleProfiler::snapshot();
+        const ModuleProfiler::Entry* full = find(entries, "ThreadSafeQueue.try_push_full");
+        if (!full || full->count != static_cast<uint64_t>(5 - pushed)) fail("queue full counter wrong");
+        pass("Queue counters");
+    }
+}
+
+int main() {
+    std::cout << "\nRunning module profiler unit tests...\n";
+    testModuleProfiler();
+    std::cout << "All module profiler tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include "MultiPipeline.h"
+#include "FilterBlock.h"
+
+static void fail(const std::string &msg) {
+    std::cerr << "FAIL: " << msg << "\n";
+    std::exit(1);
+}
+static void pass(const std::string &msg) {
+    std::cout << "PASS: " << msg << "\n";
+}
+
+static std::string makeCsv(const std::string& name, int values) {
+    std::ofstream f(name);
+    for (int i = 0; i < values; ++i) f << (i % 256) << (i + 1 < values ? "," : "");
+    return name;
+}
+
+void testMultiPipeline() {
+    // Test 1: spec parsing overrides only the keys given
+    {
+        Config base;
+        base.threshold = 123.0;
+        Config c = base;
+        std::string name = "pipeline0";
+        if (!applyPipelineSpec("name=cam1;mode=csv;csv=a.csv;T_ns=2000;cpu=0;filter-cpu=1-2", c, name))
+            fail("valid spec rejected");
+        if (name != "cam1" || c.mode != InputMode::CSV || c.csvFile != "a.csv" || c.T_ns != 2000)
+            fail("spec values not applied");
+        if (c.threshold != 123.0) fail("unrelated base value changed");
+        if (c.placements["generator"].cpus != std::vector<int>({ 0 })) fail("generator cpus mismatch");
+        if (c.placements["filter"].cpus != std::vector<int>({ 1, 2 })) fail("filter cpus mismatch");
+
+        Config bad = base;
+        if (applyPipelineSpec("mode=video", bad, name)) fail("unknown mode accepted");
+        if (applyPipelineSpec("speed=3", bad, name)) fail("unknown key accepted");
+        if (applyPipelineSpec("T_ns=fast", bad, name)) fail("non-numeric T_ns accepted");
+        if (applyPipelineSpec("cpu=3-1", bad, name)) fail("bad cpu list accepted");
+        pass("Pipeline spec parsing");
+    }
+    // Test 2: two independent pipelines run side by side; summaries add up
+    {
+        const int pairsA = 300, pairsB = 700;
+        Config base;
+        base.mode = InputMode::CSV;
+        base.T_ns = 0;
+        base.queueCapacity = 16;
+
+        Config a = base, b = base;
+        std::string na = "A", nb = "B";
+        if (!applyPipelineSpec("csv=" + makeCsv("test_multi_a.csv", pairsA * 2) + ";columns=600", a, na)) fail("spec A");
+        if (!applyPipelineSpec("csv=" + makeCsv("test_multi_b.csv", pairsB * 2) + ";columns=1400;threshold=50", b, nb)) fail("spec B");
+
+        PipelineContext ca = buildPipeline(a, nullptr);
+        PipelineContext cb = buildPipeline(b, nullptr);
+        if (!ca.filter || !cb.filter || ca.filter == cb.filter) fail("pipelines must own separate filters");
+        if (ca.filter->TV != 400.0 || cb.filter->TV != 50.0) fail("per-pipeline threshold not applied");
+
+        if (!ca.pipeline.start() || !cb.pipeline.start()) fail("start failed");
+        for (auto* g : { ca.generator, cb.generator }) {
+            for (int i = 0; i < 5000 && g->isRunning(); ++i)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ca.pipeline.stop();
+        cb.pipeline.stop();
+
+        std::vector<PipelineSummary> s = {
+            summarizePipeline(na, ca, a),
+            summarizePipeline(nb, cb, b)
+        };
+        if (s[0].pairs != static_cast<uint64_t>(pairsA) || s[1].pairs != static_cast<uint64_t>(pairsB))
+            fail("per-pipeline pair counts wrong");
+
+        AggregateSummary agg = aggregateSummaries(s, 100.0);
+        if (agg.pipelines != 2 || agg.pairs != static_cast<uint64_t>(pairsA + pairsB)) fail("aggregate pair count wrong");
+        if (std::abs(agg.throughput - (pairsA + pairsB) * 10.0) > 1e-6) fail("aggregate throughput wrong");
+        uint64_t worst = std::max(s[0].latency_max_ns, s[1].latency_max_ns);
+        if (agg.latency_max_ns != worst) fail("aggregate max latency wrong");
+        double weighted = (s[0].latency_avg_ns * pairsA + s[1].latency_avg_ns * pairsB) / (pairsA + pairsB);
+        if (std::abs(agg.latency_avg_ns - weighted) > 1e-6) fail("aggregate avg latency not pair-weighted");
+        if (agg.slowest != (s[0].throughput <= s[1].throughput ? "A" : "B")) fail("slowest pipeline wrong");
+        pass("Independent pipelines and aggregated summary");
+    }
+}
+
+int main() {
+    std::cout << "\nRunning MultiPipeline unit tests...\n";
+    testMultiPipeline();
+    std::cout << "All MultiPipeline tests passed.\n";
+    return 0;
+}
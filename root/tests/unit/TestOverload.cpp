@@ -0,0 +1,185 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <cstdint>
+#include "DataGenerator.h"
+#include "FilterBlock.h"
+
+static void fail(const std::string &msg) {
+    std::cerr << "FAIL: " << msg << "\n";
+    std::exit(1);
+}
+static void pass(const std::string &msg) {
+    std::cout << "PASS: " << msg << "\n";
+}
+
+static std::string makeCsv(const std::string& name, int values) {
+    std::ofstream f(name);
+    for (int i = 0; i < values; ++i) f << (i % 256) << (i + 1 < values ? "," : "");
+    return name;
+}
+
+static uint64_t rangeTotal(const std::vector<DropRange>& ranges) {
+    uint64_t n = 0;
+    for (const auto& r : ranges) n += r.last - r.first + 1;
+    return n;
+}
+
+// Runs a generator with the given policy into a queue nobody drains; returns the queued seqs.
+static std::vector<uint64_t> runUndrained(OverloadPolicy policy, int pairs, int columns,
+                                          size_t capacity, DataGenerator*& genOut) {
+    static std::vector<std::unique_ptr<ThreadSafeQueue<DataPair>>> queues;
+    static std::vector<std::unique_ptr<DataGenerator>> gens;
+    queues.emplace_back(new ThreadSafeQueue<DataPair>(capacity));
+    ThreadSafeQueue<DataPair>* q = queues.back().get();
+    gens.emplace_back(new DataGenerator(q, columns, 0, InputMode::CSV,
+                                        makeCsv("test_overload.csv", pairs * 2)));
+    DataGenerator* gen = gens.back().get();
+    gen->setOverloadPolicy(policy);
+    gen->start();
+    gen->stop(); // file mode: returns at EOF, which drop policies must reach without a consumer
+    genOut = gen;
+
+    std::vector<uint64_t> seqs;
+    DataPair p;
+    while (q->try_pop(p)) seqs.push_back(p.seq);
+    return seqs;
+}
+
+void testOverload() {
+    // Test 1: push_evict keeps the newest elements in FIFO order
+    {
+        ThreadSafeQueue<int> q(4); // 3 usable slots
+        q.enableEviction();
+        int evicted = -1;
+        for (int i = 0; i < 3; ++i)
+            if (q.push_evict(i, evicted)) fail("evicted from a queue with room");
+        if (!q.push_evict(3, evicted) || evicted != 0) fail("oldest not evicted");
+        if (!q.push_evict(4, evicted) || evicted != 1) fail("second eviction wrong");
+        int v;
+        for (int expect = 2; expect <= 4; ++expect)
+            if (!q.try_pop(v) || v != expect) fail("order after eviction wrong");
+        if (q.try_pop(v)) fail("queue should be empty");
+        pass("push_evict evicts oldest");
+    }
+    // Test 2: policies against a stalled consumer never block the source
+    {
+        const int pairs = 100;
+        DataGenerator* gen = nullptr;
+
+        std::vector<uint64_t> newest = runUndrained(OverloadPolicy::DROP_NEWEST, pairs, 8, 8, gen);
+        if (newest.size() != 7 || newest.front() != 0 || newest.back() != 6) fail("drop-newest kept wrong pairs");
+        if (gen->droppedPairs() != pairs - 7 || gen->dropRanges().size() != 1 ||
+            gen->dropRanges()[0].first != 7 || gen->dropRanges()[0].last != pairs - 1)
+            fail("drop-newest range wrong");
+
+        std::vector<uint64_t> oldest = runUndrained(OverloadPolicy::DROP_OLDEST, pairs, 8, 8, gen);
+        if (oldest.size() != 7 || oldest.front() != pairs - 7 || oldest.back() != pairs - 1) fail("drop-oldest kept wrong pairs");
+        if (gen->droppedPairs() != pairs - 7 || gen->dropRanges().size() != 1 ||
+            gen->dropRanges()[0].first != 0 || gen->dropRanges()[0].last != pairs - 8)
+            fail("drop-oldest range wrong");
+
+        // 3 pairs per line: seq 7 fails mid-line (line 6..8)
+        std::vector<uint64_t> lines = runUndrained(OverloadPolicy::DROP_LINE, pairs, 6, 8, gen);
+        if (lines.size() != 7) fail("drop-line kept wrong pairs");
+        if (gen->droppedPairs() != pairs - 7 || rangeTotal(gen->dropRanges()) != gen->droppedPairs())
+            fail("drop-line accounting wrong");
+        pass("Drop policies reach EOF without a consumer");
+    }
+    // Test 3: slow consumer; drops are whole line tails and the consumer sees every other pair
+    {
+        const int pairs = 20000;
+        const int columns = 16; // 8 pairs per line
+        ThreadSafeQueue<DataPair> q(8);
+        DataGenerator gen(&q, columns, 0, InputMode::CSV, makeCsv("test_overload_lines.csv", pairs * 2));
+        gen.setOverloadPolicy(OverloadPolicy::DROP_LINE);
+
+        std::vector<uint64_t> received;
+        std::thread consumer([&] {
+            DataPair p;
+            while (q.pop(p)) {
+                received.push_back(p.seq);
+                if (received.size() % 64 == 0) std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        });
+        gen.start();
+        gen.stop();
+        consumer.join();
+
+        if (received.size() + gen.droppedPairs() != static_cast<size_t>(pairs)) fail("received + dropped != produced: " + std::to_string(received.size()) + " + " + std::to_string(gen.droppedPairs()));
+        for (size_t i = 1; i < received.size(); ++i)
+            if (received[i] <= received[i - 1]) fail("consumer saw pairs out of order");
+        for (const auto& r : gen.dropRanges())
+            if ((r.last + 1) % (columns / 2) != 0 && r.last != static_cast<uint64_t>(pairs - 1))
+                fail("drop range does not end on a line boundary: " + std::to_string(r.first) + "-" + std::to_string(r.last));
+        pass("drop-line discards line tails only");
+    }
+    // Test 4: FilterBlock counts the gaps left by dropped pairs
+    {
+        const int pairs = 50000;
+        ThreadSafeQueue<DataPair> q(4);
+        DataGenerator gen(&q, pairs * 2, 0, InputMode::CSV, makeCsv("test_overload_gaps.csv", pairs * 2));
+        gen.setOverloadPolicy(OverloadPolicy::DROP_OLDEST);
+        FilterBlock filter(pairs * 2, 100.0, &q);
+        filter.start();
+        gen.start();
+        gen.stop();
+        filter.stop();
+        if (filter.totalPairsProcessed + gen.droppedPairs() != static_cast<uint64_t>(pairs))
+            fail("processed + dropped != produced");
+        // The newest pair is never evicted, so every dropped pair shows up as a gap
+        if (filter.missingPairs != gen.droppedPairs()) fail("filter missing pairs != generator drops");
+        pass("FilterBlock reports sequence gaps");
+    }
+    // Test 5: evicting producer racing a consumer on a tiny queue; every element is popped or
+    // evicted exactly once, and no pop sees a half-written element
+    {
+        struct Item { uint64_t v; uint64_t check; };
+        const uint64_t items = 500000;
+        ThreadSafeQueue<Item> q(2);
+        q.enableEviction();
+        std::vector<uint8_t> seen(items, 0);
+        std::atomic<bool> done{false};
+        bool torn = false, unordered = false;
+        std::thread consumer([&] {
+            Item it;
+            uint64_t last = 0;
+            bool any = false;
+            while (!done.load() || q.size() > 0) {
+                if (!q.try_pop(it)) continue;
+                if (it.check != ~it.v) torn = true;
+                if (any && it.v <= last) unordered = true;
+                last = it.v;
+                any = true;
+                ++seen[it.v];
+            }
+        });
+        for (uint64_t i = 0; i < items; ++i) {
+            Item evicted;
+            if (q.push_evict(Item{i, ~i}, evicted)) {
+                if (evicted.check != ~evicted.v) torn = true;
+                ++seen[evicted.v];
+            }
+        }
+        done.store(true);
+        consumer.join();
+        Item rest;
+        while (q.try_pop(rest)) ++seen[rest.v];
+        if (torn) fail("torn element read");
+        if (unordered) fail("consumer saw elements out of order");
+        for (uint64_t i = 0; i < items; ++i)
+            if (seen[i] != 1) fail("element " + std::to_string(i) + " taken " + std::to_string(seen[i]) + " times");
+        pass("push_evict and try_pop hand out each element once");
+    }
+}
+
+int main() {
+    std::cout << "\nRunning overload policy unit tests...\n";
+    testOverload();
+    std::cout << "All overload policy tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,196 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include "Pipeline.h"
+#include "FilterBlock.h"
+
+static void fail(const std::string &msg) {
+    std::cerr << "FAIL: " << msg << "\n";
+    std::exit(1);
+}
+static void pass(const std::string &msg) {
+    std::cout << "PASS: " << msg << "\n";
+}
+
+static std::string makeCsv(const std::string& name, int values) {
+    std::ofstream f(name);
+    for (int i = 0; i < values; ++i) f << (i % 256) << (i + 1 < values ? "," : "");
+    return name;
+}
+
+// Drains its input on a worker thread until every source is shut down and empty.
+class CountingSink : public Block {
+public:
+    explicit CountingSink(const std::string& n) : name_(n) {}
+    void start() override {
+        worker = std::thread([this] {
+            ready = true;
+            DataPair p;
+            while (true) {
+                if (in_.try_pop(p)) { seqs.push_back(p.seq); continue; }
+                if (in_.exhausted()) break;
+                std::this_thread::yield();
+            }
+        });
+    }
+    void stop() override { if (worker.joinable()) worker.join(); }
+    bool isReady() const override { return ready.load(); }
+    void printStats() const override {}
+    std::string name() const override { return name_; }
+    std::vector<PortBase*> inputPorts() override { return { &in_ }; }
+
+    InputPort<DataPair> in_{"in"};
+    std::vector<uint64_t> seqs;
+private:
+    std::string name_;
+    std::thread worker;
+    std::atomic<bool> ready{false};
+};
+
+// Thread-less block with int ports that records lifecycle calls.
+class RecordingBlock : public Block {
+public:
+    RecordingBlock(const std::string& n, std::vector<std::string>& log) : name_(n), log_(log) {}
+    void start() override { log_.push_back("start " + name_); }
+    void stop() override { log_.push_back("stop " + name_); }
+    bool isReady() const override { return true; }
+    void printStats() const override {}
+    std::string name() const override { return name_; }
+    std::vector<PortBase*> inputPorts() override { return { &in_ }; }
+    std::vector<PortBase*> outputPorts() override { return { &out_ }; }
+
+    InputPort<int> in_{"in"};
+    OutputPort<int> out_{"out"};
+private:
+    std::string name_;
+    std::vector<std::string>& log_;
+};
+
+static void runToCompletion(Pipeline& p, const std::vector<DataGenerator*>& gens) {
+    if (!p.start()) fail("pipeline failed to start");
+    for (auto* g : gens) {
+        for (int i = 0; i < 5000 && g->isRunning(); ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        if (g->isRunning()) fail("generator did not reach EOF");
+    }
+    p.stop();
+}
+
+void testPipelineGraph() {
+    const int pairs = 500;
+    const std::string csv = makeCsv("test_pipeline.csv", pairs * 2);
+
+    // Test 1: buildPipeline wires generator -> filter with its own edge
+    {
+        Config config;
+        config.mode = InputMode::CSV;
+        config.csvFile = csv;
+        config.columns = pairs * 2;
+        config.T_ns = 0;
+        config.queueCapacity = 16;
+        auto ctx = buildPipeline(config, nullptr);
+        if (ctx.pipeline.edgeCount() != 1) fail("buildPipeline should create one edge");
+        runToCompletion(ctx.pipeline, { ctx.generator });
+        pass("buildPipeline creates and drains the generator -> filter edge");
+    }
+    // Test 2: fan-out delivers every pair to every consumer, in order
+    {
+        Pipeline p;
+        auto* gen = new DataGenerator(nullptr, pairs * 2, 0, InputMode::CSV, csv);
+        auto* s1 = new CountingSink("SinkA");
+        auto* s2 = new CountingSink("SinkB");
+        p.addBlock(std::unique_ptr<Block>(gen));
+        p.addBlock(std::unique_ptr<Block>(s1));
+        p.addBlock(std::unique_ptr<Block>(s2));
+        if (!p.connect(gen, "out", s1, "in", 8)) fail("fan-out connect A failed");
+        if (!p.connect(gen, gen->output(), s2, s2->in_, 32)) fail("fan-out connect B failed");
+        runToCompletion(p, { gen });
+        for (auto* s : { s1, s2 }) {
+            if (s->seqs.size() != static_cast<size_t>(pairs)) fail(s->name() + " got " + std::to_string(s->seqs.size()) + " pairs");
+            for (size_t i = 0; i < s->seqs.size(); ++i)
+                if (s->seqs[i] != i) fail(s->name() + " out of order at " + std::to_string(i));
+        }
+        pass("Fan-out to two consumers");
+    }
+    // Test 3: fan-in merges two sources and ends only when both are done
+    {
+        Pipeline p;
+        auto* g1 = new DataGenerator(nullptr, pairs * 2, 0, InputMode::CSV, csv);
+        auto* g2 = new DataGenerator(nullptr, pairs * 2, 0, InputMode::CSV, csv);
+        auto* sink = new CountingSink("Merge");
+        p.addBlock(std::unique_ptr<Block>(sink));
+        p.addBlock(std::unique_ptr<Block>(g1));
+        p.addBlock(std::unique_ptr<Block>(g2));
+        if (!p.connect(g1, "out", sink, "in", 8) || !p.connect(g2, "out", sink, "in", 8)) fail("fan-in connect failed");
+        runToCompletion(p, { g1, g2 });
+        if (sink->seqs.size() != static_cast<size_t>(pairs) * 2) fail("fan-in got " + std::to_string(sink->seqs.size()) + " pairs");
+        pass("Fan-in from two sources");
+    }
+    // Test 4: broadcast fan-out shares one ring between both consumers
+    {
+        Pipeline p;
+        auto* gen = new DataGenerator(nullptr, pairs * 2, 0, InputMode::CSV, csv);
+        auto* s1 = new CountingSink("RingA");
+        auto* s2 = new CountingSink("RingB");
+        p.addBlock(std::unique_ptr<Block>(gen));
+        p.addBlock(std::unique_ptr<Block>(s1));
+        p.addBlock(std::unique_ptr<Block>(s2));
+        if (!p.connectBroadcast(gen, "out", s1, "in", 16)) fail("broadcast connect A failed");
+        if (!p.connectBroadcast(gen, "out", s2, "in", 16)) fail("broadcast connect B failed");
+        if (p.edgeCount() != 1 || p.linkCount() != 2) fail("broadcast should be one edge with two links");
+        runToCompletion(p, { gen });
+        for (auto* s : { s1, s2 }) {
+            if (s->seqs.size() != static_cast<size_t>(pairs)) fail(s->name() + " got " + std::to_string(s->seqs.size()) + " pairs");
+            for (size_t i = 0; i < s->seqs.size(); ++i)
+                if (s->seqs[i] != i) fail(s->name() + " out of order at " + std::to_string(i));
+        }
+        pass("Broadcast ring fan-out");
+    }
+    // Test 5: type and port-name checks
+    {
+        std::vector<std::string> log;
+        Pipeline p;
+        Block* rec = p.addBlock(std::unique_ptr<Block>(new RecordingBlock("Ints", log)));
+        Block* sink = p.addBlock(std::unique_ptr<Block>(new CountingSink("Pairs")));
+        if (p.connect(rec, "out", sink, "in", 8)) fail("int -> DataPair edge accepted");
+        if (p.connect(rec, "missing", sink, "in", 8)) fail("unknown output port accepted");
+        if (p.connect(sink, "out", rec, "in", 8)) fail("block without outputs accepted as source");
+        if (p.edgeCount() != 0) fail("rejected connects must not create edges");
+        pass("Mismatched types and unknown ports rejected");
+    }
+    // Test 6: start consumers first, stop producers first; cycles refuse to start
+    {
+        std::vector<std::string> log;
+        Pipeline p;
+        Block* c = p.addBlock(std::unique_ptr<Block>(new RecordingBlock("C", log)));
+        Block* a = p.addBlock(std::unique_ptr<Block>(new RecordingBlock("A", log)));
+        Block* b = p.addBlock(std::unique_ptr<Block>(new RecordingBlock("B", log)));
+        if (!p.connect(a, "out", b, "in", 4) || !p.connect(b, "out", c, "in", 4)) fail("chain connect failed");
+        if (!p.start()) fail("acyclic chain failed to start");
+        p.stop();
+        std::vector<std::string> expected = { "start C", "start B", "start A", "stop A", "stop B", "stop C" };
+        if (log != expected) fail("lifecycle order mismatch");
+
+        log.clear();
+        Pipeline cyc;
+        Block* x = cyc.addBlock(std::unique_ptr<Block>(new RecordingBlock("X", log)));
+        Block* y = cyc.addBlock(std::unique_ptr<Block>(new RecordingBlock("Y", log)));
+        cyc.connect(x, "out", y, "in", 4);
+        cyc.connect(y, "out", x, "in", 4);
+        if (cyc.start()) fail("cyclic graph started");
+        if (!log.empty()) fail("cyclic graph started some blocks");
+        pass("Topological start/stop order and cycle detection");
+    }
+}
+
+int main() {
+    std::cout << "\nRunning Pipeline graph unit tests...\n";
+    testPipelineGraph();
+    std::cout << "All Pipeline graph tests passed.\n";
+    return 0;
+}
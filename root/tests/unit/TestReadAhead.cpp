@@ -0,0 +1,133 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "stream/ReadAheadStreambuf.h"
+#include "stream/CsvStreamer.h"
+#include "stream/RawStreamer.h"
+
+static void fail(const std::string &msg) {
+    std::cerr << "FAIL: " << msg << "\n";
+    std::exit(1);
+}
+static void pass(const std::string &msg) {
+    std::cout << "PASS: " << msg << "\n";
+}
+
+static std::string makePattern(size_t n) {
+    std::string s(n, '\0');
+    for (size_t i = 0; i < n; ++i) s[i] = static_cast<char>((i * 31 + 7) & 0xff);
+    return s;
+}
+
+void testReadAheadBackends() {
+    // Spans many small buffers and ends on a partial one
+    const std::string path = "test_readahead.bin";
+    const std::string expected = makePattern(4096 * 10 + 123);
+    {
+        std::ofstream f(path, std::ios::binary);
+        f.write(expected.data(), static_cast<std::streamsize>(expected.size()));
+    }
+
+    const ReadAheadBackend backends[] = { ReadAheadBackend::THREAD, ReadAheadBackend::AUTO };
+    for (ReadAheadBackend backend : backends) {
+        ReadAheadStreambuf buf;
+        if (!buf.open(path, 3, 4096, backend)) fail("ReadAheadStreambuf.open failed");
+        std::string got;
+        char tmp[1000];
+        std::streamsize n;
+        while ((n = buf.sgetn(tmp, sizeof(tmp))) > 0) got.append(tmp, static_cast<size_t>(n));
+        if (got != expected) fail(std::string("ReadAheadStreambuf content mismatch (") + buf.backendName() + ")");
+        pass(std::string("ReadAheadStreambuf sequential read (") + buf.backendName() + ")");
+    }
+
+    // Empty file
+    {
+        const std::string empty = "test_readahead_empty.bin";
+        std::ofstream(empty, std::ios::binary).close();
+        ReadAheadStreambuf buf;
+        if (!buf.open(empty, 2, 4096)) fail("ReadAheadStreambuf.open failed on empty file");
+        if (buf.sgetc() != std::char_traits<char>::eof()) fail("ReadAheadStreambuf empty file should hit EOF");
+        pass("ReadAheadStreambuf empty file");
+    }
+
+    // Missing file
+    {
+        ReadAheadStreambuf buf;
+        if (buf.open("nonexistent_readahead.bin", 2, 4096)) fail("ReadAheadStreambuf opened a missing file");
+        pass("ReadAheadStreambuf missing file");
+    }
+
+    // Read error (a directory opens but read() fails with EISDIR): the istream fails, not EOF
+#ifndef _WIN32
+    for (ReadAheadBackend backend : backends) {
+        ReadAheadStreambuf buf;
+        if (!buf.open(".", 2, 4096, backend)) fail("ReadAheadStreambuf.open failed on a directory");
+        std::istream in(&buf);
+        std::string line;
+        if (std::getline(in, line)) fail("read from a directory succeeded");
+        if (!in.bad() || !buf.failed() || buf.error().empty())
+            fail(std::string("read error not reported (") + buf.backendName() + ")");
+        pass(std::string("ReadAheadStreambuf read error fails the stream (") + buf.backendName() + ")");
+    }
+#endif
+}
+
+void testStreamersWithReadAhead() {
+    InputOptions opts;
+    opts.readAheadBuffers = 2;
+    opts.readAheadBufferSize = 4096;
+
+    // CSV: same pairs as the plain file path
+    {
+        const std::string path = "test_readahead.csv";
+        {
+            std::ofstream f(path);
+            for (int i = 0; i < 5000; ++i) f << (i % 300) << (i + 1 < 5000 ? "," : "");
+        }
+        CsvStreamer plain, ahead;
+        if (!plain.open(path) || !ahead.open(path, opts)) fail("CsvStreamer.open failed");
+        uint8_t a1, b1, a2, b2;
+        size_t pairs = 0;
+        for (;;) {
+            bool ok1 = plain.nextPair(a1, b1);
+            bool ok2 = ahead.nextPair(a2, b2);
+            if (ok1 != ok2) fail("CsvStreamer read-ahead pair count mismatch");
+            if (!ok1) break;
+            if (a1 != a2 || b1 != b2) fail("CsvStreamer read-ahead value mismatch at pair " + std::to_string(pairs));
+            ++pairs;
+        }
+        if (pairs != 2500) fail("CsvStreamer read-ahead expected 2500 pairs");
+        pass("CsvStreamer with read-ahead");
+    }
+
+    // RAW: odd-sized chunks are stitched correctly
+    {
+        const std::string path = "test_readahead.raw";
+        const std::string bytes = makePattern(70001);
+        {
+            std::ofstream f(path, std::ios::binary);
+            f.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        }
+        RawStreamer s;
+        if (!s.open(path, RawFormat::RAW, opts)) fail("RawStreamer.open with read-ahead failed");
+        size_t i = 0;
+        uint8_t a, b;
+        while (s.nextPair(a, b)) {
+            if (a != static_cast<uint8_t>(bytes[i]) || b != static_cast<uint8_t>(bytes[i + 1]))
+                fail("RawStreamer read-ahead mismatch at byte " + std::to_string(i));
+            i += 2;
+        }
+        if (i != 70000) fail("RawStreamer read-ahead consumed " + std::to_string(i) + " bytes");
+        pass("RawStreamer with read-ahead");
+    }
+}
+
+int main() {
+    std::cout << "\nRunning ReadAhead unit tests...\n";
+    testReadAheadBackends();
+    testStreamersWithReadAhead();
+    std::cout << "All ReadAhead tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include "DataGenerator.h"
+#include "FilterBlock.h"
+#include "Util.h"
+
+static void fail(const std::string &msg) {
+    std::cerr << "FAIL: " << msg << "\n";
+    std::exit(1);
+}
+static void pass(const std::string &msg) {
+    std::cout << "PASS: " << msg << "\n";
+}
+
+static bool waitStopped(const DataGenerator& gen, int timeout_ms) {
+    for (int i = 0; i < timeout_ms && gen.isRunning(); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return !gen.isRunning();
+}
+
+void testSaturation() {
+    // Test 1: an unpaced random source ends its stream after the pair limit
+    {
+        ThreadSafeQueue<DataPair> q(64);
+        DataGenerator gen(&q, 64, 0, InputMode::RANDOM);
+        gen.setStopAfter(20000, 0);
+        FilterBlock filter(64, 100.0, &q);
+        filter.start();
+        gen.start();
+        if (!waitStopped(gen, 10000)) fail("generator did not stop at the pair limit");
+        gen.stop();
+        filter.stop();
+        if (filter.totalPairsProcessed != 20000) fail("filter saw " + std::to_string(filter.totalPairsProcessed) + " pairs");
+        if (!q.isShutdown()) fail("limit should shut the output down");
+        pass("Pair limit ends a random stream");
+    }
+    // Test 2: duration limit
+    {
+        ThreadSafeQueue<DataPair> q(64);
+        DataGenerator gen(&q, 64, 0, InputMode::RANDOM);
+        gen.setStopAfter(0, 50 * 1000000ULL);
+        FilterBlock filter(64, 100.0, &q);
+        filter.start();
+        uint64_t t0 = util::now_ns();
+        gen.start();
+        if (!waitStopped(gen, 10000)) fail("generator did not stop after its duration");
+        uint64_t ms = (util::now_ns() - t0) / 1000000;
+        gen.stop();
+        filter.stop();
+        if (ms < 50) fail("stopped before the duration elapsed");
+        if (filter.totalPairsProcessed == 0) fail("nothing produced");
+        pass("Duration limit ends a random stream");
+    }
+    // Test 3: a stalled consumer shows up as queue-full time, a slow source as consumer idle time
+    {
+        ThreadSafeQueue<DataPair> q(8);
+        DataGenerator gen(&q, 64, 0, InputMode::RANDOM);
+        gen.setStopAfter(100, 0);
+        gen.start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(30)); // nobody drains yet
+        FilterBlock filter(64, 100.0, &q);
+        filter.start();
+        if (!waitStopped(gen, 10000)) fail("generator did not finish");
+        gen.stop();
+        filter.stop();
+        if (gen.queueFullStallNs() < 20 * 1000000ULL) fail("queue-full stall not measured: " + std::to_string(gen.queueFullStallNs()));
+        pass("Queue-full stall time");
+
+        ThreadSafeQueue<DataPair> q2(64);
+        DataGenerator paced(&q2, 64, 2000000, InputMode::RANDOM); // one pair per 2 ms
+        paced.setStopAfter(10, 0);
+        FilterBlock consumer(64, 100.0, &q2);
+        consumer.start();
+        paced.start();
+        if (!waitStopped(paced, 10000)) fail("paced generator did not finish");
+        paced.stop();
+        consumer.stop();
+        if (consumer.idleNs < 10 * 1000000ULL) fail("consumer idle time not measured: " + std::to_string(consumer.idleNs));
+        pass("Consumer idle time");
+    }
+    // Test 4: the pooled step path honours the limit too
+    {
+        ThreadSafeQueue<DataPair> q(16);
+        DataGenerator gen(&q, 64, 0, InputMode::RANDOM);
+        gen.setStopAfter(1000, 0);
+        gen.startSteps();
+        uint64_t received = 0;
+        DataPair p;
+        while (gen.step(8) != Block::StepResult::Done) {
+            while (q.try_pop(p)) ++received;
+        }
+        while (q.try_pop(p)) ++received;
+        gen.stopSteps();
+        if (received != 1000 || !q.isShutdown()) fail("pooled limit wrong: " + std::to_string(received));
+        pass("Pooled step honours the limit");
+    }
+}
+
+int main() {
+    std::cout << "\nRunning saturation unit tests...\n";
+    testSaturation();
+    std::cout << "All saturation tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <iostream>
+#include <string>
+#include <cstdint>
+#include "Config.h"
+#include "Simulation.h"
+
+static void fail(const std::string &msg) {
+    std::cerr << "FAIL: " << msg << "\n";
+    std::exit(1);
+}
+static void pass(const std::string &msg) {
+    std::cout << "PASS: " << msg << "\n";
+}
+
+static Config baseConfig(uint64_t T_ns, uint64_t pairs) {
+    Config c;
+    c.mode = InputMode::RANDOM;
+    c.columns = 64;
+    c.T_ns = T_ns;
+    c.queueCapacity = 16;
+    c.simulate = true;
+    c.sim.gen_ns = 50;
+    c.sim.push_ns = 20;
+    c.sim.filter_ns = 100;
+    c.sim.pairs = pairs;
+    return c;
+}
+
+void testSimulation() {
+    // Test 1: spec parsing
+    {
+        SimulationOptions o;
+        if (!parseSimulationSpec("gen=10;filter=300;stall=5000;stall-rate=0.01;pairs=42;ms=7;seed=9", o))
+            fail("valid spec rejected");
+        if (o.gen_ns != 10 || o.filter_ns != 300 || o.stall_ns != 5000 || o.stall_rate != 0.01 ||
+            o.pairs != 42 || o.duration_ms != 7 || o.seed != 9 || o.push_ns != 20)
+            fail("spec values wrong");
+        if (parseSimulationSpec("bogus=1", o) || parseSimulationSpec("stall-rate=2", o))
+            fail("bad spec accepted");
+        pass("Simulation spec parsing");
+    }
+    // Test 2: an underloaded line sees only push + filter cost and an empty queue
+    {
+        Config c = baseConfig(1000, 10000);
+        SimulationResult r;
+        if (!runSimulation(c, r)) fail("simulation failed");
+        if (r.generated != 10000 || r.processed != 10000 || r.dropped != 0) fail("pair counts wrong");
+        if (r.latency_p50_ns != 120 || r.latency_max_ns != 120) fail("latency should be push + filter = 120 ns, max " + std::to_string(r.latency_max_ns));
+        if (r.occupancy_max > 1 || r.blocked_ns != 0) fail("underloaded queue should stay empty");
+        // 10000 pairs, one every T_ns = 1 us
+        if (r.virtual_ns < 9999 * 1000 || r.virtual_ns > 10000 * 1000 + 1000) fail("virtual time wrong: " + std::to_string(r.virtual_ns));
+        if (r.achieved_rate < 0.99e6 || r.achieved_rate > 1.01e6) fail("achieved rate wrong");
+        pass("Underloaded line");
+    }
+    // Test 3: filter slower than the line rate fills the queue and blocks the generator
+    {
+        Config c = baseConfig(100, 20000);
+        c.sim.filter_ns = 200;
+        SimulationResult r;
+        if (!runSimulation(c, r)) fail("simulation failed");
+        if (r.processed != 20000) fail("BLOCK lost pairs");
+        if (r.occupancy_max != r.capacity) fail("queue never filled");
+        if (r.blocked_ns == 0) fail("generator never blocked");
+        if (r.filter_utilization < 0.99) fail("filter should be saturated");
+        if (r.achieved_rate < 4.9e6 || r.achieved_rate > 5.1e6) fail("rate should be capped by the filter (5M/s)");
+
+        c.overload = OverloadPolicy::DROP_NEWEST;
+        SimulationResult d;
+        if (!runSimulation(c, d)) fail("simulation failed");
+        if (d.dropped == 0 || d.processed + d.dropped != d.generated) fail("drop accounting wrong");
+        if (d.blocked_ns != 0) fail("drop policy should never block");
+        pass("Overloaded line: blocking and dropping");
+    }
+    // Test 4: deterministic stalls, virtual duration, faster than real time
+    {
+        Config c = baseConfig(10000, 0);
+        c.sim.duration_ms = 2000; // 200k pairs
+        c.sim.stall_ns = 50000;
+        c.sim.stall_rate = 0.001;
+        c.sim.seed = 7;
+        SimulationResult a, b;
+        if (!runSimulation(c, a) || !runSimulation(c, b)) fail("simulation failed");
+        if (a.generated < 199990 || a.generated > 200000) fail("duration limit wrong: " + std::to_string(a.generated));
+        if (a.stalls == 0) fail("no stalls drawn");
+        if (a.stalls != b.stalls || a.latency_max_ns != b.latency_max_ns || a.occupancy_max != b.occupancy_max ||
+            a.virtual_ns != b.virtual_ns)
+            fail("same seed gave different results");
+        if (a.latency_max_ns < 50000) fail("stall missing from latency");
+        if (a.wall_ms >= a.virtual_ns / 1e6) fail("simulation ran slower than real time");
+        pass("Deterministic stalls in virtual time");
+    }
+}
+
+int main() {
+    std::cout << "\nRunning simulation unit tests...\n";
+    testSimulation();
+    std::cout << "All simulation tests passed.\n";
+    return 0;
+}
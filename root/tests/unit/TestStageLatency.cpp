@@ -0,0 +1,104 @@
+#include <iostream>
+#include <string>
+#include <cstdint>
+#include "profiler/StageLatency.h"
+#include "FilterBlock.h"
+#include "DataGenerator.h"
+#include "ThreadSafeQueue.h"
+
+static void fail(const std::string &msg) {
+    std::cerr << "FAIL: " << msg << "\n";
+    std::exit(1);
+}
+static void pass(const std::string &msg) {
+    std::cout << "PASS: " << msg << "\n";
+}
+
+static uint64_t g_now = 0;
+static uint64_t fakeNow() { return g_now; }
+
+void testStageLatency() {
+    // Test 1: 32-bit stamps saturate and never go negative
+    {
+        if (stageDelta(100, 250) != 150) fail("delta wrong");
+        if (stageDelta(250, 100) != 0) fail("earlier time should clamp to 0");
+        if (stageDelta(0, 5000000000ULL) != 0xFFFFFFFFu) fail("delta should saturate");
+        pass("stageDelta");
+    }
+    // Test 2: stages add up to end-to-end, and the tail is blamed on the slow stage
+    {
+        StageLatency s;
+        for (int i = 0; i < 990; ++i) {
+            PairStages p;
+            p.valid = true;
+            p.gen_ns = 1000000;
+            p.pace = 10; p.enq = 20; p.deq = 120; p.filtered = 170;
+            s.record(p, 1000000 + 400);                       // output wait 230
+        }
+        for (int i = 0; i < 10; ++i) {
+            PairStages p;
+            p.valid = true;
+            p.gen_ns = 1000000;
+            p.pace = 10; p.enq = 20; p.deq = 50020; p.filtered = 50070;
+            s.record(p, 1000000 + 50300);                     // 50 us in the queue
+        }
+        if (s.count() != 1000) fail("count wrong");
+        if (s.stage(STAGE_PUSH).max() != 20 || s.stage(STAGE_COMPUTE).max() != 50) fail("stage values wrong");
+        if (s.stage(STAGE_OUTPUT).min() != 230 || s.stage(STAGE_QUEUE).max() != 50000) fail("stage values wrong");
+        if (s.endToEnd().min() != 410 || s.endToEnd().max() != 50310) fail("end-to-end should be the stage sum");
+
+        double mean[kStageCount];
+        uint64_t threshold = 0;
+        uint64_t pairs = s.tailBreakdown(0.995, mean, threshold);
+        if (pairs != 10) fail("tail should be the 10 slow pairs, got " + std::to_string(pairs));
+        if (mean[STAGE_QUEUE] != 50000.0 || mean[STAGE_PACE] != 10.0) fail("tail means wrong");
+
+        StageLatency other;
+        if (!other.merge(s) || other.count() != 1000) fail("merge wrong");
+        pass("Stage breakdown and tail attribution");
+    }
+    // Test 3: the filter finishes a pair's record when the FIR emits its outputs
+    {
+        if (sizeof(DataPair) != 32) fail("DataPair grew");
+        ThreadSafeQueue<DataPair> q(64);
+        FilterBlock filter(64, 400.0, &q);
+        filter.setClock(fakeNow);
+        filter.startSteps();
+        const int kPairs = 10;
+        for (int i = 0; i < kPairs; ++i) {
+            DataPair p;
+            p.a = static_cast<uint8_t>(i);
+            p.b = static_cast<uint8_t>(i + 1);
+            p.seq = i;
+            p.gen_ts_ns = 1000000 + 1000 * i;
+            p.gen_ts_valid = true;
+            p.pace_late_ns = 5;
+            p.enq_delta_ns = 10;
+            q.push(p);
+            g_now = p.gen_ts_ns + 100;            // dequeued and filtered 100 ns after generation
+            if (filter.step(1) != Block::StepResult::Progress) fail("step should make progress");
+        }
+        q.shutdown();
+        g_now += 2000;                            // flush: pair 9's outputs two pairs later, pair 8's three
+        if (filter.step(1) != Block::StepResult::Done) fail("filter should finish");
+        filter.stopSteps();
+
+        const StageLatency& s = filter.stageLatency();
+        // Pairs 0 and 1 only feed the FIR warm-up (no centred output); 2..9 complete.
+        if (s.count() != kPairs - 2) fail("completed pairs " + std::to_string(s.count()));
+        if (s.stage(STAGE_PACE).max() != 5 || s.stage(STAGE_PUSH).max() != 10) fail("producer stamps lost");
+        if (s.stage(STAGE_QUEUE).min() != 90 || s.stage(STAGE_QUEUE).max() != 90) fail("queue stage wrong");
+        if (s.stage(STAGE_COMPUTE).max() != 0) fail("compute stage wrong");
+        if (s.stage(STAGE_OUTPUT).min() != 2000 || s.stage(STAGE_OUTPUT).max() != 3000)
+            fail("output stage should be the two-pair FIR lookahead");
+        if (s.endToEnd().min() != 2105 || s.endToEnd().max() != 3105) fail("end-to-end wrong");
+        pass("FilterBlock stage stamps");
+    }
+}
+
+int main() {
+    std::cout << "\nRunning stage latency unit tests...\n";
+    testStageLatency();
+    std::cout << "All stage latency tests passed.\n";
+    return 0;
+}
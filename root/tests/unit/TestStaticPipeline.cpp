@@ -0,0 +1,120 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <cstdint>
+#include <cmath>
+#include "StaticPipeline.h"
+#include "StaticStages.h"
+#include "FilterBlock.h"
+
+static void fail(const std::string &msg) {
+    std::cerr << "FAIL: " << msg << "\n";
+    std::exit(1);
+}
+static void pass(const std::string &msg) {
+    std::cout << "PASS: " << msg << "\n";
+}
+
+// 1..n
+struct CountingSource {
+    using value_type = int;
+    explicit CountingSource(int n) : n_(n) {}
+    bool next(int& out) {
+        if (i_ >= n_) return false;
+        out = ++i_;
+        return true;
+    }
+    int n_;
+    int i_ = 0;
+};
+
+// Emits x and -x (two outputs per input).
+struct Mirror : StaticStage {
+    template <typename Next>
+    void process(int x, Next& next) { next.push(x); next.push(-x); }
+};
+
+// Drops negatives; on finish emits one marker value before passing end-of-stream on.
+struct PositiveOnly : StaticStage {
+    template <typename Next>
+    void process(int x, Next& next) { if (x > 0) next.push(static_cast<long long>(x)); }
+    template <typename Next>
+    void finish(Next& next) { next.push(1000LL); next.finish(); }
+};
+
+struct Collect : StaticStage {
+    template <typename Next>
+    void process(long long x, Next&) { values.push_back(x); thread = std::this_thread::get_id(); }
+    template <typename Next>
+    void finish(Next&) { finished = true; }
+    std::vector<long long> values;
+    std::thread::id thread;
+    bool finished = false;
+};
+
+struct KeepOutputs : StaticStage {
+    template <typename Next>
+    void process(const FilterOutput& o, Next&) { out.push_back(o); }
+    std::vector<FilterOutput> out;
+};
+
+static void checkCollected(const Collect& c, int n, const std::string& label) {
+    if (!c.finished) fail(label + ": sink not finished");
+    if (c.values.size() != static_cast<size_t>(n) + 1) fail(label + ": wrong output count");
+    for (int i = 0; i < n; ++i)
+        if (c.values[i] != i + 1) fail(label + ": value mismatch at " + std::to_string(i));
+    if (c.values.back() != 1000) fail(label + ": finish flush missing");
+}
+
+void testStaticPipeline() {
+    // Test 1: inlined chain on the calling thread
+    {
+        StaticPipeline<CountingSource, Mirror, PositiveOnly, Collect> p(CountingSource(1000), Mirror(), PositiveOnly(), Collect());
+        if (p.run() != 1000) fail("inline: source count mismatch");
+        checkCollected(p.stage<2>(), 1000, "inline");
+        if (p.stage<2>().thread != std::this_thread::get_id()) fail("inline: sink ran on another thread");
+        pass("Inlined static chain");
+    }
+    // Test 2: a ThreadBoundary moves the downstream stages to their own thread, order preserved
+    {
+        StaticPipeline<CountingSource, Mirror, ThreadBoundary<int>, PositiveOnly, Collect> p(
+            CountingSource(50000), Mirror(), ThreadBoundary<int>(64), PositiveOnly(), Collect());
+        if (p.run() != 50000) fail("split: source count mismatch");
+        checkCollected(p.stage<3>(), 50000, "split");
+        if (p.stage<3>().thread == std::this_thread::get_id()) fail("split: sink ran on the source thread");
+        pass("ThreadBoundary splits the chain across threads");
+    }
+    // Test 3: FirThresholdStage matches FilterBlock's arithmetic and zero flush
+    {
+        const std::string path = "test_static_fir.csv";
+        const int values = 40;
+        {
+            std::ofstream f(path);
+            for (int i = 0; i < values; ++i) f << (i * 37) % 256 << (i + 1 < values ? "," : "");
+        }
+        FilterBlock reference(values, 100.0, nullptr);
+        FirThresholdStage fir(reference.fir_kernel, 100.0);
+        StaticPipeline<PairSource, FirThresholdStage, KeepOutputs> p(PairSource(InputMode::CSV, path, 0), fir, KeepOutputs());
+        if (!p.source().ok()) fail("PairSource failed to open CSV");
+        if (p.run() != values / 2) fail("FIR: wrong pair count");
+        const auto& out = p.stage<1>().out;
+        // First output once 9 samples are buffered, plus 4 zero-flush outputs at the end.
+        if (out.size() != static_cast<size_t>(values - 9 + 1 + 4)) fail("FIR: wrong output count " + std::to_string(out.size()));
+
+        std::vector<double> window;
+        for (int i = 0; i < 9; ++i) window.push_back((i * 37) % 256);
+        double expected = reference.testApplyFIR(window);
+        if (std::abs(out[0].filtered - expected) > 1e-9) fail("FIR: first output differs from FilterBlock");
+        if (out[0].value != (expected >= 100.0 ? 1 : 0)) fail("FIR: threshold bit mismatch");
+        pass("FirThresholdStage matches FilterBlock");
+    }
+}
+
+int main() {
+    std::cout << "\nRunning StaticPipeline unit tests...\n";
+    testStaticPipeline();
+    std::cout << "All StaticPipeline tests passed.\n";
+    return 0;
+}
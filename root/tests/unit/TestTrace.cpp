@@ -0,0 +1,107 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <cstdint>
+#include <cstdio>
+#include "profiler/Trace.h"
+#include "Util.h"
+
+static void fail(const std::string &msg) {
+    std::cerr << "FAIL: " << msg << "\n";
+    std::exit(1);
+}
+static void pass(const std::string &msg) {
+    std::cout << "PASS: " << msg << "\n";
+}
+
+static std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+static size_t countOf(const std::string& s, const std::string& what) {
+    size_t n = 0;
+    for (size_t p = s.find(what); p != std::string::npos; p = s.find(what, p + 1)) ++n;
+    return n;
+}
+
+void testTrace() {
+    const std::string path = "test_trace.json";
+
+    // Test 1: nothing is recorded before start() or after stop()
+    {
+        Tracer::stop();
+        TraceScope ignored("before start");
+        if (Tracer::enabled()) fail("tracer should start disabled");
+        Tracer::start(64);
+        Tracer::stop();
+        { TraceScope s("after stop"); }
+        if (Tracer::eventCount() != 0) fail("events recorded while disabled");
+        pass("Disabled tracer records nothing");
+    }
+    // Test 2: per-thread buffers, names, spans and counters in Chrome JSON
+    {
+        Tracer::start(64);
+        std::thread worker([] {
+            Tracer::setThreadName("worker \"A\"");
+            { TraceScope s("work"); util::hybrid_sleep_ns(20000); }
+            Tracer::counter("queue depth", 7);
+        });
+        worker.join();
+        uint64_t t = util::now_ns();
+        Tracer::complete("span", t, t + 2500);
+        Tracer::instant("mark");
+        Tracer::stop();
+        if (Tracer::eventCount() != 4) fail("expected 4 events, got " + std::to_string(Tracer::eventCount()));
+        if (!Tracer::writeChromeJson(path)) fail("write failed");
+
+        std::string j = readFile(path);
+        if (j.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[") != 0) fail("bad header: " + j.substr(0, 60));
+        if (j.find("\"args\":{\"name\":\"worker \\\"A\\\"\"}") == std::string::npos) fail("thread name not escaped");
+        if (j.find("\"name\":\"thread 2\"") == std::string::npos) fail("unnamed thread should get a default name");
+        if (j.find("\"name\":\"span\",\"ph\":\"X\",\"pid\":1,\"tid\":2,\"ts\":") == std::string::npos) fail("span event missing");
+        if (j.find("\"dur\":2.500}") == std::string::npos) fail("span duration should be in microseconds");
+        if (j.find("\"ph\":\"C\",\"pid\":1,\"tid\":1") == std::string::npos ||
+            j.find("\"id\":1,\"args\":{\"value\":7}") == std::string::npos) fail("counter event missing");
+        if (j.find("\"name\":\"mark\",\"ph\":\"i\"") == std::string::npos) fail("instant event missing");
+        if (countOf(j, "\"ph\":\"M\"") != 2) fail("expected one metadata event per thread");
+        if (j.find("\"otherData\":{\"dropped_events\":0}}") == std::string::npos) fail("trailer missing");
+        pass("Chrome trace JSON");
+    }
+    // Test 3: a full buffer drops instead of growing; start() discards old buffers
+    {
+        Tracer::start(8);
+        for (int i = 0; i < 20; ++i) Tracer::instant("tick");
+        Tracer::stop();
+        if (Tracer::eventCount() != 8 || Tracer::droppedCount() != 12) fail("buffer bound not applied");
+        Tracer::start(8);
+        Tracer::instant("tick");
+        Tracer::stop();
+        if (Tracer::eventCount() != 1 || Tracer::droppedCount() != 0) fail("start() should discard earlier events");
+        pass("Bounded buffers");
+    }
+    // Test 4: the macros follow the build flag
+    {
+        Tracer::start(64);
+        {
+            CYNLR_TRACE_SCOPE("macro scope");
+            CYNLR_TRACE_COUNTER("macro counter", 1);
+        }
+        Tracer::stop();
+        uint64_t expected = Tracer::compiledIn() ? 2 : 0;
+        if (Tracer::eventCount() != expected) fail("macro event count wrong");
+        pass(Tracer::compiledIn() ? "Macros record (CYNLR_ENABLE_TRACING)" : "Macros compile to nothing");
+    }
+    std::remove(path.c_str());
+}
+
+int main() {
+    std::cout << "\nRunning trace unit tests...\n";
+    testTrace();
+    std::cout << "All trace tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <iostream>
+#include <string>
+#include <cstdint>
+#include <cmath>
+#include "profiler/Utilization.h"
+#include "FilterBlock.h"
+#include "ThreadSafeQueue.h"
+
+static void fail(const std::string &msg) {
+    std::cerr << "FAIL: " << msg << "\n";
+    std::exit(1);
+}
+static void pass(const std::string &msg) {
+    std::cout << "PASS: " << msg << "\n";
+}
+
+static uint64_t g_now = 0;
+static uint64_t fakeNow() { return g_now; }
+
+void testUtilization() {
+    // Test 1: transitions split wall time into busy and idle
+    {
+        UtilizationMeter m;
+        m.idle(50);                 // not started: ignored
+        if (m.started() || m.busyNs(100) != 0 || m.idleNs(100) != 0) fail("meter started early");
+        m.busy(100);
+        m.busy(150);                // already busy: no-op
+        m.idle(400);                // busy 300
+        m.idle(450);
+        if (m.busyNs(500) != 300 || m.idleNs(500) != 100) fail("open idle interval not counted");
+        m.busy(700);                // idle 300
+        m.waited(50);               // a stall inside the busy interval
+        // busy 300 + 100 open - 50 waited, idle 100 + 200 + 50
+        if (m.busyNs(800) != 350 || m.idleNs(800) != 350) fail("waited time not moved to idle");
+        m.stop(900);
+        if (m.busyNs(5000) != 450 || m.idleNs(5000) != 350) fail("stop did not close the interval");
+        if (std::fabs(UtilizationMeter::utilization(450, 350) - 0.5625) > 1e-9) fail("utilization wrong");
+        if (UtilizationMeter::utilization(0, 0) != 0.0) fail("empty utilization");
+
+        UtilizationMeter back;
+        back.busy(1000);
+        back.idle(900);             // clock went backwards: counts as 0
+        if (back.busyNs(900) != 0) fail("backwards interval counted");
+        pass("Busy / idle transitions");
+    }
+    // Test 2: FilterBlock is busy while filtering, idle while its input is empty
+    {
+        ThreadSafeQueue<DataPair> q(16);
+        FilterBlock filter(64, 400.0, &q);
+        filter.setClock(fakeNow);
+        filter.startSteps();
+
+        g_now = 1000;
+        q.push(DataPair{});
+        if (filter.step(1) != Block::StepResult::Progress) fail("first pair");
+        g_now = 1100;                                   // first pair took 100 ns
+        if (filter.step(1) != Block::StepResult::Idle) fail("empty input should idle");
+        g_now = 1500;                                   // 400 ns with nothing to do
+        q.push(DataPair{});
+        if (filter.step(1) != Block::StepResult::Progress) fail("second pair");
+        g_now = 1600;
+        q.shutdown();
+        if (filter.step(1) != Block::StepResult::Done) fail("filter should finish");
+        filter.stopSteps();
+
+        const UtilizationMeter& m = filter.utilization();
+        if (m.busyNs(g_now) != 200 || m.idleNs(g_now) != 400)
+            fail("filter busy " + std::to_string(m.busyNs(g_now)) + " idle " + std::to_string(m.idleNs(g_now)));
+        pass("FilterBlock busy / idle accounting");
+    }
+}
+
+int main() {
+    std::cout << "\nRunning utilization unit tests...\n";
+    testUtilization();
+    std::cout << "All utilization tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,204 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include "WorkStealingPool.h"
+#include "Pipeline.h"
+#include "FilterBlock.h"
+#include "Util.h"
+
+static void fail(const std::string &msg) {
+    std::cerr << "FAIL: " << msg << "\n";
+    std::exit(1);
+}
+static void pass(const std::string &msg) {
+    std::cout << "PASS: " << msg << "\n";
+}
+
+static std::string makeCsv(const std::string& name, int values) {
+    std::ofstream f(name);
+    for (int i = 0; i < values; ++i) f << (i % 256) << (i + 1 < values ? "," : "");
+    return name;
+}
+
+// Pooled-only sink: records seqs and the worker each step ran on.
+class StepSink : public Block {
+public:
+    explicit StepSink(const std::string& n) : name_(n) {}
+    void start() override { fail(name_ + ": start() called in pool mode"); }
+    void stop() override {}
+    bool isReady() const override { return true; }
+    void printStats() const override {}
+    std::string name() const override { return name_; }
+    std::vector<PortBase*> inputPorts() override { return { &in_ }; }
+
+    bool supportsStep() const override { return true; }
+    StepResult step(size_t maxItems) override {
+        if (inStep.exchange(true)) overlapped = true;
+        size_t n = 0;
+        DataPair p;
+        while (n < maxItems && in_.try_pop(p)) { seqs.push_back(p.seq); ++n; }
+        StepResult r = n > 0 ? StepResult::Progress
+                     : in_.exhausted() ? StepResult::Done : StepResult::Idle;
+        if (r == StepResult::Done) finished = true;
+        inStep = false;
+        return r;
+    }
+
+    InputPort<DataPair> in_{"in"};
+    std::vector<uint64_t> seqs;
+    std::atomic<bool> inStep{false};
+    bool overlapped = false;
+    bool finished = false;
+private:
+    std::string name_;
+};
+
+static void waitForGenerators(const std::vector<DataGenerator*>& gens) {
+    for (auto* g : gens) {
+        for (int i = 0; i < 10000 && g->isRunning(); ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        if (g->isRunning()) fail("generator did not reach EOF");
+    }
+}
+
+void testWorkStealingPool() {
+    // Test 1: every task runs once, including tasks submitted from workers
+    {
+        WorkStealingPool pool(3);
+        std::atomic<int> ran{0};
+        const int outer = 200;
+        for (int i = 0; i < outer; ++i) {
+            pool.submit([&] {
+                ++ran;
+                if (pool.currentWorker() < 0) fail("task not on a pool worker");
+                for (int k = 0; k < 4; ++k) pool.submit([&] { ++ran; });
+            });
+        }
+        for (int i = 0; i < 5000 && ran.load() < outer * 5; ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        if (ran.load() != outer * 5) fail("pool ran " + std::to_string(ran.load()) + " tasks");
+        if (pool.currentWorker() != -1) fail("main thread reported as a worker");
+        pass("All submitted tasks run");
+    }
+    // Test 2: many pipelines share a small pool; each keeps its order and finishes
+    {
+        const int pairs = 2000;
+        const int pipelines = 6;
+        const std::string csv = makeCsv("test_pool.csv", pairs * 2);
+        WorkStealingPool pool(2);
+
+        std::vector<std::unique_ptr<Pipeline>> ps;
+        std::vector<DataGenerator*> gens;
+        std::vector<StepSink*> sinks;
+        for (int i = 0; i < pipelines; ++i) {
+            std::unique_ptr<Pipeline> p(new Pipeline());
+            auto* gen = new DataGenerator(nullptr, pairs * 2, 0, InputMode::CSV, csv);
+            auto* sink = new StepSink("Sink" + std::to_string(i));
+            p->addBlock(std::unique_ptr<Block>(gen));
+            p->addBlock(std::unique_ptr<Block>(sink));
+            if (!p->connect(gen, "out", sink, "in", 16)) fail("connect failed");
+            if (!p->start(&pool, 32)) fail("pooled pipeline failed to start");
+            gens.push_back(gen);
+            sinks.push_back(sink);
+            ps.push_back(std::move(p));
+        }
+        waitForGenerators(gens);
+        for (auto& p : ps) p->stop();
+
+        for (auto* s : sinks) {
+            if (!s->finished) fail(s->name() + " never saw end-of-stream");
+            if (s->overlapped) fail(s->name() + " stepped concurrently");
+            if (s->seqs.size() != static_cast<size_t>(pairs)) fail(s->name() + " got " + std::to_string(s->seqs.size()) + " pairs");
+            for (size_t i = 0; i < s->seqs.size(); ++i)
+                if (s->seqs[i] != i) fail(s->name() + " out of order at " + std::to_string(i));
+        }
+        pass("Pipelines on a shared pool keep per-pipeline order");
+    }
+    // Test 3: buildPipeline in pool mode: generator -> FilterBlock, one worker
+    {
+        const int pairs = 500;
+        Config config;
+        config.mode = InputMode::CSV;
+        config.csvFile = makeCsv("test_pool_filter.csv", pairs * 2);
+        config.columns = pairs * 2;
+        config.T_ns = 0;
+        config.queueCapacity = 8;
+        config.execution = ExecutionMode::POOL;
+        auto ctx = buildPipeline(config, nullptr);
+        if (ctx.execution != ExecutionMode::POOL) fail("context did not carry the execution mode");
+        if (ctx.batch != static_cast<size_t>(pairs)) fail("default batch should be one line of pairs");
+
+        WorkStealingPool pool(1);
+        if (!ctx.pipeline.start(&pool, ctx.batch)) fail("pooled buildPipeline failed to start");
+        waitForGenerators({ ctx.generator });
+        ctx.pipeline.stop();
+        pass("Generator and FilterBlock run as tasks on one worker");
+    }
+    // Test 4: an endless RANDOM source stops on request
+    {
+        Pipeline p;
+        auto* gen = new DataGenerator(nullptr, 64, 1000, InputMode::RANDOM);
+        auto* sink = new StepSink("RandomSink");
+        p.addBlock(std::unique_ptr<Block>(gen));
+        p.addBlock(std::unique_ptr<Block>(sink));
+        p.connect(gen, "out", sink, "in", 16);
+        WorkStealingPool pool(2);
+        if (!p.start(&pool, 16)) fail("random pipeline failed to start");
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        p.stop();
+        if (!sink->finished) fail("random sink not finished after stop");
+        if (sink->seqs.empty()) fail("random source produced nothing");
+        for (size_t i = 0; i < sink->seqs.size(); ++i)
+            if (sink->seqs[i] != i) fail("random pipeline out of order");
+        pass("RANDOM source stops on request");
+    }
+    // Test 5: timers run after their delay, earliest first, and a worker sleeps until them
+    {
+        WorkStealingPool pool(1);
+        std::atomic<int> order{0};
+        std::atomic<uint64_t> firedLate{0}, firedEarly{0};
+        std::atomic<int> lateAt{-1}, earlyAt{-1};
+        uint64_t t0 = util::now_ns();
+        pool.submitAfter(20000000, [&] { firedLate = util::now_ns(); lateAt = order++; });
+        pool.submitAfter(5000000, [&] { firedEarly = util::now_ns(); earlyAt = order++; });
+        // executed() counts a task once it has returned
+        for (int i = 0; i < 2000 && (lateAt.load() < 0 || earlyAt.load() < 0 || pool.executed() < 2); ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        if (lateAt.load() < 0 || earlyAt.load() < 0) fail("timers did not fire");
+        if (earlyAt != 0 || lateAt != 1) fail("timers fired out of order");
+        if (firedEarly - t0 < 5000000 || firedLate - t0 < 20000000) fail("timer fired before its delay");
+        if (pool.executed() != 2) fail("idle worker ran " + std::to_string(pool.executed()) + " tasks, expected 2");
+        pass("submitAfter fires in due order");
+    }
+    // Test 6: a paced pipeline parks between pairs instead of resubmitting its steps
+    {
+        const int pairs = 20;
+        Pipeline p;
+        auto* gen = new DataGenerator(nullptr, pairs * 2, 2000000, InputMode::CSV, makeCsv("test_pool_park.csv", pairs * 2));
+        auto* sink = new StepSink("ParkSink");
+        p.addBlock(std::unique_ptr<Block>(gen));
+        p.addBlock(std::unique_ptr<Block>(sink));
+        p.connect(gen, "out", sink, "in", 16);
+        WorkStealingPool pool(2);
+        if (!p.start(&pool, 16)) fail("paced pipeline failed to start");
+        waitForGenerators({ gen });
+        p.stop();
+        if (sink->seqs.size() != static_cast<size_t>(pairs)) fail("paced sink got " + std::to_string(sink->seqs.size()) + " pairs");
+        // ~40 ms of pacing; polling every step would run tens of thousands of tasks
+        if (pool.executed() > static_cast<uint64_t>(pairs) * 500)
+            fail("paced pipeline ran " + std::to_string(pool.executed()) + " steps");
+        pass("Idle steps park until woken or due");
+    }
+}
+
+int main() {
+    std::cout << "\nRunning WorkStealingPool unit tests...\n";
+    testWorkStealingPool();
+    std::cout << "All WorkStealingPool tests passed.\n";
+    return 0;
+}